@@ -38,6 +38,7 @@ using idealRandomWalk::IdealRandomWalks;
 using movetypes::add_tracker;
 using movetypes::MovetypeTracking;
 using movetypes::RegrowthMCMovetype;
+using origami::NeighbourTrials;
 using origami::OrigamiSystem;
 using parser::InputParameters;
 using randomGen::RandomGens;
@@ -73,10 +74,11 @@ class CBMCMovetype: virtual public RegrowthMCMovetype {
     void add_external_bias() override;
 
     /** Calculate the CB trial weights and rosenbluth-type weight */
-    virtual vector<double> calc_bias(
-            const vector<double> bfactors, // Boltzman weights
+    virtual void calc_bias(
+            const vector<double>& bfactors, // Boltzman weights
             const configsT& configs, // Configs
-            Domain* domain) = 0; // Domain being regrown
+            Domain* domain, // Domain being regrown
+            vector<double>& weights) = 0; // Trial weights
 
     /** Calculate the Boltzmann weights for all configurations
      *
@@ -95,12 +97,12 @@ class CBMCMovetype: virtual public RegrowthMCMovetype {
     /** Select and set a configuration for a domain using CB */
     void select_and_set_config(
             const int i, // Index in segment array of domain to regrow
-            vector<Domain*> domains); // Segment being regrown
+            const vector<Domain*>& domains); // Segment being regrown
 
     /** Select and set configuration from given configs and weights */
     void select_and_set_new_config(
-            const vector<double> weights, // Weights
-            const configsT configs, // Config
+            const vector<double>& weights, // Weights
+            const configsT& configs, // Config
             Domain& domain); // Domain being regrown
 
     /** Set configuration to old */
@@ -121,7 +123,7 @@ class CBMCMovetype: virtual public RegrowthMCMovetype {
     bool test_cb_acceptance();
 
     /** Unassign all given domains and store old configurations */
-    double unassign_domains(vector<Domain*>);
+    double unassign_domains(const vector<Domain*>&);
 
     /** Prepare interals for regrowing old configuration */
     void setup_for_regrow_old();
@@ -133,6 +135,13 @@ class CBMCMovetype: virtual public RegrowthMCMovetype {
     long double m_new_bias {1}; // Storage for new config's Rosenbluth
     double m_new_modifier {1}; // Storage for new config's modifier
     bool m_regrow_old {false}; // Regrowing old configuration
+    NeighbourTrials m_trials {}; // Trials of the current domain
+
+    // Trial configs and weights of the current domain, kept between moves
+    // so that their storage is reused
+    configsT m_configs {};
+    vector<double> m_bfactors {};
+    vector<double> m_weights {};
 };
 
 /** CB regrowth of staples */
@@ -159,19 +168,21 @@ class CBStapleRegrowthMCMovetype: public CBMCMovetype {
     virtual void add_tracker(bool accepted) override;
 
     /** Grow out domains from first in given array */
-    void grow_chain(vector<Domain*> domains) override;
+    void grow_chain(const vector<Domain*>& domains) override;
 
     /** Calculate the CB trial weights and rosenbluth-type weight */
-    vector<double> calc_bias(
-            const vector<double> bfactors, // Boltzman weights
+    void calc_bias(
+            const vector<double>& bfactors, // Boltzman weights
             const configsT& configs, // Configs
-            Domain* domain) override; // Domain being regrown
+            Domain* domain, // Domain being regrown
+            vector<double>& weights) override; // Trial weights
 
     /** Set given growthpoint and grow staple */
     void set_growthpoint_and_grow_staple(
             domainPairT growthpoint,
-            vector<Domain*> selected_chain);
+            const vector<Domain*>& selected_chain);
 
+    vector<domainPairT> m_bound_domains {}; // Old growthpoints
     StapleRegrowthTracking m_tracker {};
     unordered_map<StapleRegrowthTracking, MovetypeTracking> m_tracking {};
 };
@@ -201,16 +212,23 @@ class CTCBRegrowthMCMovetype:
   protected:
 
     /** Grow out domains from first in given array */
-    void grow_chain(vector<Domain*> domains) final override;
+    void grow_chain(const vector<Domain*>& domains) final override;
 
     /** Calculate the CB trial weights and rosenbluth-type weight */
-    vector<double> calc_bias(
-            const vector<double> bfactors, // Boltzman weights
+    void calc_bias(
+            const vector<double>& bfactors, // Boltzman weights
             const configsT& configs, // Configs
-            Domain* domain) override; // Domain being regrown
+            Domain* domain, // Domain being regrown
+            vector<double>& weights) override; // Trial weights
 
     /** Grow given staple and update fixed-end biases */
     void grow_staple_and_update_endpoints(Domain* growth_domain_old);
+
+    // Scratch storage reused between attempts
+    vector<Domain*> m_sel_scaf_doms {}; // Selected scaffold region
+    vector<Domain*> m_unassign_ds {}; // Scaffold domains to unassign
+    vector<int> m_regrow_staples {}; // Staples to regrow
+    vector<Domain*> m_stem_seg {}; // Second segment of a pair with its stem
 };
 
 /** CTCB regrowth of a contiguous scaffold segment and bound staples */
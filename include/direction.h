@@ -0,0 +1,134 @@
+// direction.h
+
+#ifndef DIRECTION_H
+#define DIRECTION_H
+
+#include <cstdlib>
+
+#include "utility.h"
+
+namespace direction {
+
+using utility::VectorThree;
+
+/**
+ * Compact code for the six lattice unit vectors
+ *
+ * Codes follow the order of utility::vectors, so the axis of a code is half
+ * its value and the opposite direction differs in the lowest bit. Anything
+ * that is not a unit vector is encoded as none, which compares unequal to
+ * every code, itself included, in the same() test used by the tables.
+ */
+enum Direction : unsigned char { xpos, xneg, ypos, yneg, zpos, zneg, none };
+
+const int c_num_codes {7};
+
+constexpr bool same(Direction d_1, Direction d_2) {
+    return d_1 == d_2 and d_1 != none;
+}
+
+/** Component i of the unit vector of a code */
+constexpr int component(Direction d, int i) {
+    if (d == none or d / 2 != i) {
+        return 0;
+    }
+    return d % 2 == 0 ? 1 : -1;
+}
+
+/** Code of a vector given by components */
+constexpr Direction from_components(int x, int y, int z) {
+    int comps[3] {x, y, z};
+    int abssum {0};
+    int code {0};
+    for (int i {0}; i != 3; i++) {
+        if (comps[i] != 0) {
+            abssum += comps[i] > 0 ? comps[i] : -comps[i];
+            code = 2 * i + (comps[i] < 0);
+        }
+    }
+    if (abssum != 1) {
+        return none;
+    }
+    return static_cast<Direction>(code);
+}
+
+/**
+ * Tables of rotated codes, indexed by direction and then rotation axis
+ *
+ * Rotations match VectorThree::rotate_half and VectorThree::rotate with one
+ * turn, including leaving the direction unchanged for an axis that is not a
+ * unit vector.
+ */
+struct RotationTables {
+    Direction negations[c_num_codes];
+    Direction half_turns[c_num_codes][c_num_codes];
+    Direction quarter_turns[c_num_codes][c_num_codes];
+};
+
+constexpr RotationTables make_rotation_tables() {
+    RotationTables tables {};
+    for (int d {0}; d != c_num_codes; d++) {
+        Direction dir {static_cast<Direction>(d)};
+        int x {component(dir, 0)};
+        int y {component(dir, 1)};
+        int z {component(dir, 2)};
+        tables.negations[d] = from_components(-x, -y, -z);
+        for (int a {0}; a != c_num_codes; a++) {
+            Direction axis {static_cast<Direction>(a)};
+            Direction half {dir};
+            Direction quarter {dir};
+            if (dir != none and axis != none) {
+
+                // Positive and negative axes turn in opposite senses
+                int sense {axis % 2 == 0 ? 1 : -1};
+                switch (axis / 2) {
+                case 0:
+                    half = from_components(x, -y, -z);
+                    quarter = from_components(x, -sense * z, sense * y);
+                    break;
+                case 1:
+                    half = from_components(-x, y, -z);
+                    quarter = from_components(-sense * z, y, sense * x);
+                    break;
+                case 2:
+                    half = from_components(-x, -y, z);
+                    quarter = from_components(-sense * y, sense * x, z);
+                    break;
+                }
+            }
+            tables.half_turns[d][a] = half;
+            tables.quarter_turns[d][a] = quarter;
+        }
+    }
+
+    return tables;
+}
+
+constexpr RotationTables c_rotations {make_rotation_tables()};
+
+inline Direction encode(const VectorThree& v) {
+    int abssum {std::abs(v[0]) + std::abs(v[1]) + std::abs(v[2])};
+    if (abssum != 1) {
+        return none;
+    }
+    int axis {(v[1] != 0) + 2 * (v[2] != 0)};
+    return static_cast<Direction>(2 * axis + (v[0] + v[1] + v[2] < 0));
+}
+
+/** Unit vector of a code other than none */
+inline const VectorThree& decode(Direction d) { return utility::vectors[d]; }
+
+constexpr Direction negate(Direction d) { return c_rotations.negations[d]; }
+
+constexpr Direction rotate_half(Direction d, Direction axis) {
+    return c_rotations.half_turns[d][axis];
+}
+
+/** Rotate by one quarter turn, as VectorThree::rotate(axis, 1) */
+constexpr Direction rotate_quarter(Direction d, Direction axis) {
+    return c_rotations.quarter_turns[d][axis];
+}
+
+} // namespace direction
+
+#endif // DIRECTION_H
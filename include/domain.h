@@ -3,61 +3,125 @@
 #ifndef DOMAIN_H
 #define DOMAIN_H
 
+#include <array>
+
+#include "direction.h"
 #include "utility.h"
 
 namespace domainContainer {
 
+using direction::c_num_codes;
+using direction::Direction;
+using direction::encode;
+using direction::negate;
+using direction::rotate_half;
+using direction::rotate_quarter;
+using direction::same;
 using utility::Occupancy;
 using utility::VectorThree;
 
+class Domain;
+
+// Domains are allocated in slabs of this size, with the id of a domain being
+// its slab's index times the slab size plus its index in the slab
+constexpr int c_slab_bits {10};
+constexpr int c_slab_size {1 << c_slab_bits};
+constexpr int c_slab_mask {c_slab_size - 1};
+
+// State of a slab of domains as a structure of arrays
+struct DomainStates {
+    std::array<VectorThree, c_slab_size> positions;
+    std::array<VectorThree, c_slab_size> orientations;
+    std::array<Occupancy, c_slab_size> states;
+    std::array<Domain*, c_slab_size> bound_domains;
+};
+
 // DNA origami binding domain
 class Domain {
   public:
     // Standard methods
-    Domain(int c, int c_ident, int d, int d_ident, int c_length):
+    Domain(int c,
+           int c_ident,
+           int d,
+           int d_ident,
+           int c_length,
+           int id,
+           DomainStates* states):
             m_c {c},
             m_c_ident {c_ident},
             m_d {d},
             m_d_ident {d_ident},
-            m_c_length {c_length} {};
+            m_c_length {c_length},
+            m_id {id},
+            m_states {states} {};
     virtual ~Domain() = default;
 
+    // Unique index of the associated chain (reassigned if chain is reused)
+    int m_c;
+
     // Immutable attributes
-    const int m_c; // Unique index of the associated chain
     const int m_c_ident; // Identity of the chain the associated chain
     const int m_d; // Domain index
     const int m_d_ident; // Domain identity
     const int m_c_length; // Associated chain length
+    const int m_id; // Global index into the state store
     Domain* m_forward_domain {nullptr}; // Domain in ?' direction
     Domain* m_backward_domain {nullptr}; // Domain in ?' direction
 
-    // State attributes
-    VectorThree m_pos {}; // Position vector
-    VectorThree m_ore {}; // Orientation vector
-    Occupancy m_state {Occupancy::unassigned}; // Binding state
-    Domain* m_bound_domain {nullptr}; // Pointer to bound domain
+    // State attributes, read from the DomainPool state arrays by id
+    VectorThree& pos() { return m_states->positions[m_id & c_slab_mask]; }
+    VectorThree& ore() { return m_states->orientations[m_id & c_slab_mask]; }
+    Occupancy& state() { return m_states->states[m_id & c_slab_mask]; }
+    Domain*& bound_domain() {
+        return m_states->bound_domains[m_id & c_slab_mask];
+    }
+    const VectorThree& pos() const {
+        return m_states->positions[m_id & c_slab_mask];
+    }
+    const VectorThree& ore() const {
+        return m_states->orientations[m_id & c_slab_mask];
+    }
+    Occupancy state() const { return m_states->states[m_id & c_slab_mask]; }
+    Domain* bound_domain() const {
+        return m_states->bound_domains[m_id & c_slab_mask];
+    }
 
     // Get next domain in chain
     Domain* operator+(int increment);
 
-    // Constraint checkers
-    virtual bool check_twist_constraint(VectorThree ndr, Domain& cd_j) = 0;
-    virtual bool check_kink_constraint(VectorThree ndr, Domain& cd_j) = 0;
+    // Constraint checkers, taking the encoded next domain vector
+    virtual bool check_twist_constraint(Direction ndr, Domain& cd_j) = 0;
+    virtual bool check_kink_constraint(Direction ndr, Domain& cd_j) = 0;
     virtual bool check_junction_constraint(
             Domain& cd_j2,
             Domain& cd_j3,
             Domain& cd_j4,
             Domain& cd_k1,
             Domain& cd_k2) = 0;
+
+  private:
+    DomainStates* m_states; // States of this domain's slab
 };
 
-class HalfTurnDomain: public Domain {
+// Domain models are final so that code templated on them calls the
+// constraint checkers directly, and can inline them from this header
+class HalfTurnDomain final: public Domain {
     using Domain::Domain;
 
   public:
     // Constraint checkers
-    bool check_twist_constraint(VectorThree ndr, Domain& cd_j);
-    bool check_kink_constraint(VectorThree ndr, Domain& cd_j);
+    bool check_twist_constraint(Direction ndr, Domain& cd_j);
+    bool check_kink_constraint(Direction ndr, Domain& cd_j);
+
+    // Constraint checkers on given orientations, for trial configurations
+    // that are not set on the domains
+    static bool twist_obeyed(Direction ndr, Direction ore_1, Direction ore_2);
+    static bool kink_obeyed(Direction ndr, Direction ore_1, Direction ore_2);
+    static bool junction_obeyed(
+            Direction ndr_k1,
+            Direction ore_k1,
+            Direction ndr_1,
+            Direction ore_k2);
 
     /** Check four body junction stacking rules
      *
@@ -75,13 +139,22 @@ class HalfTurnDomain: public Domain {
             Domain& cd_k2);
 };
 
-class ThreeQuarterTurnDomain: public Domain {
+class ThreeQuarterTurnDomain final: public Domain {
     using Domain::Domain;
 
   public:
     // Constraint checkers
-    bool check_twist_constraint(VectorThree ndr, Domain& cd_j);
-    bool check_kink_constraint(VectorThree ndr, Domain& cd_j);
+    bool check_twist_constraint(Direction ndr, Domain& cd_j);
+    bool check_kink_constraint(Direction ndr, Domain& cd_j);
+    static bool twist_obeyed(Direction ndr, Direction ore_1, Direction ore_2);
+    static bool kink_obeyed(Direction ndr, Direction ore_1, Direction ore_2);
+
+    // The next domain vector of the first junction pair is in chain order
+    static bool junction_obeyed(
+            Direction ndr_k1,
+            Direction ore_k1,
+            Direction ndr_1,
+            Direction ore_k2);
     bool check_junction_constraint(
             Domain& cd_j2,
             Domain& cd_j3,
@@ -89,6 +162,152 @@ class ThreeQuarterTurnDomain: public Domain {
             Domain& cd_k1,
             Domain& cd_k2);
 };
+
+// Kink legality indexed by next domain vector and the two orientations
+struct KinkTable {
+    bool legal[c_num_codes][c_num_codes][c_num_codes];
+};
+
+constexpr KinkTable make_kink_table(bool half_turn) {
+    KinkTable table {};
+    for (int n {0}; n != c_num_codes; n++) {
+        for (int o_1 {0}; o_1 != c_num_codes; o_1++) {
+            for (int o_2 {0}; o_2 != c_num_codes; o_2++) {
+                Direction ndr {static_cast<Direction>(n)};
+                Direction ore_1 {static_cast<Direction>(o_1)};
+                Direction ore_2 {static_cast<Direction>(o_2)};
+                bool legal {true};
+                if (same(ndr, negate(ore_1))) {
+                    legal = false;
+                }
+                else if (same(ndr, ore_1)) {
+                    if (half_turn) {
+                        legal = not same(ore_2, negate(ore_1));
+                    }
+                    else {
+                        legal = not(same(ore_1, ore_2) or
+                                    same(ore_1, negate(ore_2)));
+                    }
+                }
+                else if (same(ndr, ore_2) or same(ndr, negate(ore_2))) {
+                    legal = false;
+                }
+                table.legal[n][o_1][o_2] = legal;
+            }
+        }
+    }
+
+    return table;
+}
+
+constexpr KinkTable c_half_turn_kinks {make_kink_table(true)};
+constexpr KinkTable c_three_quarter_turn_kinks {make_kink_table(false)};
+
+inline bool HalfTurnDomain::twist_obeyed(
+        Direction ndr,
+        Direction ore_1,
+        Direction ore_2) {
+    return same(rotate_half(ore_1, ndr), ore_2);
+}
+
+inline bool HalfTurnDomain::kink_obeyed(
+        Direction ndr,
+        Direction ore_1,
+        Direction ore_2) {
+    return c_half_turn_kinks.legal[ndr][ore_1][ore_2];
+}
+
+inline bool HalfTurnDomain::junction_obeyed(
+        Direction,
+        Direction,
+        Direction,
+        Direction) {
+    return true;
+}
+
+inline bool HalfTurnDomain::check_twist_constraint(
+        Direction ndr,
+        Domain& cd_2) {
+    return twist_obeyed(ndr, encode(ore()), encode(cd_2.ore()));
+}
+
+inline bool HalfTurnDomain::check_kink_constraint(
+        Direction ndr,
+        Domain& cd_2) {
+    return kink_obeyed(ndr, encode(ore()), encode(cd_2.ore()));
+}
+
+inline bool HalfTurnDomain::check_junction_constraint(
+        Domain& cd_j2,
+        Domain& cd_j3,
+        Domain& cd_j4,
+        Domain& cd_k1,
+        Domain& cd_k2) {
+
+    return true;
+}
+
+inline bool ThreeQuarterTurnDomain::twist_obeyed(
+        Direction ndr,
+        Direction ore_1,
+        Direction ore_2) {
+
+    // A quarter turn about the reversed axis is VectorThree::rotate(ndr, -1)
+    return same(rotate_quarter(ore_1, negate(ndr)), ore_2);
+}
+
+inline bool ThreeQuarterTurnDomain::kink_obeyed(
+        Direction ndr,
+        Direction ore_1,
+        Direction ore_2) {
+    return c_three_quarter_turn_kinks.legal[ndr][ore_1][ore_2];
+}
+
+inline bool ThreeQuarterTurnDomain::junction_obeyed(
+        Direction ndr_k1,
+        Direction ore_k1,
+        Direction ndr_1,
+        Direction ore_k2) {
+
+    bool kink_constraint_obeyed {true};
+    if (same(ndr_k1, ore_k1)) {
+        if (not twist_obeyed(ndr_1, ore_k1, ore_k2)) {
+            kink_constraint_obeyed = false;
+        }
+    }
+    return kink_constraint_obeyed;
+}
+
+inline bool ThreeQuarterTurnDomain::check_twist_constraint(
+        Direction ndr,
+        Domain& cd_2) {
+    return twist_obeyed(ndr, encode(ore()), encode(cd_2.ore()));
+}
+
+inline bool ThreeQuarterTurnDomain::check_kink_constraint(
+        Direction ndr,
+        Domain& cd_2) {
+    return kink_obeyed(ndr, encode(ore()), encode(cd_2.ore()));
+}
+
+inline bool ThreeQuarterTurnDomain::check_junction_constraint(
+        Domain& cd_j2,
+        Domain& cd_j3,
+        Domain& cd_j4,
+        Domain& cd_k1,
+        Domain& cd_k2) {
+
+    Direction ndr_1 {encode(cd_j2.pos() - this->pos())};
+    if (this->m_d > cd_j2.m_d) {
+        ndr_1 = negate(ndr_1);
+    }
+    return junction_obeyed(
+            encode(cd_k2.pos() - cd_k1.pos()),
+            encode(cd_k1.ore()),
+            ndr_1,
+            encode(cd_k2.ore()));
+}
+
 } // namespace domainContainer
 
 #endif // DOMAIN_H
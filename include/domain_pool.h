@@ -0,0 +1,74 @@
+// domain_pool.h
+
+#ifndef DOMAIN_POOL_H
+#define DOMAIN_POOL_H
+
+#include <array>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "domain.h"
+
+namespace domainContainer {
+
+using std::array;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * Owner of all domains of a system and a store of reusable chains
+ *
+ * Domains are constructed in place in fixed size slabs, so they never move
+ * once created. Each slab also holds the state of its domains as a structure
+ * of arrays indexed by the domain id, which Domain objects read by id, so
+ * passes over the whole system can stream through contiguous arrays. Deleted
+ * chains are kept, fully linked, in a free list for their identity and
+ * handed out again the next time a chain of that identity is added, so that
+ * staple exchange does not allocate once the pool has grown to the largest
+ * number of staples seen.
+ */
+class DomainPool {
+  public:
+    using Slot = std::aligned_union<0, HalfTurnDomain, ThreeQuarterTurnDomain>::
+            type;
+
+    // Domains and their states for a contiguous range of domain ids
+    struct Slab: DomainStates {
+        int size {0};
+        array<Domain*, c_slab_size> domains;
+        array<Slot, c_slab_size> slots;
+    };
+
+    DomainPool(string domain_type, const vector<vector<int>>& identities);
+    ~DomainPool();
+    DomainPool(DomainPool&&) = default;
+
+    /** Get an unassigned chain of the given identity with index c_i */
+    vector<Domain*> checkout_chain(int c_i, int c_i_ident);
+
+    /** Return a chain whose domains have all been unassigned */
+    void return_chain(vector<Domain*>& chain);
+
+    /** Slabs in domain id order; domains in free chains are unassigned */
+    const vector<unique_ptr<Slab>>& slabs() const;
+
+  private:
+    Domain* construct_domain(
+            int c_i,
+            int c_i_ident,
+            int d_i,
+            int d_i_ident,
+            int chain_length);
+
+    string m_domain_type;
+    vector<vector<int>> m_identities;
+    vector<unique_ptr<Slab>> m_slabs {};
+    vector<vector<vector<Domain*>>> m_free_chains {}; // By chain identity
+};
+
+} // namespace domainContainer
+
+#endif // DOMAIN_POOL_H
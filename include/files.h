@@ -30,6 +30,7 @@ using orderParams::OrderParam;
 using orderParams::SystemOrderParams;
 using origami::Chain;
 using origami::OrigamiSystem;
+using origami::StapleStats;
 using randomGen::RandomGens;
 
 // Input file for OrigamiSystem configuration and topology
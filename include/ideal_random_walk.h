@@ -3,9 +3,12 @@
 #ifndef IDEAL_RANDOM_WALK_H
 #define IDEAL_RANDOM_WALK_H
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
@@ -19,13 +22,66 @@
 namespace idealRandomWalk {
 
 using std::pair;
+using std::shared_ptr;
 using std::string;
 using std::unordered_map;
+using std::vector;
 
 using utility::VectorThree;
 
+// Number of walks by sorted absolute displacement and number of steps
+typedef unordered_map<pair<VectorThree, int>, long double> walksMapT;
+
+/** Slot of a walks table, laid out the same in memory and on disk */
+struct WalksTableEntry {
+    int32_t DR[3];
+    int32_t steps; // Negative if the slot is empty
+    long double walks;
+};
+
+/**
+ * Read-only open addressed table of the walk counts of an archive
+ *
+ * The table is written next to the archive and mapped, so all processes of
+ * a node read the one copy in the page cache. It is built by the first
+ * process to need it while the others wait, and rebuilt if the archive
+ * changes. If it cannot be written the table is kept in memory instead.
+ */
+class WalksTable {
+  public:
+    WalksTable(const string& archive_filename);
+    WalksTable(const WalksTable&) = delete;
+    WalksTable& operator=(const WalksTable&) = delete;
+
+    bool find(const pair<VectorThree, int>& walk_key, long double& walks)
+            const;
+
+  private:
+    bool map_table(const string& filename);
+    bool write_table(const string& filename) const;
+    void build(const walksMapT& num_walks);
+
+    // Archive the table was built from, to tell if the file is stale
+    uint64_t m_archive_size {0};
+    int64_t m_archive_mtime {0};
+
+    vector<WalksTableEntry> m_entries {}; // Only if not mapped
+    shared_ptr<const char> m_mapping {};
+    const WalksTableEntry* m_slots {nullptr};
+    uint64_t m_num_slots {0};
+};
+
 class IdealRandomWalks {
   public:
+    /**
+     * Use a precalculated archive of walk counts
+     *
+     * Each archive is loaded once per process as a table shared read-only
+     * by every instance that loads it (and by the other processes of the
+     * node); counts missing from it are calculated and kept by the instance.
+     */
+    void load_shared(const string& filename);
+
     long double num_walks(
             VectorThree start_pos,
             VectorThree end_pos,
@@ -34,7 +90,9 @@ class IdealRandomWalks {
     void delete_entry(VectorThree start_pos, VectorThree end_pos, int steps);
 
   private:
-    unordered_map<pair<VectorThree, int>, long double> m_num_walks {};
+    shared_ptr<const WalksTable> m_shared_num_walks {};
+    walksMapT m_num_walks {};
+    friend class WalksTable;
     friend class boost::serialization::access;
     template <typename Archive>
     void serialize(Archive& arch, const unsigned int) {
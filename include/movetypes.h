@@ -43,10 +43,31 @@ using origami::OrigamiSystem;
 using parser::InputParameters;
 using randomGen::RandomGens;
 using topConstraintPoints::Constraintpoints;
+using topConstraintPoints::DomainMap;
 using utility::VectorThree;
 
 typedef pair<Domain*, Domain*> domainPairT;
 
+/**
+ * Saved configurations of domains, indexed by domain id
+ *
+ * Storage grows to the largest id seen and is kept between moves, so saving
+ * and copying configs does not allocate once the system has been explored.
+ */
+class DomainConfigs {
+  public:
+    void save(const Domain& domain) {
+        set(domain, domain.pos(), domain.ore());
+    }
+    void set(const Domain& domain, VectorThree pos, VectorThree ore);
+    VectorThree pos(const Domain& domain) const;
+    VectorThree ore(const Domain& domain) const;
+
+  private:
+    vector<VectorThree> m_pos {};
+    vector<VectorThree> m_ore {};
+};
+
 /** Tracker for general movetype info */
 struct MovetypeTracking {
     int attempts;
@@ -98,6 +119,9 @@ class MCMovetype {
     // Methods that probably need to be overriden
     virtual void reset_internal();
 
+    /** Unassign and delete what was added and set previous configs */
+    void replay_prev_configs();
+
     // Shared general utility functions
 
     /** Return a random domain in the system
@@ -128,10 +152,10 @@ class MCMovetype {
      * removed would leave the system in a state with staples
      * unconnected to the scaffold
      */
-    bool staple_is_connector(vector<Domain*> staple);
+    bool staple_is_connector(const vector<Domain*>& staple);
 
     /** Find all staples in bound network to given domains */
-    set<int> find_staples(vector<Domain*> domains);
+    set<int> find_staples(const vector<Domain*>& domains);
 
     /** Write the config to move file
      *
@@ -160,9 +184,8 @@ class MCMovetype {
     vector<pair<int, int>> m_assigned_domains {};
     vector<int> m_added_chains {};
 
-    // Domains mapped to previous configs
-    unordered_map<pair<int, int>, VectorThree> m_prev_pos {};
-    unordered_map<pair<int, int>, VectorThree> m_prev_ore {};
+    // Previous configs of modified domains
+    DomainConfigs m_prev_configs {};
 
     // Modifier to correct for excluded volume and overcounting
     double m_modifier {1};
@@ -176,7 +199,9 @@ class MCMovetype {
             set<int>& participating_chains);
 
     /** Find all domains bound directly to give domains */
-    vector<domainPairT> find_bound_domains(vector<Domain*> selected_chain);
+    void find_bound_domains(
+            const vector<Domain*>& selected_chain,
+            vector<domainPairT>& bound_domains);
 };
 
 /** For debugging purposes */
@@ -213,10 +238,8 @@ class RegrowthMCMovetype: virtual public MCMovetype {
     RegrowthMCMovetype& operator=(const RegrowthMCMovetype&) = delete;
 
   protected:
-    void reset_internal() override;
-
     /** Grow given contiguous domains from a chain */
-    virtual void grow_chain(vector<Domain*> domains) = 0;
+    virtual void grow_chain(const vector<Domain*>& domains) = 0;
 
     /** Set domain to have complementary orientation to given */
     double set_growth_point(
@@ -228,20 +251,25 @@ class RegrowthMCMovetype: virtual public MCMovetype {
      * The indices passed to grow chain should include the growth
      * point.
      */
-    void grow_staple(int d_i_index, vector<Domain*> selected_chain);
+    void grow_staple(int d_i_index, const vector<Domain*>& selected_chain);
 
     pair<Domain*, Domain*> select_new_growthpoint(
-            vector<Domain*> selected_chain);
+            const vector<Domain*>& selected_chain);
 
     /** Select a growthpoint from set of possible */
-    domainPairT select_old_growthpoint(vector<domainPairT> bound_domains);
+    domainPairT select_old_growthpoint(
+            const vector<domainPairT>& bound_domains);
 
     /** Number of staple domains (mis)bound to external chains **/
-    int num_bound_staple_domains(vector<Domain*> staple);
+    int num_bound_staple_domains(const vector<Domain*>& staple);
+
+    // Halves of the staples being grown, one per level of nested staple
+    // growth; a deque so that growing deeper does not move shallower halves
+    deque<vector<Domain*>> m_staple_halves {};
+    size_t m_staple_depth {0};
 
     // Store old positions and orientations
-    unordered_map<pair<int, int>, VectorThree> m_old_pos {};
-    unordered_map<pair<int, int>, VectorThree> m_old_ore {};
+    DomainConfigs m_old_configs {};
 };
 
 /** Parent class of moves with constant topology regrowth */
@@ -268,9 +296,10 @@ class CTRegrowthMCMovetype: virtual public RegrowthMCMovetype {
 
     void sel_excluded_staples();
 
-    /** Select scaffold segment to be regrown */
-    vector<Domain*> select_indices(
-            vector<Domain*> d,
+    /** Select scaffold segment to be regrown into the given domains */
+    void select_indices(
+            const vector<Domain*>& d,
+            vector<Domain*>& domains,
             unsigned int min_length,
             int seg = 0);
 
@@ -289,13 +318,13 @@ class CTRegrowthMCMovetype: virtual public RegrowthMCMovetype {
      * segment requires a maximum segment length to be selected. If
      * this is non-zero, the first domain is added to the segment. The
      * order of regrowth direction is selected randomly.
+     *
+     * The segments are left in m_segs with their directions in
+     * m_seg_dirs. After the first, segments come in pairs grown out
+     * from each of m_seg_stems, the first of a pair starting with its
+     * stem.
      */
-    void select_noncontig_segs(
-            vector<Domain*>& given_seg,
-            vector<vector<Domain*>>& segs,
-            vector<vector<vector<Domain*>>>& paired_segs,
-            vector<Domain*>& seg_stems,
-            vector<int>& dirs);
+    void select_noncontig_segs(const vector<Domain*>& given_seg);
 
     /** Check if excluded staples are still bound to system */
     bool excluded_staples_bound();
@@ -311,18 +340,33 @@ class CTRegrowthMCMovetype: virtual public RegrowthMCMovetype {
     // Maximum number of scaffold domains to regrow
     unsigned int m_max_regrowth;
 
+    // Noncontiguous segments selected for regrowth. Only the first
+    // m_seg_dirs.size() segments are in use; the rest keep their storage
+    // for later moves
+    vector<vector<Domain*>> m_segs {};
+    vector<int> m_seg_dirs {};
+    vector<Domain*> m_seg_stems {};
+
   private:
     bool fill_seg(
             Domain* start_d,
             size_t max_length,
             size_t seg_max_length,
             int dir,
-            set<Domain*>& domains,
-            deque<Domain*>& possible_stems,
             vector<Domain*>& seg);
     unsigned int m_max_seg_regrowth;
 
-    void check_for_stemds(Domain* cur_d, deque<Domain*>& possible_stems);
+    /** Start a new segment with the given direction and return its index */
+    size_t add_seg(int dir);
+    void select_seg_domain(Domain* d);
+    void check_for_stemds(Domain* cur_d);
+
+    // Domains selected so far, mapped to the order they were selected in,
+    // and stem domains found along the segments, taken from m_next_stem on
+    DomainMap<size_t> m_seg_domains {};
+    size_t m_num_seg_domains {0};
+    vector<Domain*> m_possible_stems {};
+    size_t m_next_stem {0};
 };
 
 /* Template function for updating movetype specific trackers */
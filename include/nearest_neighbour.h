@@ -110,6 +110,9 @@ ThermoOfHybrid calc_unitless_hybridization_thermo(
         double temp,
         double cation_M);
 
+/** Convert H and S in kcal/mol to reduced units at the given temperature */
+ThermoOfHybrid calc_unitless_thermo(ThermoOfHybrid DH_DS, double temp);
+
 double calc_unitless_hybridization_energy(
         string seq,
         double temp,
@@ -118,6 +121,14 @@ double calc_unitless_hybridization_energy(
 ThermoOfHybrid calc_unitless_init_thermo(double temp);
 
 ThermoOfHybrid calc_hybridization_H_and_S(string seq, double cation_M);
+
+/**
+ * Longest contiguous complementary subsequences of a pair of sequences
+ *
+ * Subsequences are given as they are in the shorter sequence, once for each
+ * pairing with the other. Common prefix lengths of all suffix pairs are
+ * tabulated, so the cost is the product of the sequence lengths.
+ */
 vector<string> find_longest_contig_complement(string seq_i, string seq_j);
 string calc_comp_seq(string seq);
 bool seq_is_palindromic(string seq);
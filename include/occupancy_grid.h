@@ -0,0 +1,85 @@
+// occupancy_grid.h
+
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "domain.h"
+#include "utility.h"
+
+namespace occupancyGrid {
+
+using std::array;
+using std::pair;
+using std::unique_ptr;
+using std::vector;
+
+using domainContainer::Domain;
+using utility::Occupancy;
+using utility::VectorThree;
+
+/**
+ * Occupancy state and unbound domain of each lattice site
+ *
+ * Sites are stored in dense cubic blocks that are only allocated once a site
+ * in them is first assigned. Blocks are found through a flat directory over
+ * the bounding box of allocated blocks, which is grown as needed, so a lookup
+ * is a few shifts and two indirections rather than a hash probe.
+ */
+class OccupancyGrid {
+  public:
+    Occupancy occupancy(const VectorThree& pos) const;
+
+    /** Unbound domain at the given site, or nullptr if there is none */
+    Domain* unbound_domain(const VectorThree& pos) const;
+
+    /** Occupancy and unbound domain of a site from a single lookup */
+    void read_site(
+            const VectorThree& pos,
+            Occupancy& occupancy,
+            Domain*& unbound_domain) const;
+
+    void set_unbound(const VectorThree& pos, Domain* domain);
+    void set_bound(const VectorThree& pos, Occupancy state);
+    void unassign(const VectorThree& pos);
+
+    /** Move every assigned site by the given displacement */
+    void translate(const VectorThree& disp);
+    void clear();
+
+  private:
+    // Kept together so that a lookup only touches one cache line
+    struct Site {
+        Domain* unbound_domain {nullptr};
+        Occupancy occupancy {Occupancy::unassigned};
+    };
+
+    static constexpr int c_block_bits {3};
+    static constexpr int c_block_len {1 << c_block_bits};
+    static constexpr int c_block_mask {c_block_len - 1};
+    static constexpr int c_block_sites {
+            c_block_len * c_block_len * c_block_len};
+    using Block = array<Site, c_block_sites>;
+
+    static array<int, 3> block_coords(const VectorThree& pos);
+    static int site_index(const VectorThree& pos);
+    Site* find_site(const VectorThree& pos) const;
+    Site& get_site(const VectorThree& pos);
+    int block_index(const array<int, 3>& block_pos) const;
+    void grow_directory(const array<int, 3>& block_pos);
+
+    array<int, 3> m_origin {{0, 0, 0}}; // Lowest block coordinates
+    array<int, 3> m_dims {{0, 0, 0}}; // Directory extent in blocks
+    vector<unique_ptr<Block>> m_blocks {};
+
+    // Sites being moved by translate
+    vector<pair<VectorThree, Site>> m_moved_sites {};
+};
+
+} // namespace occupancyGrid
+
+#endif // OCCUPANCY_GRID_H
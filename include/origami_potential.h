@@ -3,6 +3,9 @@
 #ifndef ORIGAMI_POTENTIAL_H
 #define ORIGAMI_POTENTIAL_H
 
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
 #include <vector>
 
 #include "domain.h"
@@ -21,17 +24,77 @@ using std::vector;
 using domainContainer::Domain;
 using nearestNeighbour::ThermoOfHybrid;
 using parser::InputParameters;
+using utility::Occupancy;
 using utility::VectorThree;
 
-bool check_domain_orientations_opposing(Domain& cd_i, Domain& cd_j);
-bool check_domains_exist_and_bound(vector<Domain*> cdv);
-bool doubly_contiguous(Domain* cd_1, Domain* cd_2);
+/**
+ * Domain states as read by the potential
+ *
+ * Either the current states of the domains, or those with one domain as if
+ * bound to another at a trial position and orientation, so that a binding
+ * can be evaluated without changing either domain.
+ */
+class TrialStates {
+  public:
+    TrialStates() = default;
+    TrialStates(
+            Domain& cd_i,
+            const VectorThree& pos,
+            const VectorThree& ore,
+            Domain& cd_j,
+            Occupancy state):
+            m_cd_i {&cd_i},
+            m_cd_j {&cd_j},
+            m_pos {pos},
+            m_ore {ore},
+            m_state {state} {}
+
+    const VectorThree& pos(const Domain* cd) const {
+        return cd == m_cd_i ? m_pos : cd->pos();
+    }
+    const VectorThree& ore(const Domain* cd) const {
+        return cd == m_cd_i ? m_ore : cd->ore();
+    }
+    Occupancy state(const Domain* cd) const {
+        return (cd == m_cd_i or cd == m_cd_j) ? m_state : cd->state();
+    }
+    Domain* bound_domain(const Domain* cd) const {
+        if (cd == m_cd_i) {
+            return m_cd_j;
+        }
+        if (cd == m_cd_j) {
+            return m_cd_i;
+        }
+        return cd->bound_domain();
+    }
+
+  private:
+    Domain* m_cd_i {nullptr};
+    Domain* m_cd_j {nullptr};
+    VectorThree m_pos {};
+    VectorThree m_ore {};
+    Occupancy m_state {Occupancy::bound};
+};
 
-// Domain order will be checked
-bool check_pair_stacked(Domain* cd_1, Domain* cd_2);
+bool check_domain_orientations_opposing(
+        const TrialStates& states,
+        Domain& cd_i,
+        Domain& cd_j);
+bool check_domains_exist_and_bound(
+        const TrialStates& states,
+        std::initializer_list<Domain*> cdv);
+bool doubly_contiguous(const TrialStates& states, Domain* cd_1, Domain* cd_2);
+
+// Domain order will be checked; DomainT is the domain model of the system
+template <typename DomainT>
+bool check_pair_stacked(
+        const TrialStates& states,
+        Domain* cd_1,
+        Domain* cd_2);
 
 // Domain order of j1 to j4 will be checked, but not k1 and k2
 int check_junction_stacking_penalty(
+        const TrialStates& states,
         Domain& cd_j1,
         Domain& cd_j2,
         Domain& cd_j3,
@@ -46,6 +109,67 @@ struct DeltaConfig {
     int stacked_juncts {0};
 };
 
+// Reduced energies of a pair of domain identities, kept together so that
+// one lookup serves both the hybridization and the stacking terms
+struct PairEnergies {
+    double hyb_energy {0};
+    double hyb_enthalpy {0};
+    double hyb_entropy {0};
+    double stacking_energy {0};
+};
+
+/**
+ * Energies of all pairs of domain identities in one contiguous array
+ *
+ * Identities form a small signed range, so entries are indexed directly by
+ * the identities offset by the minimum one. The entries are either owned or
+ * read in place from a mapped cache file shared by all processes of a node.
+ */
+class PairEnergyTable {
+  public:
+    PairEnergyTable() = default;
+    PairEnergyTable(const vector<vector<int>>& identities);
+    PairEnergyTable(PairEnergyTable&&) = default;
+    PairEnergyTable& operator=(PairEnergyTable&&) = default;
+
+    /**
+     * Read entries in place from a read-only mapping
+     *
+     * The owned entries are freed, so the table must not be written after.
+     */
+    void use_mapped_entries(
+            const PairEnergies* entries,
+            std::shared_ptr<const char> mapping);
+
+    // Raw entries, for reading and writing whole tables
+    PairEnergies* data() { return m_data; }
+    size_t size() const { return m_width * m_width; }
+
+    PairEnergies& operator()(int d_i_ident, int d_j_ident) {
+        return m_data[(d_i_ident - m_min_ident) * m_width + d_j_ident -
+                      m_min_ident];
+    }
+    const PairEnergies& operator()(int d_i_ident, int d_j_ident) const {
+        return m_data[(d_i_ident - m_min_ident) * m_width + d_j_ident -
+                      m_min_ident];
+    }
+
+  private:
+    int m_min_ident {0};
+    int m_width {0};
+    vector<PairEnergies> m_entries {};
+    PairEnergies* m_data {nullptr}; // Owned or mapped entries
+    std::shared_ptr<const char> m_mapping {};
+};
+
+/** Energy tables at one temperature and stacking multiplier */
+struct EnergyTables {
+    PairEnergyTable pairs {};
+    double init_enthalpy {0};
+    double init_entropy {0};
+    double init_energy {0};
+};
+
 class OrigamiPotential;
 
 /** Potential for fully complementary binding domains
@@ -59,16 +183,23 @@ class BindingPotential {
     virtual ~BindingPotential() {}
 
     /** Calculate full potential energy change */
-    DeltaConfig bind_domains(Domain& cd_i, Domain& cd_j);
+    DeltaConfig bind_domains(
+            const TrialStates& states,
+            Domain& cd_i,
+            Domain& cd_j);
 
     /** Calculate stacking term energy change only */
-    DeltaConfig check_stacking(Domain& cd_i, Domain& cd_j);
+    DeltaConfig check_stacking(
+            const TrialStates& states,
+            Domain& cd_i,
+            Domain& cd_j);
 
     bool m_constraints_violated;
 
   protected:
     OrigamiPotential& m_pot;
     DeltaConfig m_delta_config;
+    const TrialStates* m_states {nullptr}; // Of the evaluation in progress
 
     /** Change in stacking and steric energy when changing one domain */
     virtual void calc_stacking_and_steric_terms(Domain& cd_i, Domain& cd_j) = 0;
@@ -96,7 +227,13 @@ class BindingPotential {
     void check_triply_contig_helix(Domain* cd_h1, Domain* cd_h2, Domain* cd_h3);
 };
 
-/** Potential as defined in PhD thesis of Alexander Cumberworth */
+/** Potential as defined in PhD thesis of Alexander Cumberworth
+ *
+ * Specialized on the domain model, which all domains of a system share, so
+ * that the twist, kink and junction checks are direct, inlinable calls.
+ * Instantiated for HalfTurnDomain and ThreeQuarterTurnDomain.
+ */
+template <typename DomainT>
 class JunctionBindingPotential: public BindingPotential {
   public:
     using BindingPotential::BindingPotential;
@@ -208,7 +345,10 @@ class MisbindingPotential {
     MisbindingPotential(OrigamiPotential& pot);
     virtual ~MisbindingPotential() {}
 
-    virtual double bind_domains(Domain& cd_i, Domain& cd_j) = 0;
+    virtual double bind_domains(
+            const TrialStates& states,
+            Domain& cd_i,
+            Domain& cd_j) = 0;
     bool m_constraints_violated;
 
   protected:
@@ -222,7 +362,10 @@ class OpposingMisbindingPotential: public MisbindingPotential {
 
   public:
     using MisbindingPotential::MisbindingPotential;
-    double bind_domains(Domain& cd_i, Domain& cd_j) override;
+    double bind_domains(
+            const TrialStates& states,
+            Domain& cd_i,
+            Domain& cd_j) override;
 };
 
 /**
@@ -232,7 +375,7 @@ class DisallowedMisbindingPotential: public MisbindingPotential {
 
   public:
     using MisbindingPotential::MisbindingPotential;
-    double bind_domains(Domain&, Domain&) override;
+    double bind_domains(const TrialStates&, Domain&, Domain&) override;
 };
 
 // Interface to origami potential
@@ -250,12 +393,47 @@ class OrigamiPotential {
 
     void update_temp(double temp, double stacking_mult = 1);
 
+    /**
+     * Calculate the tables for a ladder of temperatures ahead of time
+     *
+     * Stacking multipliers pair up with the temperatures and default to one.
+     * Later temperature updates to any of these points only switch tables.
+     */
+    void precompute_energy_tables(
+            const vector<double>& temps,
+            const vector<double>& stacking_mults = {});
+
     // Domain interactions
     DeltaConfig bind_domain(Domain& cd_i);
-    bool check_domains_complementary(Domain& cd_i, Domain& cd_j);
+
+    /**
+     * Calculate the change from binding a domain at a trial configuration
+     *
+     * The domain is taken at the given position and orientation, bound to
+     * the given domain, without changing either of them. The binding
+     * potentials keep their working state and violation flags.
+     */
+    DeltaConfig evaluate_binding(
+            Domain& cd_i,
+            const VectorThree& pos,
+            const VectorThree& ore,
+            Domain& cd_j,
+            bool& constraints_violated);
+    bool check_domains_complementary(const Domain& cd_i, const Domain& cd_j)
+            const;
     DeltaConfig check_stacking(Domain& cd_i, Domain& cd_j);
 
+
     // Energy calculations
+    PairEnergies pair_energies(const Domain& cd_i, const Domain& cd_j) const {
+        PairEnergies energies {
+                m_energies->pairs(cd_i.m_d_ident, cd_j.m_d_ident)};
+        energies.hyb_enthalpy *= m_enthalpy_scale;
+        energies.hyb_energy = energies.hyb_enthalpy - energies.hyb_entropy;
+        energies.stacking_energy *= m_stacking_scale;
+
+        return energies;
+    }
     double hybridization_energy(const Domain& cd_i, const Domain& cd_j) const;
     double hybridization_enthalpy(const Domain& cd_i, const Domain& cd_j) const;
     double hybridization_entropy(const Domain& cd_i, const Domain& cd_j) const;
@@ -276,6 +454,12 @@ class OrigamiPotential {
     // Containers for binding rules
     BindingPotential* m_binding_pot;
     MisbindingPotential* m_misbinding_pot;
+
+    DeltaConfig bind_pair(
+            const TrialStates& states,
+            Domain& cd_i,
+            Domain& cd_j,
+            bool& constraints_violated);
     string m_stacking_pot;
     string m_hybridization_pot;
     bool m_apply_mean_field_cor;
@@ -284,42 +468,59 @@ class OrigamiPotential {
     double m_stacking_ene {0};
 
     // Hybridization enthalpy and entropy if constant
-    double m_binding_h;
-    double m_binding_s;
-    double m_misbinding_h;
-    double m_misbinding_s;
-
-    // CONSIDER DEFINING TYPE FOR THESE TABLES
-    // Energy tables index by chain/domain identity pair
-    unordered_map<pair<int, int>, double> m_hybridization_energies {};
-    unordered_map<pair<int, int>, double> m_hybridization_enthalpies {};
-    unordered_map<pair<int, int>, double> m_hybridization_entropies {};
-    unordered_map<pair<int, int>, double> m_stacking_energies {};
-
-    // Energies tables indexed by temperature
-    unordered_map<double, unordered_map<pair<int, int>, double>>
-            m_hybridization_energy_tables {};
-    unordered_map<double, unordered_map<pair<int, int>, double>>
-            m_hybridization_enthalpy_tables {};
-    unordered_map<double, unordered_map<pair<int, int>, double>>
-            m_hybridization_entropy_tables {};
-    unordered_map<pair<double, double>, unordered_map<pair<int, int>, double>>
-            m_stacking_energy_tables {};
-
-    // Initiation enthalpy and entropy
-    double m_init_enthalpy;
-    double m_init_entropy;
-    double m_init_energy;
+    double m_binding_h {0};
+    double m_binding_s {0};
+    double m_misbinding_h {0};
+    double m_misbinding_s {0};
+
+    // Energy tables indexed by temperature and stacking multiplier, with the
+    // current ones selected by pointer so that a temperature update is cheap.
+    // Tables are never changed once calculated, so are shared between all
+    // potentials of the process that would calculate the same ones, and
+    // between processes through the cache files if there are any
+    unordered_map<pair<double, double>, std::shared_ptr<EnergyTables>>
+            m_energy_tables {};
+    EnergyTables* m_energies {nullptr};
+
+    // Analytic mode keeps only the tables at the starting temperature and
+    // rescales the enthalpies and constant stacking energies on lookup; in
+    // table mode the scales stay one
+    bool m_analytic_energies;
+    double m_ref_temp;
+    double m_enthalpy_scale {1};
+    double m_stacking_scale {1};
+
+    // Chain and domain index of the first domain of each identity
+    vector<pair<size_t, size_t>> m_unique_domains {};
+
+    // Temperature independent H and S (kcal/mol) of the longest
+    // complementary subsequences of each identity pair, kept across tables
+    unordered_map<pair<int, int>, vector<ThermoOfHybrid>> m_comp_seq_thermos {};
 
     // Energy table preperation
+    EnergyTables& energy_tables(double temp, double stacking_mult);
     void get_energies();
-    bool read_energies_from_file();
-    void write_energies_to_file();
+
+    /**
+     * Tables are cached in binary files named by a hash of everything they
+     * are calculated from, including the temperature
+     *
+     * Cached tables are mapped and read in place, and missing ones are
+     * calculated by only one process while the others wait to map them.
+     */
+    uint64_t energy_cache_key() const;
+    string energy_cache_filename(uint64_t key) const;
+    bool read_energies_from_file(string filename, uint64_t key);
+    void write_energies_to_file(string filename, uint64_t key);
     void calc_energies();
     void calc_hybridization_energy(
             string seq_i,
             string seq_j,
             pair<int, int> key);
+    const vector<ThermoOfHybrid>& comp_seq_thermos(
+            string seq_i,
+            string seq_j,
+            pair<int, int> key);
     void calc_hybridization_energy(pair<int, int> key);
     void set_hybridization_energy(pair<int, int> key);
     void calc_stacking_energy(string seq_i, string seq_j, pair<int, int> key);
@@ -3,6 +3,7 @@
 #ifndef ORIGAMI_SYSTEM_H
 #define ORIGAMI_SYSTEM_H
 
+#include <array>
 #include <map>
 #include <set>
 #include <string>
@@ -14,9 +15,12 @@
 #include "boost/serialization/vector.hpp"
 
 #include "domain.h"
+#include "domain_pool.h"
 #include "hash.h"
+#include "occupancy_grid.h"
 #include "origami_potential.h"
 #include "parser.h"
+#include "slot_map.h"
 #include "utility.h"
 
 // Forward declaration
@@ -39,9 +43,13 @@ using std::valarray;
 using std::vector;
 
 using domainContainer::Domain;
+using domainContainer::DomainPool;
+using occupancyGrid::OccupancyGrid;
 using parser::InputParameters;
 using potential::DeltaConfig;
 using potential::OrigamiPotential;
+using potential::PairEnergies;
+using slotMap::SlotMap;
 using utility::Occupancy;
 using utility::VectorThree;
 
@@ -65,6 +73,52 @@ struct Chain {
 };
 using Chains = vector<Chain>;
 
+// Copies of one chain identity in the system and how many of them are bound
+struct StapleStats {
+    int copies {0};
+    int bound_copies {0}; // At least one domain bound or misbound
+    int fully_bound_copies {0}; // All domains bound to their complements
+};
+
+// Domain state as first seen by the move journal
+struct DomainRecord {
+    Domain* domain;
+    VectorThree pos;
+    VectorThree ore;
+    Occupancy state;
+    Domain* bound_domain;
+};
+
+// Configuration dependent counters, restored wholesale by the move journal
+struct SystemCounts {
+    double energy;
+    double pair_enthalpy;
+    double pair_entropy;
+    int num_unassigned_domains;
+    int num_bound_domain_pairs;
+    int num_fully_bound_domain_pairs;
+    int num_self_bound_domain_pairs;
+    int num_stacked_domain_pairs;
+};
+
+// Outcome of placing an unassigned domain, found without placing it
+struct TrialResult {
+    double e {0}; // Energy change, with the bias change if there are biases
+    int stacked_pairs {0};
+    Occupancy state {Occupancy::unassigned}; // State the domain would take
+    bool constraints_violated {false};
+};
+
+// Trial of a domain on one of the sites next to a growth point
+struct NeighbourTrial {
+    VectorThree pos;
+    Occupancy occupancy; // Occupancy of the site before the trial
+    Domain* unbound_domain; // Domain on the site if it is unbound
+    VectorThree ore; // Orientation an unbound domain forces, otherwise zero
+    TrialResult result;
+};
+using NeighbourTrials = std::array<NeighbourTrial, 6>;
+
 // Cubic lattice domain-level resolution model of DNA origami
 class OrigamiSystem {
   public:
@@ -101,14 +155,23 @@ class OrigamiSystem {
     // Configuration properties
     orderParams::SystemOrderParams& get_system_order_params();
     biasFunctions::SystemBiases& get_system_biases();
-    vector<Domain*> get_chain(int c_i);
-    vector<vector<Domain*>> get_chains();
-    vector<Domain*> get_last_chain();
+
+    // Chain accessors return views into the system, which are only valid
+    // until the next chain is added or deleted
+    const vector<Domain*>& get_chain(int c_i) const;
+    const vector<vector<Domain*>>& get_chains() const;
+    const vector<Domain*>& get_last_chain() const;
     Domain* get_domain(int c_i, int d_i);
-    vector<int> get_staple_counts();
+    vector<int> get_staple_counts() const;
     int num_staples() const;
     int num_unique_staples() const;
+
+    /** Statistics of an identity, kept current as domains change state */
+    const StapleStats& staple_stats(int c_ident) const;
     int num_domains();
+
+    /** Domain at an index into all domains, in an arbitrary order */
+    Domain* indexed_domain(int d_i_index) const;
     int num_bound_domain_pairs() const;
     int num_fully_bound_domain_pairs() const;
     int num_self_bound_domain_pairs() const;
@@ -117,24 +180,61 @@ class OrigamiSystem {
     int num_linear_helix_trips() const;
     int num_stacked_junct_quads() const;
     int num_staples_of_ident(int staple_ident) const;
-    vector<int> staples_of_ident(int c_ident);
-    vector<int> complementary_scaffold_domains(int staple_ident) const;
+    const vector<int>& staples_of_ident(int c_ident) const;
+    const vector<int>& complementary_scaffold_domains(int staple_ident) const;
+
+    // Chain indices in ascending order, for writers that need a stable order;
+    // get_chains() is in an arbitrary order that changes as chains are deleted
+    vector<int> ordered_chain_indices() const;
     Chains chains() const;
     Occupancy position_occupancy(VectorThree pos) const;
     Domain* unbound_domain_at(VectorThree pos) const;
     bool check_domains_complementary(Domain& cd_i, Domain& cd_j);
     double energy() const;
-    void update_enthalpy_and_entropy();
-    double hybridization_enthalpy();
-    double hybridization_entropy();
-    double stacking_energy();
+
+    /**
+     * Hybridization and stacking parts of the energy
+     *
+     * Pair sums are kept up to date as domains bind and unbind, so these
+     * are constant time.
+     */
+    double hybridization_enthalpy() const;
+    double hybridization_entropy() const;
+    double stacking_energy() const;
     bool configuration_fully_set();
     int num_unassigned_domains();
     double init_energy();
 
     // Constraint checkers
     void check_all_constraints();
-    virtual double check_domain_constraints(
+
+    /** Recount the hybridization pair sums and throw if they have drifted */
+    void check_enthalpy_and_entropy();
+
+    /** Recount the per identity statistics and throw if they disagree */
+    void check_staple_stats() const;
+
+    /** Evaluate a config for a domain without changing the system */
+    TrialResult evaluate_trial(Domain& cd_i, VectorThree pos, VectorThree ore);
+
+    /**
+     * Evaluate a domain on all sites next to a growth point in one pass
+     *
+     * Each site is read from the lattice once. Unbound sites are evaluated
+     * with the orientation their domain forces, and unassigned sites with
+     * an arbitrary one, as orientation only matters for binding. Bound and
+     * misbound sites are marked as violating without further evaluation.
+     */
+    void evaluate_neighbour_trials(
+            Domain& cd_i,
+            VectorThree growth_pos,
+            NeighbourTrials& trials);
+
+    /** Count of configuration changes, for caching trial evaluations */
+    long long int config_version() const;
+
+    /** Trial energy of a config; sets the constraint violation flag */
+    double check_domain_constraints(
             Domain& cd_i,
             VectorThree pos,
             VectorThree ore);
@@ -164,30 +264,53 @@ class OrigamiSystem {
 
     // System state modifiers
     void update_temp(double temp, double stacking_mult = 1);
+    void precompute_energy_tables(
+            const vector<double>& temps,
+            const vector<double>& stacking_mults = {});
     void update_staple_us(double temp, double staple_u_mult);
     virtual void update_bias_mult(double) {};
 
+    // Move journal
+    /** Start recording changes so the configuration can be rolled back */
+    void begin_journal();
+
+    /**
+     * Restore the configuration from when the journal was begun
+     *
+     * Saved states are written back without evaluating the potential.
+     * Returns false, changing nothing, if the journal is not recording or
+     * a chain was deleted since it began.
+     */
+    virtual bool undo_journal();
+
+    /** Stop recording and keep the current configuration */
+    void discard_journal();
+
     // Constraints state
     bool m_constraints_violated {false};
 
-    // The index that should be assigned to the next added chain
-    int m_current_c_i {};
-
   protected:
     // Bookeeping stuff, could probably organize better
+    DomainPool m_domain_pool; // Owns all domains
     vector<vector<Domain*>> m_domains {}; // Domains grouped by chain
-    string m_domain_type;
     int m_num_domains {0}; // Total domains in system
+    vector<Domain*> m_domain_list {}; // All domains, for uniform selection
+    vector<int> m_domain_list_indices {}; // Domain id to index in list
     int m_num_staples {0};
     vector<vector<int>> m_staple_ident_to_scaffold_ds {}; // Staple ID to comp
                                                           // scaffold domain i
-    vector<int> m_chain_indices {}; // Working to unique index
+    SlotMap m_chain_slots {}; // Unique index to and from working index
     vector<int> m_chain_identities {}; // Working index to id
+    vector<int> m_chain_ident_positions {}; // Working index to position in
+                                            // its identity's unique indices
     vector<vector<int>> m_identity_to_index {}; // ID to unique indices
-    unordered_map<VectorThree, Domain*>
-            m_pos_to_unbound_d {}; // Position to unbound domain
-    unordered_map<VectorThree, Occupancy>
-            m_position_occupancies {}; // State of positions
+    vector<StapleStats> m_staple_stats {}; // ID to copy and binding counts
+    vector<int> m_chain_paired_domains {}; // Working index to number of
+                                           // bound or misbound domains
+    vector<int> m_chain_bound_domains {}; // Working index to number of
+                                          // bound domains
+    int m_num_unique_staples {0};
+    OccupancyGrid m_occupancies {}; // State and unbound domain of positions
     int m_num_bound_domain_pairs {0}; // Num bound domains pairs
     int m_num_fully_bound_domain_pairs {
             0}; // Num bound fully complementary domain pairs
@@ -201,30 +324,59 @@ class OrigamiSystem {
     unique_ptr<biasFunctions::SystemBiases> m_biases;
 
     double m_energy {0};
-    double m_hyb_enthalpy;
-    double m_hyb_entropy;
-    double m_stacking_energy;
+
+    // Hybridization enthalpy and entropy summed over bound pairs only
+    double m_pair_enthalpy {0};
+    double m_pair_entropy {0};
     bool m_apply_mean_field_cor;
     OrigamiPotential m_pot;
 
+    // Move journal state
+    bool m_journal_active {false};
+    vector<DomainRecord> m_journal {}; // Domains in order first changed
+    vector<int> m_journal_chains {}; // Chains added while recording
+    SystemCounts m_journal_counts {};
+    vector<long long int> m_journal_stamps {}; // Domain id to last epoch saved
+    long long int m_journal_epoch {0};
+    long long int m_config_version {0};
+
     // Intializers
     void initialize_complementary_associations();
     void initialize_scaffold(Chain scaffold_chain);
     void initialize_staples(Chains chain);
+    void append_chain(int c_i, int c_i_ident);
 
     // States updates
     DeltaConfig internal_unassign_domain(Domain& cd_i);
     double unassign_bound_domain(Domain& cd_i);
     void unassign_unbound_domain(Domain& cd_i);
+    void update_pair_thermo(Domain& cd_i, Domain& cd_j, int sign);
+    void update_staple_stats(Domain& cd_i, Occupancy old_state);
     void update_domain(Domain& cd_i, VectorThree pos, VectorThree ore);
     void update_occupancies(Domain& cd_i, VectorThree position);
     void update_energy();
 
-    // Constraint checkers
-    DeltaConfig internal_check_domain_constraints(
+    // Called before any change to the state of a domain
+    void note_domain_change(Domain& cd_i);
+
+    // Move journal
+    virtual void update_restored_domain(Domain&) {};
+
+    // Trial evaluation
+    virtual void check_trial_bias(
+            Domain&,
+            VectorThree,
+            VectorThree,
+            TrialResult&) {};
+
+    // Constraint checkers; the domains are not changed, but the potential's
+    // working state is
+    TrialResult internal_evaluate_trial(
             Domain& cd_i,
             VectorThree pos,
-            VectorThree ore);
+            VectorThree ore,
+            Occupancy occupancy,
+            Domain* unbound_domain);
 };
 
 class OrigamiSystemWithBias: public OrigamiSystem {
@@ -239,12 +391,6 @@ class OrigamiSystemWithBias: public OrigamiSystem {
             double staple_M,
             InputParameters& params);
 
-    // Constraint checkers
-    double check_domain_constraints(
-            Domain& cd_i,
-            VectorThree pos,
-            VectorThree ore);
-
     // Configuration modifiers
     double unassign_domain(Domain& cd_i);
     // Need to make the base one virtual still
@@ -260,6 +406,14 @@ class OrigamiSystemWithBias: public OrigamiSystem {
             VectorThree position,
             VectorThree orientation);
     // void set_domain_orientation(Domain& cd_i, VectorThree ore);
+
+  protected:
+    void update_restored_domain(Domain& cd_i);
+    void check_trial_bias(
+            Domain& cd_i,
+            VectorThree pos,
+            VectorThree ore,
+            TrialResult& trial);
 };
 
 // Moved from main
@@ -41,6 +41,7 @@ class InputParameters {
     double m_misbinding_h;
     double m_misbinding_s;
     bool m_apply_mean_field_cor;
+    bool m_analytic_energies {false};
     int m_min_total_staples;
     int m_max_total_staples;
     int m_max_type_staples;
@@ -55,6 +56,9 @@ class InputParameters {
 
     // General simulation parameters
     int m_random_seed;
+    int m_random_stream;
+    string m_random_engine;
+    bool m_replica_streams;
     string m_movetype_filename;
     string m_num_walks_filename;
     string m_restart_traj_file;
@@ -88,6 +92,9 @@ class InputParameters {
     vector<double> m_temps {};
     int m_num_reps;
     int m_exchange_interval;
+    string m_exchange_mode;
+    int m_replicas_per_rank;
+    int m_time_check_swaps;
     long long int m_swaps;
     double m_max_pt_dur;
     vector<double> m_bias_mults {};
@@ -3,7 +3,11 @@
 #ifndef PTMC_SIMULATION_H
 #define PTMC_SIMULATION_H
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <iostream>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -14,6 +18,7 @@
 #include "order_params.h"
 #include "origami_system.h"
 #include "parser.h"
+#include "random_gens.h"
 #include "simulation.h"
 
 namespace ptmc {
@@ -28,7 +33,57 @@ using biasFunctions::SystemBiases;
 using orderParams::SystemOrderParams;
 using origami::OrigamiSystem;
 using parser::InputParameters;
+using randomGen::Xoshiro256pp;
 using simulation::GCMCSimulation;
+using simulation::use_replica_streams;
+using std::chrono::steady_clock;
+
+/**
+ * Replicas run as threads of one process
+ *
+ * Each replica has its own system, movetypes and random engine, while the
+ * energy tables and ideal random walk counts are shared. Collectives between
+ * replicas go through the first replica of each process, which moves the
+ * blocks of all the process's replicas in one MPI call, so exchanges within
+ * a process are only memory copies.
+ */
+class ReplicaGroup {
+  public:
+    ReplicaGroup(int size);
+    int size() const;
+
+    // Collectives over all replicas, with blocks ordered by replica
+    void gather(
+            mpi::communicator& world,
+            int local_rep,
+            const double* in_values,
+            int n,
+            vector<double>& out_values,
+            int root);
+    void scatter(
+            mpi::communicator& world,
+            int local_rep,
+            const vector<double>& in_values,
+            double* out_values,
+            int n,
+            int root);
+
+  private:
+    void wait();
+
+    int m_size;
+    vector<double> m_send_buffer {};
+    vector<double> m_recv_buffer {};
+
+    // Barrier of the process's replicas
+    std::mutex m_mutex {};
+    std::condition_variable m_released {};
+    int m_num_arrived {0};
+    long long int m_generation {0};
+};
+
+/** Run replicas_per_rank replicas of a PT simulation as threads */
+void run_threaded_pt(InputParameters& params);
 
 // Base method for parallel tempering in GC ensemble
 class PTGCMCSimulation: public GCMCSimulation {
@@ -37,7 +92,9 @@ class PTGCMCSimulation: public GCMCSimulation {
             OrigamiSystem& origami_system,
             SystemOrderParams& ops,
             SystemBiases& biases,
-            InputParameters& params);
+            InputParameters& params,
+            ReplicaGroup* group = nullptr,
+            int local_rep = 0);
     void run();
 
   protected:
@@ -45,8 +102,12 @@ class PTGCMCSimulation: public GCMCSimulation {
     mpi::environment m_env;
     mpi::communicator m_world;
 
+    // Replicas of this process when run as threads
+    ReplicaGroup* m_group;
+    int m_local_rep;
+
     // General PTMC parameters
-    int m_rank {m_world.rank()};
+    int m_rank; // Replica index
     int m_master_rep {0};
     int m_num_reps;
     long long int m_swaps;
@@ -83,27 +144,125 @@ class PTGCMCSimulation: public GCMCSimulation {
     // Indices of quantities that will be exchanged
     vector<int> m_exchange_q_is;
 
+    // Packed exchange buffers
+    vector<double> m_dependent_buffer {}; // This replica's dependent qs
+    vector<double> m_gathered_buffer {}; // All replicas' (master only)
+    vector<double> m_control_buffer {}; // All replicas' (master only)
+    vector<double> m_replica_control_buffer {}; // This replica's control qs
+
+    // Pairwise exchange, where each replica only communicates with the
+    // replicas at neighbouring positions of the control quantity grid
+    bool m_pairwise {false};
+    int m_position; // Index into the control qs held by this replica
+    vector<int> m_neighbour_positions {};
+    vector<int> m_neighbour_reps {}; // Replica at each neighbouring position
+    vector<int> m_new_neighbour_reps {};
+    vector<int> m_partner_neighbour_reps {};
+    vector<double> m_partner_buffer {};
+    uint64_t m_exchange_seed; // Same on every replica
+    int m_time_check_swaps; // Swaps between checks of the time limit
+    Xoshiro256pp m_exchange_engine {};
+
+    // Asynchronous exchange, where the master pairs up replicas as they
+    // become ready (master only apart from the mode and stopping flag)
+    bool m_async {false};
+    vector<int> m_repi_to_q {};
+    vector<vector<double>> m_offer_buffers {}; // By replica
+    vector<int> m_offer_swaps {}; // Swap of each replica's latest offer
+    vector<bool> m_waiting {}; // By replica
+    vector<bool> m_finished {}; // By replica
+    int m_num_finished {0}; // Replicas other than the master
+    bool m_stopping {false};
+
+    // Exchange timing, from the end of a replica's steps to the point it
+    // can continue, so all of it is time the replica sits idle
+    long long int m_num_exchanges {0};
+    double m_exchange_time {0};
+    double m_max_exchange_time {0};
+    double m_run_time {0};
+
     // Initialization methods
     virtual void initialize_control_qs(InputParameters& params) = 0;
     void initialize_swap_file(InputParameters& params);
 
     // Communication methods
-    void slave_send(int swap_i);
-    bool slave_receive(int swap_i);
-    void master_receive(
-            int swap_i,
-            vector<vector<double>>& quantities,
-            vector<vector<vector<double>>>&);
-    void master_send(int swap_i);
-    void master_send_kill(int swap_i);
-    void master_get_dependent_qs(
-            vector<vector<double>>&,
-            vector<vector<vector<double>>>&);
+    //
+    // Each replica packs its dependent quantities, staple chemical
+    // potentials and staple counts into one buffer, and the master gathers
+    // them all in a single collective. The new control quantities go back
+    // in one scatter, each block led by a flag saying whether to continue.
+    void pack_dependent_qs();
+    void gather_dependent_qs();
+    bool scatter_control_qs(bool kill);
+    void unpack_dependent_qs(
+            vector<vector<double>>& dependent_qs,
+            vector<vector<vector<double>>>& per_staple_dependent_qs);
+    void pack_control_qs();
+    void gather_to_master(
+            const double* in_values,
+            int n,
+            vector<double>& out_values);
+    void scatter_from_master(
+            const vector<double>& in_values,
+            double* out_values,
+            int n);
     virtual void update_control_qs() = 0;
     void update_dependent_qs();
 
     // Exchange methods
+    bool master_exchange(
+            int swap_i,
+            long long int step,
+            steady_clock::time_point start);
     virtual void attempt_exchange(int swap_i) = 0;
+
+    // Pairwise exchange methods
+    //
+    // Paired replicas swap their dependent quantities directly and both
+    // decide acceptance with the same variate, drawn from a stream shared by
+    // all replicas and keyed by the swap and position. Replicas then tell
+    // their neighbours who now holds their old position. The swap file is
+    // only written when a swap entry is due, as that needs every replica.
+    // The time limit is checked every time_check_swaps swaps, in a
+    // reduction that stops every replica once any is over it.
+    void initialize_positions();
+    bool pairwise_exchange(
+            int swap_i,
+            long long int step,
+            steady_clock::time_point start);
+    double pair_acceptance_p(
+            int pos_1,
+            int pos_2,
+            const vector<double>& buffer_1,
+            const vector<double>& buffer_2);
+    double shared_uniform(int swap_i, int pos);
+    void gather_positions();
+    void sum_on_master(vector<int>& counts);
+
+    /** Position paired with the given one for this swap, or -1 if none */
+    virtual int exchange_partner(int swap_i, int pos) = 0;
+
+    /** Neighbouring positions in a fixed order of directions, -1 if none */
+    virtual vector<int> neighbour_positions(int pos) = 0;
+    virtual void count_exchange(int pos_1, int pos_2, bool accepted) = 0;
+    virtual void combine_exchange_counts() = 0;
+
+    // Asynchronous exchange methods
+    //
+    // Each replica runs its steps and then offers its quantities to the
+    // master, which polls for offers between its own steps. A replica's
+    // k-th offer is paired with the k-th offer of the replica at its
+    // exchange_partner position for swap k, and the decision is drawn from
+    // the shared exchange stream. The pairs and outcomes are then those of
+    // pairwise exchange and do not depend on when replicas become ready,
+    // but each replica only waits for its own partner.
+    void run_async();
+    bool offer_exchange();
+    bool master_wait_for_exchange(int swap_i, steady_clock::time_point start);
+    void finish_async_exchanges();
+    void service_offers();
+    void match_offer(int rep);
+    void release_replica(int rep, bool kill);
     bool test_acceptance(double acceptance_p);
     double calc_acceptance_p(
             vector<pair<double, double>> control_q_pairs,
@@ -115,8 +274,9 @@ class PTGCMCSimulation: public GCMCSimulation {
     // Output methods
     void write_swap_entry(long long int step);
     virtual void write_acceptance_freqs() = 0;
+    void write_exchange_timing();
 
-    void update_internal(long long int) {};
+    void update_internal(long long int) override;
 };
 
 class OneDPTGCMCSimulation: public PTGCMCSimulation {
@@ -125,11 +285,17 @@ class OneDPTGCMCSimulation: public PTGCMCSimulation {
             OrigamiSystem& origami_system,
             SystemOrderParams& ops,
             SystemBiases& biases,
-            InputParameters& params);
+            InputParameters& params,
+            ReplicaGroup* group = nullptr,
+            int local_rep = 0);
 
   protected:
     void initialize_control_qs(InputParameters& params) override;
     void attempt_exchange(int swap_i) override;
+    int exchange_partner(int swap_i, int pos) override;
+    vector<int> neighbour_positions(int pos) override;
+    void count_exchange(int pos_1, int pos_2, bool accepted) override;
+    void combine_exchange_counts() override;
     void write_acceptance_freqs() override;
 
     vector<int> m_attempt_count;
@@ -142,11 +308,17 @@ class TwoDPTGCMCSimulation: public PTGCMCSimulation {
             OrigamiSystem& origami_system,
             SystemOrderParams& ops,
             SystemBiases& biases,
-            InputParameters& params);
+            InputParameters& params,
+            ReplicaGroup* group = nullptr,
+            int local_rep = 0);
 
   protected:
     void initialize_control_qs(InputParameters& params) override;
     void attempt_exchange(int swap_i) override;
+    int exchange_partner(int swap_i, int pos) override;
+    vector<int> neighbour_positions(int pos) override;
+    void count_exchange(int pos_1, int pos_2, bool accepted) override;
+    void combine_exchange_counts() override;
     void write_acceptance_freqs() override;
 
   private:
@@ -174,7 +346,9 @@ class TPTGCMCSimulation: public OneDPTGCMCSimulation {
             OrigamiSystem& origami_system,
             SystemOrderParams& ops,
             SystemBiases& biases,
-            InputParameters& params);
+            InputParameters& params,
+            ReplicaGroup* group = nullptr,
+            int local_rep = 0);
 
   private:
     void update_control_qs() override;
@@ -187,7 +361,9 @@ class UTPTGCMCSimulation: public OneDPTGCMCSimulation {
             OrigamiSystem& origami_system,
             SystemOrderParams& ops,
             SystemBiases& biases,
-            InputParameters& params);
+            InputParameters& params,
+            ReplicaGroup* group = nullptr,
+            int local_rep = 0);
 
   private:
     void update_control_qs() override;
@@ -200,7 +376,9 @@ class HUTPTGCMCSimulation: public OneDPTGCMCSimulation {
             OrigamiSystem& origami_system,
             SystemOrderParams& ops,
             SystemBiases& biases,
-            InputParameters& params);
+            InputParameters& params,
+            ReplicaGroup* group = nullptr,
+            int local_rep = 0);
 
   private:
     void update_control_qs() override;
@@ -213,7 +391,9 @@ class STPTGCMCSimulation: public OneDPTGCMCSimulation {
             OrigamiSystem& origami_system,
             SystemOrderParams& ops,
             SystemBiases& biases,
-            InputParameters& params);
+            InputParameters& params,
+            ReplicaGroup* group = nullptr,
+            int local_rep = 0);
 
   private:
     void update_control_qs() override;
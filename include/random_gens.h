@@ -3,31 +3,104 @@
 #ifndef RANDOM_GENS_H
 #define RANDOM_GENS_H
 
+#include <array>
+#include <cstdint>
+#include <iostream>
 #include <random>
-#include <unordered_map>
-#include <utility>
-
-#include "hash.h"
+#include <string>
+#include <vector>
 
 namespace randomGen {
 
-using std::pair;
-using std::unordered_map;
+using std::array;
+using std::istream;
+using std::ostream;
+using std::string;
+using std::vector;
+
+/**
+ * xoshiro256++ generator of Blackman and Vigna
+ *
+ * Much faster than the Mersenne twister with a 32 byte state. Seeds are
+ * expanded with splitmix64 from a seed and a stream id, so that replicas
+ * and windows started from one seed get independent streams.
+ */
+class Xoshiro256pp {
+  public:
+    using result_type = uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    void seed(uint64_t seed, uint64_t stream);
+    result_type operator()() {
+        uint64_t result {rotl(m_state[0] + m_state[3], 23) + m_state[0]};
+        uint64_t t {m_state[1] << 17};
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+
+        return result;
+    }
+
+    friend ostream& operator<<(ostream& stream, const Xoshiro256pp& engine);
+    friend istream& operator>>(istream& stream, Xoshiro256pp& engine);
+
+  private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    array<uint64_t, 4> m_state {};
+};
+
+enum class RandomEngine { mt19937_64, xoshiro256pp };
 
 class RandomGens {
   public:
     RandomGens();
-    ~RandomGens();
 
-    void set_seed(int seed);
+    /** Select the engine by name; mt19937_64 reproduces older runs */
+    void set_engine(string engine);
+
+    /** Seed the engine for the given stream of a seed */
+    void set_seed(int seed, int stream = 0);
+
     double uniform_real();
     int uniform_int(int lower, int upper);
-    std::mt19937_64 m_random_engine {};
+
+    // Engine state in the format of the selected engine
+    void write_state(ostream& stream) const;
+    void read_state(istream& stream);
 
   private:
+    RandomEngine m_engine {RandomEngine::mt19937_64};
+    uint64_t m_seed;
+    std::mt19937_64 m_random_engine {};
+    Xoshiro256pp m_xoshiro {};
     std::uniform_real_distribution<double> m_uniform_real_dist;
-    unordered_map<pair<int, int>, std::uniform_int_distribution<int>&>
-            m_uniform_int_dists {};
+};
+
+/**
+ * Walker alias table for drawing from a fixed discrete distribution
+ *
+ * A draw takes one uniform variate and constant time however many outcomes
+ * there are. The table must be rebuilt if the weights change.
+ */
+class AliasSampler {
+  public:
+    AliasSampler() = default;
+
+    /** Weights need not be normalized */
+    AliasSampler(const vector<double>& weights);
+
+    size_t sample(RandomGens& random_gens) const;
+
+  private:
+    vector<double> m_probs {}; // Chance of keeping each column's own outcome
+    vector<size_t> m_aliases {};
 };
 } // namespace randomGen
 
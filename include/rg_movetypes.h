@@ -3,17 +3,22 @@
 #ifndef RG_MOVETYPES_H
 #define RG_MOVETYPES_H
 
-#include <list>
+#include <bitset>
 
 #include "movetypes.h"
 
 namespace movetypes {
 
-using std::list;
+using origami::NeighbourTrial;
+using origami::NeighbourTrials;
 using utility::ScaffoldRGRegrowthTracking;
 
 typedef pair<VectorThree, VectorThree> configT;
 
+// Every lattice vector for the position and the orientation
+const int c_num_configs {36};
+typedef std::bitset<c_num_configs> configSetT;
+
 /** Conserved topology recoil growth base class */
 class CTRGRegrowthMCMovetype: virtual public CTRegrowthMCMovetype {
 
@@ -37,7 +42,7 @@ class CTRGRegrowthMCMovetype: virtual public CTRegrowthMCMovetype {
   protected:
     void add_external_bias() override;
     double unassign_and_save_domains();
-    double unassign_and_save_domains(vector<Domain*>);
+    double unassign_and_save_domains(const vector<Domain*>&);
     void unassign_domains();
 
     /** Update the external bias without adding */
@@ -49,8 +54,12 @@ class CTRGRegrowthMCMovetype: virtual public CTRegrowthMCMovetype {
     double set_config(Domain* d, configT c);
     void prepare_for_growth();
     double prepare_for_regrowth();
+    void push_erased_endpoints();
     void restore_endpoints();
     configT select_trial_config();
+
+    /** Trial of a config, taken from a batch over the reference's sites */
+    NeighbourTrial config_trial(configT c);
     double calc_p_config_open(configT c);
     bool test_config_open(double p_c_open);
     void calc_weights();
@@ -60,7 +69,7 @@ class CTRGRegrowthMCMovetype: virtual public CTRegrowthMCMovetype {
 
     const vector<configT> m_all_configs;
     const unordered_map<configT, int> m_config_to_i;
-    list<int> m_all_cis;
+    configSetT m_all_cis;
 
     // Movetype parameters
     int m_max_recoils;
@@ -71,12 +80,15 @@ class CTRGRegrowthMCMovetype: virtual public CTRegrowthMCMovetype {
     vector<Domain*> m_regrow_ds {}; // Domains to regrow
     vector<int> m_c_attempts_q {}; // Num. attempted configs per domain
     vector<int> m_c_attempts_wq {}; // Store of above for weight calc
-    vector<list<int>> m_avail_cis_q {}; // Available configs per domain
-    vector<list<int>> m_avail_cis_wq {}; // Store of above for weight calc
+    vector<configSetT> m_avail_cis_q {}; // Available configs per domain
+    vector<configSetT> m_avail_cis_wq {}; // Store of above for weight calc
     vector<double> m_c_opens; // Configuration open probability
-    unordered_map<pair<int, int>, VectorThree> m_new_pos {};
-    unordered_map<pair<int, int>, VectorThree> m_new_ore {};
-    vector<vector<VectorThree>> m_erased_endpoints_q {};
+    DomainConfigs m_new_configs {};
+
+    // Endpoints erased by each set domain, stacked end to end with the
+    // number erased by each domain
+    vector<VectorThree> m_erased_endpoints_q {};
+    vector<size_t> m_num_erased_endpoints_q {};
 
     double m_delta_e; // Energy change
     double m_weight; // RG weight
@@ -90,7 +102,14 @@ class CTRGRegrowthMCMovetype: virtual public CTRegrowthMCMovetype {
     int m_c_attempts; // Number of configs tried for current domain
     int m_d_max_c_attempts; // Max number of configs to be tried for current
                             // domain
-    list<int> m_avail_cis; // Available configurations
+    configSetT m_avail_cis; // Available configurations
+
+    // Trials of a domain around a growth point, valid until the system
+    // configuration next changes
+    NeighbourTrials m_trials {};
+    Domain* m_trials_d {nullptr};
+    VectorThree m_trials_pos {};
+    long long int m_trials_version {-1};
 };
 
 /** CTRG of a scaffold segment and bound staples */
@@ -116,7 +135,7 @@ class CTRGScaffoldRegrowthMCMovetype: public CTRGRegrowthMCMovetype {
             const CTRGScaffoldRegrowthMCMovetype&) = delete;
 
     void write_log_summary(ostream* log_entry) override;
-    void grow_chain(vector<Domain*>) override {};
+    void grow_chain(const vector<Domain*>&) override {};
 
   private:
     bool internal_attempt_move() override;
@@ -150,7 +169,7 @@ class CTRGJumpScaffoldRegrowthMCMovetype: public CTRGRegrowthMCMovetype {
             const CTRGScaffoldRegrowthMCMovetype&) = delete;
 
     void write_log_summary(ostream* log_entry) override;
-    void grow_chain(vector<Domain*>) override {};
+    void grow_chain(const vector<Domain*>&) override {};
 
   private:
     bool internal_attempt_move() override;
@@ -50,6 +50,7 @@ using movetypes::MCMovetype;
 using orderParams::SystemOrderParams;
 using origami::OrigamiSystem;
 using parser::InputParameters;
+using randomGen::AliasSampler;
 using randomGen::RandomGens;
 
 vector<OrigamiOutputFile*> setup_output_files(
@@ -60,6 +61,14 @@ vector<OrigamiOutputFile*> setup_output_files(
         SystemBiases& biases,
         RandomGens& random_gens);
 
+/**
+ * Whether replicas and windows draw from their own streams of the seed
+ *
+ * Otherwise all are seeded alike with the Mersenne twister, which is how
+ * earlier fixed-seed runs were seeded.
+ */
+bool use_replica_streams(const InputParameters& params);
+
 void setup_config_files(
         const string filebase,
         const int max_total_staples,
@@ -154,7 +163,7 @@ class GCMCSimulation {
     vector<OrigamiOutputFile*> m_config_per_move_files {};
     vector<unique_ptr<MCMovetype>> m_movetypes {};
     vector<double> m_movetype_freqs {};
-    vector<double> m_cumulative_probs {};
+    AliasSampler m_movetype_sampler {};
     RandomGens m_random_gens {};
     IdealRandomWalks m_ideal_random_walks {};
 
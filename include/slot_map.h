@@ -0,0 +1,57 @@
+// slot_map.h
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <vector>
+
+namespace slotMap {
+
+using std::vector;
+
+/**
+ * Map between stable integer handles and dense indices
+ *
+ * Handles stay valid while their element exists, while the dense indices are
+ * kept contiguous by moving the last element into the gap on erasure. The
+ * owner keeps its values in parallel dense arrays and mirrors each erase with
+ * the same swap and pop. Handles of erased elements are reused, most recently
+ * freed first, so they stay bounded by the largest number of elements held at
+ * once. Lookup, insertion and erasure are all constant time.
+ */
+class SlotMap {
+  public:
+    /** Add an element at the end of the dense range and return its handle */
+    int insert();
+
+    /** Add an element with a specific handle, which must not be in use */
+    void insert(int handle);
+
+    /**
+     * Remove an element and return the dense index it occupied
+     *
+     * The last element is moved into the returned index, unless the removed
+     * element was itself the last.
+     */
+    int erase(int handle);
+
+    bool contains(int handle) const;
+    int index(int handle) const;
+    int handle(int index) const;
+    int size() const;
+
+    /** Handles in dense order */
+    const vector<int>& handles() const;
+
+    /** Handles in ascending order, for consumers that need a stable order */
+    vector<int> ordered_handles() const;
+
+  private:
+    vector<int> m_handle_to_index {}; // -1 for free handles
+    vector<int> m_index_to_handle {};
+    vector<int> m_free_handles {};
+};
+
+} // namespace slotMap
+
+#endif // SLOT_MAP_H
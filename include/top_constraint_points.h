@@ -4,6 +4,7 @@
 #define TOP_CONSTRAINT_POINTS_H
 
 #include <set>
+#include <stdexcept>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -33,11 +34,53 @@ bool staple_excluded(vector<int> exclude_staples, int staple);
 bool staple_excluded(set<int> exclude_staples, int staple);
 
 /** Check if domain in given domains */
-bool domain_included(vector<Domain*> domains, Domain* d);
+bool domain_included(const vector<Domain*>& domains, Domain* d);
 
 /** Check if chain in given chain */
-bool chain_included(vector<int> staples, int staple);
-bool chain_included(set<int> staples, int staple);
+bool chain_included(const vector<int>& staples, int staple);
+bool chain_included(const set<int>& staples, int staple);
+
+/**
+ * Map from domains to values, stored densely by domain id
+ *
+ * Clearing marks every entry stale rather than freeing it, so that refilling
+ * the map for the next move does not allocate.
+ */
+template <typename T>
+class DomainMap {
+  public:
+    bool contains(const Domain* d) const {
+        size_t id {static_cast<size_t>(d->m_id)};
+        return id < m_stamps.size() and m_stamps[id] == m_stamp;
+    }
+    size_t count(const Domain* d) const { return contains(d); }
+
+    /** Value for the domain, default constructed if not present */
+    T& operator[](const Domain* d) {
+        size_t id {static_cast<size_t>(d->m_id)};
+        if (id >= m_stamps.size()) {
+            m_values.resize(id + 1);
+            m_stamps.resize(id + 1, 0);
+        }
+        if (m_stamps[id] != m_stamp) {
+            m_values[id] = T {};
+            m_stamps[id] = m_stamp;
+        }
+        return m_values[id];
+    }
+    const T& at(const Domain* d) const {
+        if (not contains(d)) {
+            throw std::out_of_range {"DomainMap::at"};
+        }
+        return m_values[d->m_id];
+    }
+    void clear() { m_stamp++; }
+
+  private:
+    vector<T> m_values {};
+    vector<unsigned long> m_stamps {};
+    unsigned long m_stamp {1};
+};
 
 /** Network of bound staples with potential growth- and endpoint info */
 class StapleNetwork {
@@ -47,7 +90,7 @@ class StapleNetwork {
     void set_excluded_staples(vector<int> excluded_staples);
 
     /** Set internal scaffold domains */
-    void set_scaffold_domains(vector<Domain*> scaffold_domains);
+    void set_scaffold_domains(const vector<Domain*>& scaffold_domains);
 
     /** Scan the staple network starting from the given staple domain
      *
@@ -58,18 +101,18 @@ class StapleNetwork {
      */
     void scan_network(Domain* d);
 
-    set<int> get_participating_chains();
-    vector<pair<Domain*, Domain*>> get_potential_growthpoints();
-    vector<pair<Domain*, Domain*>> get_potential_inactive_endpoints();
-    vector<Domain*> get_potential_domain_stack();
-    unordered_map<Domain*, int> get_staple_to_segs_map();
-    unordered_map<pair<int, int>, int> get_dirs();
+    const vector<int>& get_participating_chains() const;
+    const vector<pair<Domain*, Domain*>>& get_potential_growthpoints() const;
+    const vector<pair<Domain*, Domain*>>& get_potential_inactive_endpoints()
+            const;
+    const vector<Domain*>& get_potential_domain_stack() const;
+    const DomainMap<int>& get_staple_to_segs_map() const;
     bool externally_bound();
 
   private:
     void clear_network();
     void scan_staple_topology(Domain* domain);
-    vector<Domain*> make_staple_stack(Domain* d, int ci);
+    void make_staple_stack(Domain* d, int ci, vector<Domain*>& ds);
     void add_potential_inactive_endpoint(Domain* d, Domain* bd);
 
     OrigamiSystem& m_origami;
@@ -77,14 +120,15 @@ class StapleNetwork {
     bool m_external {false};
     vector<Domain*> m_scaffold_ds; // Scaffold segment being regrown
     vector<int> m_ex_staples; // Excluded staples
-    set<int> m_net_cs; // Chains involved in network
+    vector<int> m_net_cs; // Chains involved in network
     vector<pair<Domain*, Domain*>> m_pot_gps {}; // Potential growthpoints
     vector<Domain*> m_pot_ds {}; // Potential domain stack
     vector<pair<Domain*, Domain*>> m_pot_iaes; // Potential inactive endpoints
-    unordered_map<Domain*, int> m_segs {}; // Map from domain to segment
+    DomainMap<int> m_segs {}; // Map from domain to segment
 
-    // Map from domain and segment to regrowth direction
-    unordered_map<pair<int, int>, int> m_domain_to_dir {};
+    // Staple stacks of each level of the scan
+    vector<vector<Domain*>> m_staple_stacks {};
+    size_t m_scan_depth {0};
 };
 
 /** Topology of an associated scaffold segment
@@ -114,7 +158,7 @@ class Constraintpoints {
     int get_dir(Domain* d);
 
     /** Return endpoint positions erased from most recent update */
-    vector<VectorThree> get_erased_endpoints();
+    const vector<VectorThree>& get_erased_endpoints() const;
 
     void reset_internal();
 
@@ -125,16 +169,17 @@ class Constraintpoints {
      * staples. Note this does not include the endpoint of the
      * external scaffold domain that the scaffold domain is intended
      * to regrow to; the direction can be selected after this has been
-     * called.
+     * called. With several segments, only those given a direction are
+     * used.
      */
     void calculate_constraintpoints(
-            vector<Domain*> scaffold_domains,
+            const vector<Domain*>& scaffold_domains,
             int dir,
-            vector<int> excluded_staples);
+            const vector<int>& excluded_staples);
     void calculate_constraintpoints(
-            vector<vector<Domain*>> scaffold_segments,
-            vector<int> dirs,
-            vector<int> excluded_staples);
+            const vector<vector<Domain*>>& scaffold_segments,
+            const vector<int>& dirs,
+            const vector<int>& excluded_staples);
 
     /** Return the set of interally bound staples
      *
@@ -143,13 +188,16 @@ class Constraintpoints {
      */
     set<int> staples_to_be_regrown();
 
+    /** Fill the given vector with the same staples in increasing order */
+    void staples_to_be_regrown(vector<int>& staples) const;
+
     /** Return domain stack to be regrown
      *
      * Includes first domain of given scaffold range even thought this
      * is generally not regrown by the movetypes as it is used as a
      * reference by the first domain being regrown.
      */
-    vector<Domain*> domains_to_be_regrown();
+    const vector<Domain*>& domains_to_be_regrown() const;
 
     /** Test if given domain is used as a growthpoint */
     bool is_growthpoint(Domain* domain);
@@ -162,7 +210,7 @@ class Constraintpoints {
     void add_active_endpoint(Domain* domain, VectorThree endpoint_pos, int seg);
     void add_inactive_endpoint(Domain* d_i, Domain* d_j);
     void add_growthpoint(Domain* growthpoint, Domain* stemd);
-    void add_stem_seg_pair(Domain* stemd, vector<int> seg_pair);
+    void add_stem_seg_pair(Domain* stemd, pair<int, int> seg_pair);
 
     /** Reset the set of active endpoints to the initial set
      *
@@ -218,24 +266,37 @@ class Constraintpoints {
             int dir,
             int offset = 0);
     void find_growthpoints_endpoints(
-            vector<Domain*> scaffold_domains,
-            vector<int> excluded_staples,
+            const vector<Domain*>& scaffold_domains,
+            const vector<int>& excluded_staples,
             int seg);
     bool bound_to_self(Domain* d);
-    bool staple_already_checked(Domain* domain, set<int> checked_staples);
     void add_growthpoints(
-            vector<pair<Domain*, Domain*>> potential_growthpoints);
-    void add_inactive_endpoints(vector<pair<Domain*, Domain*>> pot_iaes);
+            const vector<pair<Domain*, Domain*>>& potential_growthpoints);
+    void add_inactive_endpoints(
+            const vector<pair<Domain*, Domain*>>& pot_iaes);
     void add_regrowth_staples(
-            set<int> participating_chains,
-            vector<int> excluded_staples);
-    void add_domains_to_stack(vector<Domain*> potential_d_stack);
+            const vector<int>& participating_chains,
+            const vector<int>& excluded_staples);
+    void add_domains_to_stack(const vector<Domain*>& potential_d_stack);
     void add_active_endpoints_on_scaffold(
-            vector<pair<Domain*, Domain*>> potential_growthpoints,
-            vector<pair<Domain*, Domain*>> potential_inactive_endpoints,
+            const vector<pair<Domain*, Domain*>>& potential_growthpoints,
+            const vector<pair<Domain*, Domain*>>& potential_inactive_endpoints,
             int seg);
-    void add_staple_to_segs_maps(unordered_map<Domain*, int> s_seg_map);
-    void add_dirs(unordered_map<pair<int, int>, int> domain_to_dirs);
+    void add_staple_to_segs_maps(
+            const vector<Domain*>& staple_domains,
+            const DomainMap<int>& s_seg_map);
+
+    /** Regrowth direction of the given segment of a chain
+     *
+     * Staples are grown out from their growthpoint, with the 3' segment
+     * first.
+     */
+    int seg_dir(int c_i, int seg) const;
+    void copy_endpoints(
+            const unordered_map<pair<int, int>, vector<pair<int, VectorThree>>>&
+                    from,
+            unordered_map<pair<int, int>, vector<pair<int, VectorThree>>>&
+                    to);
     int calc_remaining_steps(
             int endpoint_d_i,
             Domain* domain,
@@ -251,28 +312,33 @@ class Constraintpoints {
     vector<Domain*> m_scaffold_domains {};
 
     // Staples to be regrown
-    set<int> m_regrowth_staples;
+    vector<int> m_regrowth_staples;
 
     // Stack of domains in order for regrowth
     vector<Domain*> m_d_stack;
 
     // Chain ids of checked staples
-    set<int> m_checked_staples;
+    vector<int> m_checked_staples;
     vector<VectorThree> m_erased_endpoints;
 
+    // Potential growthpoints of the network being added
+    vector<pair<Domain*, Domain*>> m_pot_gps {};
+
     // Map from domain to segment
-    unordered_map<Domain*, int> m_segs {};
+    DomainMap<int> m_segs {};
 
-    // Map from domain and segment to regrowth direction
-    unordered_map<pair<int, int>, int> m_domain_to_dir {};
+    // Regrowth direction of each scaffold segment
+    vector<int> m_scaffold_dirs {};
 
     // Map from growthpoint domain to domain to grow
-    unordered_map<Domain*, Domain*> m_growthpoints {};
+    DomainMap<Domain*> m_growthpoints {};
 
     // Map from stem domain to growthpoint domain
-    unordered_map<Domain*, Domain*> m_stemdomains {};
+    DomainMap<Domain*> m_stemdomains {};
 
     // Map from chain to its active endpoints (absolute positions)
+    // Endpoint arrays are emptied rather than erased between moves to keep
+    // their storage
     unordered_map<pair<int, int>, vector<pair<int, VectorThree>>>
             m_active_endpoints {};
 
@@ -282,10 +348,10 @@ class Constraintpoints {
             m_initial_active_endpoints {};
 
     // Map from chain to endpoints it will impose once grown
-    unordered_map<Domain*, Domain*> m_inactive_endpoints {};
+    DomainMap<Domain*> m_inactive_endpoints {};
 
     // Stem domain to segments to grow out
-    unordered_map<Domain*, vector<int>> m_stemd_to_segs {};
+    DomainMap<pair<int, int>> m_stemd_to_segs {};
 };
 } // namespace topConstraintPoints
 
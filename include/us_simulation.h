@@ -40,6 +40,7 @@ using orderParams::SystemOrderParams;
 using origami::OrigamiSystem;
 using parser::InputParameters;
 using simulation::GCMCSimulation;
+using simulation::use_replica_streams;
 
 using GridPoint = vector<int>;
 using SetOfGridPoints = set<GridPoint>;
@@ -52,6 +52,7 @@ class VectorThree {
     bool operator!=(const VectorThree& v_2) const;
 
     int& operator[](const size_t& i) { return m_container[i]; };
+    const int& operator[](const size_t& i) const { return m_container[i]; };
     const int& at(const size_t& i) const { return m_container.at(i); };
 
     VectorThree rotate_half(VectorThree axis);
@@ -180,6 +181,32 @@ void split(const string& s, char delim, Out result);
 
 vector<string> split(const string& s, char delim);
 
+/**
+ * Map a whole file read only
+ *
+ * Every process that maps the same file reads the same pages of the page
+ * cache. The mapping is removed with the last copy of the pointer, which is
+ * empty if the file could not be mapped.
+ */
+std::shared_ptr<const char> map_file(const string& filename, size_t& file_size);
+
+/**
+ * Exclusive lock on a file, held for the lifetime of the object
+ *
+ * Lets one of the processes that share a file build it while the others
+ * wait. If the lock file cannot be created no lock is taken.
+ */
+class FileLock {
+  public:
+    FileLock(const string& filename);
+    ~FileLock();
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+  private:
+    int m_fd;
+};
+
 class Fraction {
   public:
     Fraction(string unparsed_fraction);
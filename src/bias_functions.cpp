@@ -294,7 +294,7 @@ SystemBiases::SystemBiases(
 
     // Setup dependency table
     vector<pair<int, int>> keys {};
-    for (auto chain: origami.get_chains()) {
+    for (auto& chain: origami.get_chains()) {
         for (auto domain: chain) {
             pair<int, int> key {domain->m_c, domain->m_d};
             m_domain_update_biases[key] = {};
@@ -63,63 +63,48 @@ void CBMCMovetype::calc_biases(
         configsT& configs,
         vector<double>& bfactors) {
 
-    // Iterate through all possible new positions
-    for (auto v: utility::vectors) {
-
-        // Trial position vector
-        VectorThree p_new {p_prev + v};
-
-        // Check energies of each configuration
-        switch (m_origami_system.position_occupancy(p_new)) {
+    // Evaluate all possible new positions together
+    m_origami_system.evaluate_neighbour_trials(domain, p_prev, m_trials);
+    for (auto& trial: m_trials) {
+        switch (trial.occupancy) {
         case Occupancy::bound:
         case Occupancy::misbound:
             continue;
-        case Occupancy::unbound: {
-            Domain* unbound_domain {m_origami_system.unbound_domain_at(p_new)};
-            VectorThree o_new;
-            double bfactor {1};
-            o_new = -unbound_domain->m_ore;
-            double delta_e {m_origami_system.check_domain_constraints(
-                    domain, p_new, o_new)};
-            if (not m_origami_system.m_constraints_violated) {
-                configs.push_back({p_new, o_new});
-                bfactor *= exp(-delta_e);
-                bfactors.push_back(bfactor);
-            }
-            else {
-                m_origami_system.m_constraints_violated = false;
+        case Occupancy::unbound:
+            if (not trial.result.constraints_violated) {
+                configs.push_back({trial.pos, trial.ore});
+                bfactors.push_back(exp(-trial.result.e));
             }
             break;
-        }
         case Occupancy::unassigned:
-            configs.push_back({p_new, {0, 0, 0}});
+            configs.push_back({trial.pos, {0, 0, 0}});
 
             // Biases can be position dependent, but will be orientation
             // independent
-            double delta_e {m_origami_system.check_domain_constraints(
-                    domain, p_new, {1, 0, 0})};
-            bfactors.push_back(6 * exp(-delta_e));
+            bfactors.push_back(6 * exp(-trial.result.e));
         }
     }
 }
 
-void CBMCMovetype::select_and_set_config(const int i, vector<Domain*> domains) {
+void CBMCMovetype::select_and_set_config(
+        const int i,
+        const vector<Domain*>& domains) {
 
     Domain* domain {domains[i]};
     Domain* prev_domain {domains[i - 1]};
-    VectorThree p_prev {prev_domain->m_pos};
+    VectorThree p_prev {prev_domain->pos()};
 
     // Calculate weights
-    vector<pair<VectorThree, VectorThree>> configs {};
-    vector<double> bfactors {};
-    calc_biases(p_prev, *domain, configs, bfactors);
-    vector<double> weights {calc_bias(bfactors, configs, domain)};
+    m_configs.clear();
+    m_bfactors.clear();
+    calc_biases(p_prev, *domain, m_configs, m_bfactors);
+    calc_bias(m_bfactors, m_configs, domain, m_weights);
     if (m_rejected) {
         return;
     }
 
     if (not m_regrow_old) {
-        select_and_set_new_config(weights, configs, *domain);
+        select_and_set_new_config(m_weights, m_configs, *domain);
     }
     else {
         select_and_set_old_config(*domain);
@@ -132,8 +117,8 @@ void CBMCMovetype::select_and_set_config(const int i, vector<Domain*> domains) {
 }
 
 void CBMCMovetype::select_and_set_new_config(
-        const vector<double> weights,
-        const configsT configs,
+        const vector<double>& weights,
+        const configsT& configs,
         Domain& domain) {
 
     // Select config based on weights
@@ -161,9 +146,8 @@ void CBMCMovetype::select_and_set_new_config(
 }
 
 void CBMCMovetype::select_and_set_old_config(Domain& domain) {
-    pair<int, int> key {domain.m_c, domain.m_d};
-    VectorThree p_old {m_old_pos[key]};
-    VectorThree o_old {m_old_ore[key]};
+    VectorThree p_old {m_old_configs.pos(domain)};
+    VectorThree o_old {m_old_configs.ore(domain)};
     m_origami_system.set_checked_domain_config(domain, p_old, o_old);
 }
 
@@ -171,10 +155,10 @@ double CBMCMovetype::set_old_growth_point(
         Domain& growth_domain_new,
         Domain& growth_domain_old) {
     pair<int, int> key {growth_domain_new.m_c, growth_domain_new.m_d};
-    VectorThree o_old {m_old_ore[key]};
+    VectorThree o_old {m_old_configs.ore(growth_domain_new)};
     double delta_e {0};
     delta_e += m_origami_system.set_checked_domain_config(
-            growth_domain_new, growth_domain_old.m_pos, o_old);
+            growth_domain_new, growth_domain_old.pos(), o_old);
     m_bias *= exp(-delta_e);
     m_assigned_domains.push_back(key);
 
@@ -185,7 +169,7 @@ bool CBMCMovetype::test_cb_acceptance() {
     long double ratio {m_new_bias / m_bias};
     bool accepted;
     if (test_acceptance(ratio)) {
-        reset_origami();
+        replay_prev_configs();
         m_ops.update_move_params();
         m_biases.calc_move();
         accepted = true;
@@ -199,12 +183,11 @@ bool CBMCMovetype::test_cb_acceptance() {
     return accepted;
 }
 
-double CBMCMovetype::unassign_domains(vector<Domain*> domains) {
+double CBMCMovetype::unassign_domains(const vector<Domain*>& domains) {
     double delta_e {0};
     for (auto domain: domains) {
         pair<int, int> key {domain->m_c, domain->m_d};
-        m_prev_pos[key] = domain->m_pos;
-        m_prev_ore[key] = domain->m_ore;
+        m_prev_configs.save(*domain);
         m_modified_domains.push_back(key);
 
         delta_e += m_origami_system.unassign_domain(*domain);
@@ -222,8 +205,7 @@ void CBMCMovetype::setup_for_regrow_old() {
     m_bias = 1;
     m_modified_domains.clear();
     m_assigned_domains.clear();
-    m_old_pos = m_prev_pos;
-    m_old_ore = m_prev_ore;
+    m_old_configs = m_prev_configs;
 }
 
 CBStapleRegrowthMCMovetype::CBStapleRegrowthMCMovetype(
@@ -307,7 +289,8 @@ bool CBStapleRegrowthMCMovetype::internal_attempt_move() {
     // Select a staple to regrow
     int c_i_index {
             m_random_gens.uniform_int(1, m_origami_system.num_staples())};
-    vector<Domain*> selected_chain {m_origami_system.get_chains()[c_i_index]};
+    const vector<Domain*>& selected_chain {
+            m_origami_system.get_chains()[c_i_index]};
     m_tracker.staple_type = selected_chain[0]->m_c_ident;
 
     // Reject if staple is connector
@@ -316,9 +299,9 @@ bool CBStapleRegrowthMCMovetype::internal_attempt_move() {
     }
 
     // Select growth points on chains
-    auto bound_domains = find_bound_domains(selected_chain);
-    m_bias *= bound_domains.size();
-    domainPairT growthpoint {select_old_growthpoint(bound_domains)};
+    find_bound_domains(selected_chain, m_bound_domains);
+    m_bias *= m_bound_domains.size();
+    domainPairT growthpoint {select_old_growthpoint(m_bound_domains)};
     unassign_domains(selected_chain);
 
     // Grow staple
@@ -334,7 +317,7 @@ bool CBStapleRegrowthMCMovetype::internal_attempt_move() {
     setup_for_regrow_old();
 
     // Select growth point from previously bound domains
-    growthpoint = select_old_growthpoint(bound_domains);
+    growthpoint = select_old_growthpoint(m_bound_domains);
 
     // Unassign and add to reversion list
     unassign_domains(selected_chain);
@@ -353,7 +336,7 @@ void CBStapleRegrowthMCMovetype::add_tracker(bool accepted) {
     movetypes::add_tracker(m_tracker, m_tracking, accepted);
 }
 
-void CBStapleRegrowthMCMovetype::grow_chain(vector<Domain*> domains) {
+void CBStapleRegrowthMCMovetype::grow_chain(const vector<Domain*>& domains) {
     for (size_t i {1}; i != domains.size(); i++) {
         select_and_set_config(i, domains);
         if (m_rejected) {
@@ -362,17 +345,18 @@ void CBStapleRegrowthMCMovetype::grow_chain(vector<Domain*> domains) {
     }
 }
 
-vector<double> CBStapleRegrowthMCMovetype::calc_bias(
-        const vector<double> bfactors,
+void CBStapleRegrowthMCMovetype::calc_bias(
+        const vector<double>& bfactors,
         const configsT&,
-        Domain*) {
+        Domain*,
+        vector<double>& weights) {
 
     // Calculate rosenbluth weight
     double rosenbluth_i {0};
     for (auto bfactor: bfactors) {
         rosenbluth_i += bfactor;
     }
-    vector<double> weights {};
+    weights.clear();
     if (rosenbluth_i == 0) {
 
         // Deadend
@@ -384,13 +368,11 @@ vector<double> CBStapleRegrowthMCMovetype::calc_bias(
             weights.push_back(bfactor / rosenbluth_i);
         }
     }
-
-    return weights;
 }
 
 void CBStapleRegrowthMCMovetype::set_growthpoint_and_grow_staple(
         domainPairT growthpoint,
-        vector<Domain*> selected_chain) {
+        const vector<Domain*>& selected_chain) {
 
     if (m_regrow_old) {
         set_old_growth_point(*growthpoint.first, *growthpoint.second);
@@ -462,7 +444,7 @@ void CTCBRegrowthMCMovetype::reset_internal() {
     CTRegrowthMCMovetype::reset_internal();
 }
 
-void CTCBRegrowthMCMovetype::grow_chain(vector<Domain*> domains) {
+void CTCBRegrowthMCMovetype::grow_chain(const vector<Domain*>& domains) {
     if (domains.size() <= 1) {
         return;
     }
@@ -485,12 +467,13 @@ void CTCBRegrowthMCMovetype::grow_chain(vector<Domain*> domains) {
     }
 }
 
-vector<double> CTCBRegrowthMCMovetype::calc_bias(
-        const vector<double> bfactors,
+void CTCBRegrowthMCMovetype::calc_bias(
+        const vector<double>& bfactors,
         const vector<pair<VectorThree, VectorThree>>& configs,
-        Domain* domain) {
+        Domain* domain,
+        vector<double>& weights) {
 
-    vector<long double> weights(bfactors.begin(), bfactors.end());
+    weights.assign(bfactors.begin(), bfactors.end());
     for (size_t i {0}; i != configs.size(); i++) {
         VectorThree cur_pos {configs[i].first};
 
@@ -523,21 +506,18 @@ vector<double> CTCBRegrowthMCMovetype::calc_bias(
     }
 
     // Check for deadend
-    vector<double> norm_weights {};
     if (weights_sum == 0) {
         m_rejected = true;
+        weights.clear();
     }
     else {
         m_bias *= weights_sum;
 
         // Normalize
         for (size_t i {0}; i != weights.size(); i++) {
-            double norm_weight = static_cast<double>(weights[i] / weights_sum);
-            norm_weights.push_back(norm_weight);
+            weights[i] = static_cast<double>(weights[i] / weights_sum);
         }
     }
-
-    return norm_weights;
 }
 
 void CTCBRegrowthMCMovetype::grow_staple_and_update_endpoints(
@@ -558,7 +538,7 @@ void CTCBRegrowthMCMovetype::grow_staple_and_update_endpoints(
     }
     if (not m_rejected) {
         m_constraintpoints.update_endpoints(growth_d_new);
-        vector<Domain*> staple {m_origami_system.get_chain(c_i)};
+        const vector<Domain*>& staple {m_origami_system.get_chain(c_i)};
         grow_staple(growth_d_new->m_d, staple);
     }
 }
@@ -683,35 +663,34 @@ bool CTCBScaffoldRegrowthMCMovetype::internal_attempt_move() {
     bool accepted {false};
 
     m_regrow_old = false;
-    vector<Domain*> scaffold_domains {select_indices(m_scaffold, 2)};
-    m_tracker.num_scaffold_domains = scaffold_domains.size();
+    select_indices(m_scaffold, m_sel_scaf_doms, 2);
+    m_tracker.num_scaffold_domains = m_sel_scaf_doms.size();
     sel_excluded_staples();
 
     m_constraintpoints.calculate_constraintpoints(
-            scaffold_domains, m_dir, m_excluded_staples);
+            m_sel_scaf_doms, m_dir, m_excluded_staples);
     if (not(m_origami_system.m_cyclic and
-            scaffold_domains.size() == m_origami_system.get_chain(0).size())) {
-        m_constraintpoints.remove_active_endpoint(scaffold_domains[0]);
+            m_sel_scaf_doms.size() == m_origami_system.get_chain(0).size())) {
+        m_constraintpoints.remove_active_endpoint(m_sel_scaf_doms[0]);
     }
-    set<int> staples {m_constraintpoints.staples_to_be_regrown()};
-    m_tracker.num_staples = staples.size();
+    m_constraintpoints.staples_to_be_regrown(m_regrow_staples);
+    m_tracker.num_staples = m_regrow_staples.size();
 
     // Unassign domains to be regrown
-    vector<Domain*> scaffold_domains_to_unassign(
-            scaffold_domains.begin() + 1, scaffold_domains.end());
-    unassign_domains(scaffold_domains_to_unassign);
-    for (auto c_i: staples) {
+    m_unassign_ds.assign(m_sel_scaf_doms.begin() + 1, m_sel_scaf_doms.end());
+    unassign_domains(m_unassign_ds);
+    for (auto c_i: m_regrow_staples) {
         unassign_domains(m_origami_system.get_chain(c_i));
     }
 
     // Grow scaffold and staples
-    if (m_constraintpoints.is_growthpoint(scaffold_domains[0])) {
-        grow_staple_and_update_endpoints(scaffold_domains[0]);
+    if (m_constraintpoints.is_growthpoint(m_sel_scaf_doms[0])) {
+        grow_staple_and_update_endpoints(m_sel_scaf_doms[0]);
         if (m_rejected) {
             return accepted;
         }
     }
-    grow_chain(scaffold_domains);
+    grow_chain(m_sel_scaf_doms);
 
     // Check if excluded staples have become unbound
     bool bound_to_system {excluded_staples_bound()};
@@ -724,22 +703,22 @@ bool CTCBScaffoldRegrowthMCMovetype::internal_attempt_move() {
     setup_for_regrow_old();
     m_constraintpoints.reset_active_endpoints();
     if (not(m_origami_system.m_cyclic and
-            scaffold_domains.size() == m_origami_system.get_chain(0).size())) {
-        m_constraintpoints.remove_active_endpoint(scaffold_domains[0]);
+            m_sel_scaf_doms.size() == m_origami_system.get_chain(0).size())) {
+        m_constraintpoints.remove_active_endpoint(m_sel_scaf_doms[0]);
     }
 
     // Unassign staples except those bound/linked to external scaffold
-    unassign_domains(scaffold_domains_to_unassign);
-    for (auto c_i: staples) {
+    unassign_domains(m_unassign_ds);
+    for (auto c_i: m_regrow_staples) {
         unassign_domains(m_origami_system.get_chain(c_i));
     }
 
     // Grow scaffold and staples
-    if (m_constraintpoints.is_growthpoint(scaffold_domains[0])) {
-        grow_staple_and_update_endpoints(scaffold_domains[0]);
+    if (m_constraintpoints.is_growthpoint(m_sel_scaf_doms[0])) {
+        grow_staple_and_update_endpoints(m_sel_scaf_doms[0]);
     }
 
-    grow_chain(scaffold_domains);
+    grow_chain(m_sel_scaf_doms);
 
     // Reset modifier and test acceptance
     m_modifier = 1;
@@ -876,49 +855,54 @@ bool CTCBJumpScaffoldRegrowthMCMovetype::internal_attempt_move() {
 
     // Select scaffold segments and excluded staples
     m_regrow_old = false;
-    vector<vector<Domain*>> segs {};
-    vector<vector<vector<Domain*>>> paired_segs {};
-    vector<Domain*> seg_stems {};
-    vector<int> dirs {};
-    select_noncontig_segs(m_scaffold, segs, paired_segs, seg_stems, dirs);
+    select_noncontig_segs(m_scaffold);
     m_tracker.num_scaffold_domains = 0;
     sel_excluded_staples();
 
     m_constraintpoints.calculate_constraintpoints(
-            segs, dirs, m_excluded_staples);
-    m_constraintpoints.remove_active_endpoint(segs[0][0]);
-    set<int> staples {m_constraintpoints.staples_to_be_regrown()};
-    m_tracker.num_staples = staples.size();
-    vector<Domain*> regrow_domains {m_constraintpoints.domains_to_be_regrown()};
+            m_segs, m_seg_dirs, m_excluded_staples);
+    m_constraintpoints.remove_active_endpoint(m_segs[0][0]);
+    m_constraintpoints.staples_to_be_regrown(m_regrow_staples);
+    m_tracker.num_staples = m_regrow_staples.size();
+    const vector<Domain*>& regrow_domains {
+            m_constraintpoints.domains_to_be_regrown()};
 
     // Unassign domains to be regrown
-    vector<Domain*> domains_to_unassign(
-            regrow_domains.begin() + 1, regrow_domains.end());
-    unassign_domains(domains_to_unassign);
+    m_unassign_ds.assign(regrow_domains.begin() + 1, regrow_domains.end());
+    unassign_domains(m_unassign_ds);
 
     // Grow scaffold and staples
-    if (m_constraintpoints.is_growthpoint(segs[0][0])) {
-        grow_staple_and_update_endpoints(segs[0][0]);
+    if (m_constraintpoints.is_growthpoint(m_segs[0][0])) {
+        grow_staple_and_update_endpoints(m_segs[0][0]);
         if (m_rejected) {
             return accepted;
         }
     }
-    grow_chain(segs[0]);
+    grow_chain(m_segs[0]);
     if (m_rejected) {
         return accepted;
     }
-    for (size_t i {0}; i != seg_stems.size(); i++) {
-        Domain* seg_stem {seg_stems[i]};
+    for (size_t i {0}; i != m_seg_stems.size(); i++) {
+        Domain* seg_stem {m_seg_stems[i]};
         set_first_seg_domain(seg_stem);
         if (m_rejected) {
             return accepted;
         }
-        for (auto seg: paired_segs[i]) {
-            seg.insert(seg.begin(), seg_stem);
-            grow_chain(seg);
-            if (m_rejected) {
-                return accepted;
-            }
+
+        // Both segments of the pair grow out from the stem, which already
+        // heads the first
+        grow_chain(m_segs[2 * i + 1]);
+        if (m_rejected) {
+            return accepted;
+        }
+        m_stem_seg.assign(1, seg_stem);
+        m_stem_seg.insert(
+                m_stem_seg.end(),
+                m_segs[2 * i + 2].begin(),
+                m_segs[2 * i + 2].end());
+        grow_chain(m_stem_seg);
+        if (m_rejected) {
+            return accepted;
         }
     }
 
@@ -932,32 +916,41 @@ bool CTCBJumpScaffoldRegrowthMCMovetype::internal_attempt_move() {
     // Regrow in old conformation
     setup_for_regrow_old();
     m_constraintpoints.reset_active_endpoints();
-    m_constraintpoints.remove_active_endpoint(segs[0][0]);
-    unassign_domains(domains_to_unassign);
+    m_constraintpoints.remove_active_endpoint(m_segs[0][0]);
+    unassign_domains(m_unassign_ds);
 
     // Grow scaffold and staples
-    if (m_constraintpoints.is_growthpoint(segs[0][0])) {
-        grow_staple_and_update_endpoints(segs[0][0]);
+    if (m_constraintpoints.is_growthpoint(m_segs[0][0])) {
+        grow_staple_and_update_endpoints(m_segs[0][0]);
         if (m_rejected) {
             return accepted;
         }
     }
-    grow_chain(segs[0]);
+    grow_chain(m_segs[0]);
     if (m_rejected) {
         return accepted;
     }
-    for (size_t i {0}; i != seg_stems.size(); i++) {
-        Domain* seg_stem {seg_stems[i]};
+    for (size_t i {0}; i != m_seg_stems.size(); i++) {
+        Domain* seg_stem {m_seg_stems[i]};
         set_first_seg_domain(seg_stem);
         if (m_rejected) {
             return accepted;
         }
-        for (auto seg: paired_segs[i]) {
-            seg.insert(seg.begin(), seg_stem);
-            grow_chain(seg);
-            if (m_rejected) {
-                return accepted;
-            }
+
+        // Both segments of the pair grow out from the stem, which already
+        // heads the first
+        grow_chain(m_segs[2 * i + 1]);
+        if (m_rejected) {
+            return accepted;
+        }
+        m_stem_seg.assign(1, seg_stem);
+        m_stem_seg.insert(
+                m_stem_seg.end(),
+                m_segs[2 * i + 2].begin(),
+                m_segs[2 * i + 2].end());
+        grow_chain(m_stem_seg);
+        if (m_rejected) {
+            return accepted;
         }
     }
 
@@ -975,7 +968,7 @@ void CTCBJumpScaffoldRegrowthMCMovetype::add_tracker(bool accepted) {
 void CTCBJumpScaffoldRegrowthMCMovetype::set_first_seg_domain(Domain* d_new) {
 
     Domain* d_old {m_constraintpoints.get_growthpoint(d_new)};
-    if (not m_constraintpoints.walks_remain(d_new, d_old->m_pos)) {
+    if (not m_constraintpoints.walks_remain(d_new, d_old->pos())) {
         m_rejected = true;
         return;
     }
@@ -0,0 +1,121 @@
+// domain_pool.cpp
+
+#include <iostream>
+#include <new>
+
+#include "domain_pool.h"
+
+namespace domainContainer {
+
+using std::cout;
+
+using utility::OrigamiMisuse;
+
+DomainPool::DomainPool(
+        string domain_type,
+        const vector<vector<int>>& identities):
+        m_domain_type {domain_type},
+        m_identities {identities},
+        m_free_chains(identities.size()) {}
+
+DomainPool::~DomainPool() {
+    for (auto& slab: m_slabs) {
+        for (int i {0}; i != slab->size; i++) {
+            slab->domains[i]->~Domain();
+        }
+    }
+}
+
+vector<Domain*> DomainPool::checkout_chain(int c_i, int c_i_ident) {
+    vector<vector<Domain*>>& free_chains {m_free_chains[c_i_ident]};
+    if (not free_chains.empty()) {
+        vector<Domain*> chain {std::move(free_chains.back())};
+        free_chains.pop_back();
+        for (auto domain: chain) {
+            domain->m_c = c_i;
+            domain->pos() = {};
+            domain->ore() = {};
+        }
+
+        return chain;
+    }
+
+    int chain_length {static_cast<int>(m_identities[c_i_ident].size())};
+    vector<Domain*> chain {};
+    chain.reserve(chain_length);
+    Domain* prev_domain {nullptr};
+    for (int d_i {0}; d_i != chain_length; d_i++) {
+        int d_i_ident {m_identities[c_i_ident][d_i]};
+        Domain* domain {construct_domain(
+                c_i, c_i_ident, d_i, d_i_ident, chain_length)};
+
+        // Set forward and backwards domains
+        if (prev_domain != nullptr) {
+            prev_domain->m_forward_domain = domain;
+        }
+
+        domain->m_backward_domain = prev_domain;
+        domain->m_forward_domain = nullptr;
+
+        chain.push_back(domain);
+        prev_domain = domain;
+    }
+
+    return chain;
+}
+
+void DomainPool::return_chain(vector<Domain*>& chain) {
+
+    // Stale states would be picked up by passes over the slabs
+    for (auto domain: chain) {
+        if (domain->state() != Occupancy::unassigned) {
+            cout << "Returned chain has assigned domains\n";
+            throw OrigamiMisuse {};
+        }
+    }
+    int c_i_ident {chain[0]->m_c_ident};
+    m_free_chains[c_i_ident].push_back(std::move(chain));
+}
+
+const vector<unique_ptr<DomainPool::Slab>>& DomainPool::slabs() const {
+    return m_slabs;
+}
+
+Domain* DomainPool::construct_domain(
+        int c_i,
+        int c_i_ident,
+        int d_i,
+        int d_i_ident,
+        int chain_length) {
+
+    if (m_slabs.empty() or m_slabs.back()->size == c_slab_size) {
+        m_slabs.emplace_back(new Slab);
+    }
+    Slab& slab {*m_slabs.back()};
+    int i {slab.size};
+    int id {static_cast<int>(m_slabs.size() - 1) * c_slab_size + i};
+    slab.positions[i] = {};
+    slab.orientations[i] = {};
+    slab.states[i] = Occupancy::unassigned;
+    slab.bound_domains[i] = nullptr;
+
+    Domain* domain;
+    if (m_domain_type == "HalfTurn") {
+        domain = new (&slab.slots[i]) HalfTurnDomain {
+                c_i, c_i_ident, d_i, d_i_ident, chain_length, id, &slab};
+    }
+    else if (m_domain_type == "ThreeQuarterTurn") {
+        domain = new (&slab.slots[i]) ThreeQuarterTurnDomain {
+                c_i, c_i_ident, d_i, d_i_ident, chain_length, id, &slab};
+    }
+    else {
+        cout << "Unknown domain type " << m_domain_type << "\n";
+        throw OrigamiMisuse {};
+    }
+    slab.domains[i] = domain;
+    slab.size++;
+
+    return domain;
+}
+
+} // namespace domainContainer
@@ -87,20 +87,20 @@ double MisbindingOnlyOvercountCalculator::calc_multiplier(
     double multiplier {1};
     Domain* next_domain {staple_domain->m_forward_domain};
     while (next_domain != nullptr) {
-        if (next_domain->m_state == Occupancy::bound) {
+        if (next_domain->state() == Occupancy::bound) {
             multiplier++;
         }
-        else if (next_domain->m_state == Occupancy::unassigned) {
+        else if (next_domain->state() == Occupancy::unassigned) {
             return 1;
         }
         next_domain = next_domain->m_forward_domain;
     }
     next_domain = staple_domain->m_backward_domain;
     while (next_domain != nullptr) {
-        if (next_domain->m_state == Occupancy::bound) {
+        if (next_domain->state() == Occupancy::bound) {
             multiplier++;
         }
-        else if (next_domain->m_state == Occupancy::unassigned) {
+        else if (next_domain->state() == Occupancy::unassigned) {
             return 1;
         }
         next_domain = next_domain->m_backward_domain;
@@ -147,7 +147,7 @@ int MaxTwoDomainOvercountCalculator::count_involved_staples(Domain* domain) {
         else {
             next_domain = next_domain->m_forward_domain;
         }
-        next_domain = next_domain->m_bound_domain;
+        next_domain = next_domain->bound_domain();
         if (next_domain->m_c == 0) {
             domain_on_scaffold = true;
         }
@@ -417,7 +417,7 @@ void ConformationalEnumerator::set_growthpoint_domains(
     // Store position for domains that are not terminal
     bool domain_is_terminal {false};
     if (domain->m_forward_domain != nullptr and
-        domain->m_forward_domain->m_state == Occupancy::unassigned) {
+        domain->m_forward_domain->state() == Occupancy::unassigned) {
         if (domain->m_backward_domain != nullptr) {
             domain_is_terminal = true;
         }
@@ -501,7 +501,7 @@ void ConformationalEnumerator::set_bound_domain(
         VectorThree p_new) {
 
     Domain* occ_domain = m_origami_system.unbound_domain_at(p_new);
-    VectorThree o_new {-occ_domain->m_ore};
+    VectorThree o_new {-occ_domain->ore()};
     m_energy += m_origami_system.set_domain_config(*domain, p_new, o_new);
     if (m_origami_system.m_constraints_violated == true) {
         m_origami_system.m_constraints_violated = false;
@@ -575,8 +575,8 @@ void ConformationalEnumerator::grow_next_domain(
     // Save relevant values if system fully grown
     else {
         if (m_origami_system.m_cyclic) {
-            vector<Domain*> scaffold {m_origami_system.get_chain(0)};
-            VectorThree dist {scaffold.front()->m_pos - scaffold.back()->m_pos};
+            const vector<Domain*>& scaffold {m_origami_system.get_chain(0)};
+            VectorThree dist {scaffold.front()->pos() - scaffold.back()->pos()};
             if (dist.abssum() == 1) {
                 calc_and_save_weights();
             }
@@ -608,7 +608,7 @@ void ConformationalEnumerator::create_domains_stack() {
 }
 
 void ConformationalEnumerator::create_staple_stack(Domain* domain) {
-    vector<Domain*> staple {m_origami_system.get_chain(domain->m_c)};
+    const vector<Domain*>& staple {m_origami_system.get_chain(domain->m_c)};
     m_domains.push_back(domain);
 
     // Iterate through domains in three prime direction
@@ -680,7 +680,7 @@ StapleConformationalEnumerator::StapleConformationalEnumerator(
 
     // Reassign scaffold domains
     for (auto d: m_origami_system.get_chain(0)) {
-        m_origami_system.set_domain_config(*d, d->m_pos, d->m_ore);
+        m_origami_system.set_domain_config(*d, d->pos(), d->ore());
     }
 }
 
@@ -694,8 +694,8 @@ void StapleConformationalEnumerator::enumerate() {
     Domain* starting_domain {m_domains.back()};
     m_domains.pop_back();
 
-    VectorThree p_new {m_inverse_growthpoints[starting_domain]->m_pos};
-    VectorThree o_new {-m_inverse_growthpoints[starting_domain]->m_ore};
+    VectorThree p_new {m_inverse_growthpoints[starting_domain]->pos()};
+    VectorThree o_new {-m_inverse_growthpoints[starting_domain]->ore()};
     m_energy +=
             m_origami_system.set_domain_config(*starting_domain, p_new, o_new);
     if (m_domains.size() != 0) {
@@ -753,8 +753,8 @@ void StapleConformationalEnumerator::grow_next_domain(
 
 void StapleConformationalEnumerator::grow_off_scaffold(Domain* next_domain) {
 
-    VectorThree p_new {m_inverse_growthpoints[next_domain]->m_pos};
-    VectorThree o_new {-m_inverse_growthpoints[next_domain]->m_ore};
+    VectorThree p_new {m_inverse_growthpoints[next_domain]->pos()};
+    VectorThree o_new {-m_inverse_growthpoints[next_domain]->ore()};
     m_energy += m_origami_system.set_domain_config(*next_domain, p_new, o_new);
     if (m_origami_system.m_constraints_violated == true) {
         m_origami_system.m_constraints_violated = false;
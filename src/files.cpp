@@ -14,6 +14,7 @@ using std::cout;
 using std::ifstream;
 using std::vector;
 
+using domainContainer::Domain;
 using utility::FileMisuse;
 using utility::Occupancy;
 using utility::VectorThree;
@@ -481,17 +482,18 @@ void OrigamiVSFOutputFile::write(long int, double) {
 
 void OrigamiTrajOutputFile::write(long int step, double) {
     m_file << step << "\n";
-    for (auto chain: m_origami_system.get_chains()) {
+    for (auto c_i: m_origami_system.ordered_chain_indices()) {
+        const vector<Domain*>& chain {m_origami_system.get_chain(c_i)};
         m_file << chain[0]->m_c << " " << chain[0]->m_c_ident << "\n";
         for (auto domain: chain) {
             for (int i {0}; i != 3; i++) {
-                m_file << domain->m_pos[i] << " ";
+                m_file << domain->pos()[i] << " ";
             }
         }
         m_file << "\n";
         for (auto domain: chain) {
             for (int i {0}; i != 3; i++) {
-                m_file << domain->m_ore[i] << " ";
+                m_file << domain->ore()[i] << " ";
             }
         }
         m_file << "\n";
@@ -503,12 +505,13 @@ void OrigamiTrajOutputFile::write(long int step, double) {
 void OrigamiVCFOutputFile::write(long int, double) {
     m_file << "timestep\n";
     int num_written_domains {0};
-    for (auto chain: m_origami_system.get_chains()) {
+    for (auto c_i: m_origami_system.ordered_chain_indices()) {
+        const vector<Domain*>& chain {m_origami_system.get_chain(c_i)};
         int num_domains {0};
         for (auto domain: chain) {
             num_domains++;
             for (int i {0}; i != 3; i++) {
-                m_file << domain->m_pos[i] << " ";
+                m_file << domain->pos()[i] << " ";
             }
             m_file << "\n";
         }
@@ -534,13 +537,14 @@ void OrigamiVCFOutputFile::write(long int, double) {
 
 void OrigamiOrientationOutputFile::write(long int, double) {
     int num_written_domains {0};
-    for (auto chain: m_origami_system.get_chains()) {
+    for (auto c_i: m_origami_system.ordered_chain_indices()) {
+        const vector<Domain*>& chain {m_origami_system.get_chain(c_i)};
         int num_domains {0};
         for (auto domain: chain) {
             num_domains++;
             for (int i {0}; i != 3; i++) {
-                if (domain->m_state != Occupancy::unassigned) {
-                    m_file << domain->m_ore[i] << " ";
+                if (domain->state() != Occupancy::unassigned) {
+                    m_file << domain->ore()[i] << " ";
                 }
                 else {
                     m_file << 0 << " ";
@@ -566,17 +570,18 @@ void OrigamiOrientationOutputFile::write(long int, double) {
 
 void OrigamiStateOutputFile::write(long int, double) {
     int num_written_domains {0};
-    for (auto chain: m_origami_system.get_chains()) {
+    for (auto c_i: m_origami_system.ordered_chain_indices()) {
+        const vector<Domain*>& chain {m_origami_system.get_chain(c_i)};
         int num_domains {0};
         for (auto domain: chain) {
             num_domains++;
-            if (domain->m_state == Occupancy::unbound) {
+            if (domain->state() == Occupancy::unbound) {
                 m_file << "1 ";
             }
-            else if (domain->m_state == Occupancy::bound) {
+            else if (domain->state() == Occupancy::bound) {
                 m_file << "2 ";
             }
-            else if (domain->m_state == Occupancy::misbound) {
+            else if (domain->state() == Occupancy::misbound) {
                 m_file << "3 ";
             }
             else {
@@ -610,8 +615,10 @@ void OrigamiCountsOutputFile::write(long int step, double) {
 
 void OrigamiStaplesBoundOutputFile::write(long int step, double) {
     m_file << step << " ";
-    for (auto staple_count: m_origami_system.get_staple_counts()) {
-        m_file << staple_count << " ";
+    for (size_t staple_ident {1};
+         staple_ident != m_origami_system.m_identities.size();
+         staple_ident++) {
+        m_file << m_origami_system.staple_stats(staple_ident).copies << " ";
     }
     m_file << "\n";
     m_file.flush();
@@ -622,20 +629,9 @@ void OrigamiStaplesFullyBoundOutputFile::write(long int step, double) {
     for (size_t staple_ident {1};
          staple_ident != m_origami_system.m_identities.size();
          staple_ident++) {
-        int staple_state {0};
-        for (auto staple_i: m_origami_system.staples_of_ident(staple_ident)) {
-            bool fully_bound {true};
-            for (auto domain: m_origami_system.get_chain(staple_i)) {
-                if (domain->m_state != Occupancy::bound) {
-                    fully_bound = false;
-                    break;
-                }
-            }
-            if (fully_bound) {
-                staple_state = 1;
-                break;
-            }
-        }
+        const StapleStats& stats {
+                m_origami_system.staple_stats(staple_ident)};
+        int staple_state {stats.fully_bound_copies > 0};
         m_file << staple_state << " ";
     }
     m_file << "\n";
@@ -664,7 +660,6 @@ OrigamiEnergiesOutputFile::OrigamiEnergiesOutputFile(
 void OrigamiEnergiesOutputFile::write(long int step, double) {
     m_file << step << " ";
     m_file << m_origami_system.energy() << " ";
-    m_origami_system.update_enthalpy_and_entropy();
     m_file << m_origami_system.hybridization_enthalpy() << " ";
     m_file << m_origami_system.hybridization_entropy() << " ";
     m_file << m_origami_system.stacking_energy() << " ";
@@ -740,7 +735,7 @@ RandomEngineStateOutputFile::RandomEngineStateOutputFile(
         OrigamiOutputFile {filename, write_freq, 0, 0, origami_system} {}
 
 void RandomEngineStateOutputFile::write(long int, double) {
-    m_file << m_random_gens.m_random_engine;
+    m_random_gens.write_state(m_file);
     m_file << "\n";
     m_file.flush();
 }
@@ -1,7 +1,16 @@
 // ideal_random_walk.cpp
 
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iostream>
+#include <mutex>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <boost/math/special_functions/factorials.hpp>
 
@@ -9,8 +18,216 @@
 
 namespace idealRandomWalk {
 
+using std::cout;
+
 using boost::math::factorial;
 
+namespace {
+
+// Bumped whenever the layout of walks table files changes
+constexpr uint32_t c_walks_table_version {1};
+constexpr char c_walks_table_magic[8] {'L', 'D', 'O', 'W', 'A', 'L', 'K', 'S'};
+
+// Fixed size start of a walks table file, followed by the slots
+struct WalksTableHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_size;
+    uint64_t num_slots;
+    uint64_t num_entries;
+    uint64_t archive_size;
+    int64_t archive_mtime; // ns
+};
+
+static_assert(
+        std::is_trivially_copyable<WalksTableEntry>::value,
+        "Walks table slots are written to file as raw bytes");
+static_assert(
+        sizeof(WalksTableHeader) % alignof(WalksTableEntry) == 0,
+        "Walks table slots are read in place after the header");
+
+// Archives already loaded in this process, by filename
+std::mutex shared_walks_mutex {};
+unordered_map<string, std::weak_ptr<const WalksTable>> shared_walks {};
+
+// Mixes the whole key, and unlike std::hash is the same between builds
+uint64_t walk_hash(const VectorThree& DR, int steps) {
+    uint64_t hash {static_cast<uint32_t>(steps)};
+    for (int i {0}; i != 3; i++) {
+        hash = hash * 0x9E3779B97F4A7C15ull + static_cast<uint32_t>(DR[i]);
+    }
+    hash ^= hash >> 31;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    hash ^= hash >> 29;
+
+    return hash;
+}
+
+} // namespace
+
+WalksTable::WalksTable(const string& archive_filename) {
+    struct stat archive_stat;
+    if (stat(archive_filename.c_str(), &archive_stat) != 0) {
+        cout << "Could not read walks archive " << archive_filename << "\n";
+        throw utility::FileMisuse {};
+    }
+    m_archive_size = archive_stat.st_size;
+    m_archive_mtime = archive_stat.st_mtim.tv_sec * 1000000000ll +
+                      archive_stat.st_mtim.tv_nsec;
+
+    string table_filename {archive_filename + ".table"};
+    if (map_table(table_filename)) {
+        return;
+    }
+
+    // Processes starting together wait here for the first one to write the
+    // table rather than all reading the archive
+    utility::FileLock lock {table_filename + ".lock"};
+    if (map_table(table_filename)) {
+        return;
+    }
+    IdealRandomWalks archived {};
+    std::ifstream num_walks_file {archive_filename};
+    boost::archive::binary_iarchive num_walks_arch {num_walks_file};
+    num_walks_arch >> archived;
+    build(archived.m_num_walks);
+    if (not write_table(table_filename) or not map_table(table_filename)) {
+        cout << "Could not write walks table " << table_filename << "\n";
+    }
+}
+
+bool WalksTable::find(
+        const pair<VectorThree, int>& walk_key,
+        long double& walks) const {
+
+    const VectorThree& DR {walk_key.first};
+    int steps {walk_key.second};
+    uint64_t mask {m_num_slots - 1};
+    for (uint64_t slot {walk_hash(DR, steps) & mask};;
+         slot = (slot + 1) & mask) {
+        const WalksTableEntry& entry {m_slots[slot]};
+        if (entry.steps < 0) {
+            return false;
+        }
+        if (entry.steps == steps and entry.DR[0] == DR[0] and
+            entry.DR[1] == DR[1] and entry.DR[2] == DR[2]) {
+            walks = entry.walks;
+            return true;
+        }
+    }
+}
+
+bool WalksTable::map_table(const string& filename) {
+    size_t file_size;
+    shared_ptr<const char> mapped {utility::map_file(filename, file_size)};
+    if (not mapped or file_size < sizeof(WalksTableHeader)) {
+        return false;
+    }
+
+    WalksTableHeader header;
+    std::memcpy(&header, mapped.get(), sizeof(header));
+    bool usable {
+            std::memcmp(
+                    header.magic,
+                    c_walks_table_magic,
+                    sizeof(header.magic)) == 0 and
+            header.version == c_walks_table_version and
+            header.entry_size == sizeof(WalksTableEntry) and
+            header.archive_size == m_archive_size and
+            header.archive_mtime == m_archive_mtime and
+            header.num_slots != 0 and
+            (header.num_slots & (header.num_slots - 1)) == 0 and
+            file_size == sizeof(header) +
+                                 header.num_slots * sizeof(WalksTableEntry)};
+    if (not usable) {
+        return false;
+    }
+    m_mapping = mapped;
+    m_slots = reinterpret_cast<const WalksTableEntry*>(
+            mapped.get() + sizeof(header));
+    m_num_slots = header.num_slots;
+    vector<WalksTableEntry> {}.swap(m_entries);
+
+    return true;
+}
+
+bool WalksTable::write_table(const string& filename) const {
+
+    // Written to a unique file and then renamed over the table file, so that
+    // a partial file is never read
+    WalksTableHeader header {};
+    std::memcpy(header.magic, c_walks_table_magic, sizeof(header.magic));
+    header.version = c_walks_table_version;
+    header.entry_size = sizeof(WalksTableEntry);
+    header.num_slots = m_num_slots;
+    header.num_entries = 0;
+    for (auto& entry: m_entries) {
+        header.num_entries += (entry.steps >= 0);
+    }
+    header.archive_size = m_archive_size;
+    header.archive_mtime = m_archive_mtime;
+
+    string temp_filename {filename + ".XXXXXX"};
+    int fd {mkstemp(&temp_filename[0])};
+    if (fd == -1) {
+        return false;
+    }
+    size_t slots_size {m_entries.size() * sizeof(WalksTableEntry)};
+    bool written {
+            fchmod(fd, 0644) == 0 and
+            write(fd, &header, sizeof(header)) ==
+                    static_cast<ssize_t>(sizeof(header)) and
+            write(fd, m_entries.data(), slots_size) ==
+                    static_cast<ssize_t>(slots_size)};
+    written = (close(fd) == 0) and written;
+    if (not written or std::rename(temp_filename.c_str(), filename.c_str()) !=
+                               0) {
+        std::remove(temp_filename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void WalksTable::build(const walksMapT& num_walks) {
+
+    // At most half full, so probes are short and always reach an empty slot
+    m_num_slots = 2;
+    while (m_num_slots < 2 * num_walks.size()) {
+        m_num_slots *= 2;
+    }
+    WalksTableEntry empty_entry {};
+    empty_entry.steps = -1;
+    m_entries.assign(m_num_slots, empty_entry);
+    uint64_t mask {m_num_slots - 1};
+    for (auto& walks: num_walks) {
+        const VectorThree& DR {walks.first.first};
+        int steps {walks.first.second};
+        uint64_t slot {walk_hash(DR, steps) & mask};
+        while (m_entries[slot].steps >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        WalksTableEntry& entry {m_entries[slot]};
+        entry.DR[0] = DR[0];
+        entry.DR[1] = DR[1];
+        entry.DR[2] = DR[2];
+        entry.steps = steps;
+        entry.walks = walks.second;
+    }
+    m_slots = m_entries.data();
+}
+
+void IdealRandomWalks::load_shared(const string& filename) {
+    std::lock_guard<std::mutex> lock {shared_walks_mutex};
+    m_shared_num_walks = shared_walks[filename].lock();
+    if (m_shared_num_walks) {
+        return;
+    }
+
+    m_shared_num_walks = std::make_shared<const WalksTable>(filename);
+    shared_walks[filename] = m_shared_num_walks;
+}
+
 long double IdealRandomWalks::num_walks(
         VectorThree start_pos,
         VectorThree end_pos,
@@ -22,8 +239,14 @@ long double IdealRandomWalks::num_walks(
     // Only work with one permutation of DR
     DR = DR.absolute().sort();
     pair<VectorThree, int> walk_key {DR, steps};
-    if (m_num_walks.count(walk_key)) {
-        return m_num_walks.at(walk_key);
+    long double archived_walks;
+    if (m_shared_num_walks and
+        m_shared_num_walks->find(walk_key, archived_walks)) {
+        return archived_walks;
+    }
+    auto walks_it {m_num_walks.find(walk_key)};
+    if (walks_it != m_num_walks.end()) {
+        return walks_it->second;
     }
     int DX {DR[0]};
     int DY {DR[1]};
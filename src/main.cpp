@@ -20,6 +20,16 @@ int main(int argc, char* argv[]) {
     using std::cout;
 
     parser::InputParameters params {argc, argv};
+
+    // Replicas run as threads each set up their own system
+    if (params.m_replicas_per_rank > 1) {
+        cout << "Git commit hash: " << GIT_COMMIT << "\n";
+        cout << "Running parallel tempering simulation with "
+             << params.m_replicas_per_rank << " replicas per process\n";
+        ptmc::run_threaded_pt(params);
+        return 0;
+    }
+
     origami::OrigamiSystem* origami {origami::setup_origami(params)};
     orderParams::SystemOrderParams& ops {origami->get_system_order_params()};
     biasFunctions::SystemBiases& biases {origami->get_system_biases()};
@@ -47,11 +47,11 @@ void MetMCMovetype::reset_internal() {
     m_delta_e = 0;
 }
 
-void MetMCMovetype::grow_chain(vector<Domain*> domains) {
+void MetMCMovetype::grow_chain(const vector<Domain*>& domains) {
     for (size_t i {1}; i != domains.size(); i++) {
         Domain* domain {domains[i]};
         Domain* prev_domain {domains[i - 1]};
-        VectorThree new_p {select_random_position(prev_domain->m_pos)};
+        VectorThree new_p {select_random_position(prev_domain->pos())};
         VectorThree new_o {select_random_orientation()};
         m_delta_e += m_origami_system.set_domain_config(*domain, new_p, new_o);
         if (m_origami_system.m_constraints_violated) {
@@ -74,11 +74,10 @@ void MetMCMovetype::add_external_bias() {
     return;
 }
 
-void MetMCMovetype::unassign_domains(vector<Domain*> domains) {
+void MetMCMovetype::unassign_domains(const vector<Domain*>& domains) {
     for (auto domain: domains) {
         pair<int, int> key {domain->m_c, domain->m_d};
-        m_prev_pos[key] = domain->m_pos;
-        m_prev_ore[key] = domain->m_ore;
+        m_prev_configs.save(*domain);
         m_modified_domains.push_back(key);
         m_delta_e += m_origami_system.unassign_domain(*domain);
     }
@@ -329,7 +328,8 @@ bool MetStapleExchangeMCMovetype::insert_staple() {
     m_added_chains.push_back(c_i);
 
     // Assume that add_chain always adds to end of m_domains
-    vector<Domain*> selected_chain {m_origami_system.get_last_chain()};
+    const vector<Domain*>& selected_chain {
+            m_origami_system.get_last_chain()};
 
     // Select growth points on chains
     pair<Domain*, Domain*> growthpoint {select_new_growthpoint(selected_chain)};
@@ -344,10 +344,10 @@ bool MetStapleExchangeMCMovetype::insert_staple() {
         return accepted;
     }
 
-    vector<Domain*> staple {m_origami_system.get_chain(c_i)};
+    const vector<Domain*>& staple {m_origami_system.get_chain(c_i)};
     for (size_t i {0}; i != staple.size(); i++) {
         Domain* d {staple[i]};
-        if (d->m_state == Occupancy::bound) {
+        if (d->state() == Occupancy::bound) {
             m_staple_bound = true;
             break;
         }
@@ -370,13 +370,13 @@ bool MetStapleExchangeMCMovetype::delete_staple() {
     }
 
     // Reject if staple is connector
-    vector<Domain*> staple {m_origami_system.get_chain(c_i)};
+    const vector<Domain*>& staple {m_origami_system.get_chain(c_i)};
     if (staple_is_connector(staple)) {
         return accepted;
     }
     for (size_t i {0}; i != staple.size(); i++) {
         Domain* d {staple[i]};
-        if (d->m_state == Occupancy::bound) {
+        if (d->state() == Occupancy::bound) {
             m_staple_bound = true;
             break;
         }
@@ -479,7 +479,8 @@ bool MetStapleRegrowthMCMovetype::internal_attempt_move() {
     // Select a staple to regrow
     int c_i_index {
             m_random_gens.uniform_int(1, m_origami_system.num_staples())};
-    vector<Domain*> selected_chain {m_origami_system.get_chains()[c_i_index]};
+    const vector<Domain*>& selected_chain {
+            m_origami_system.get_chains()[c_i_index]};
     m_tracker.staple_type = selected_chain[0]->m_c_ident;
 
     // Reject if staple is connector
@@ -488,7 +489,8 @@ bool MetStapleRegrowthMCMovetype::internal_attempt_move() {
     }
 
     // Select growth points on chains
-    auto bound_domains = find_bound_domains(selected_chain);
+    vector<domainPairT> bound_domains {};
+    find_bound_domains(selected_chain, bound_domains);
     domainPairT growthpoint {select_old_growthpoint(bound_domains)};
 
     unassign_domains(selected_chain);
@@ -17,6 +17,34 @@ using std::set;
 using utility::Occupancy;
 using utility::OrigamiMisuse;
 
+void DomainConfigs::set(const Domain& domain, VectorThree pos, VectorThree ore) {
+    size_t id {static_cast<size_t>(domain.m_id)};
+    if (id >= m_pos.size()) {
+        m_pos.resize(id + 1);
+        m_ore.resize(id + 1);
+    }
+    m_pos[id] = pos;
+    m_ore[id] = ore;
+}
+
+VectorThree DomainConfigs::pos(const Domain& domain) const {
+    size_t id {static_cast<size_t>(domain.m_id)};
+    if (id >= m_pos.size()) {
+        return {};
+    }
+
+    return m_pos[id];
+}
+
+VectorThree DomainConfigs::ore(const Domain& domain) const {
+    size_t id {static_cast<size_t>(domain.m_id)};
+    if (id >= m_ore.size()) {
+        return {};
+    }
+
+    return m_ore[id];
+}
+
 MCMovetype::MCMovetype(
         OrigamiSystem& origami_system,
         RandomGens& random_gens,
@@ -44,7 +72,11 @@ bool MCMovetype::attempt_move(long long int step) {
     m_step = step;
     write_config();
     m_general_tracker.attempts++;
+    m_origami_system.begin_journal();
     bool accepted {internal_attempt_move()};
+    if (accepted) {
+        m_origami_system.discard_journal();
+    }
     m_general_tracker.accepts += accepted;
     add_tracker(accepted);
 
@@ -53,6 +85,14 @@ bool MCMovetype::attempt_move(long long int step) {
 
 void MCMovetype::reset_origami() {
 
+    // The journal restores the system without evaluating the potential
+    if (not m_origami_system.undo_journal()) {
+        replay_prev_configs();
+    }
+}
+
+void MCMovetype::replay_prev_configs() {
+
     // Reset added domains, modified domains, and deleted domains
 
     // Unassign assigned domains
@@ -67,19 +107,15 @@ void MCMovetype::reset_origami() {
     // Delete chains that were added
     for (auto c_i: m_added_chains) {
         m_origami_system.delete_chain(c_i);
-
-        // Roll back index numbering to prevent excessivly large indices
-        m_origami_system.m_current_c_i -= 1;
     }
 
     // Revert modified domains to previous positions
     for (auto c_i_d_i: m_modified_domains) {
         int c_i {c_i_d_i.first};
         int d_i {c_i_d_i.second};
-        pair<int, int> key {c_i, d_i};
-        VectorThree pos {m_prev_pos[key]};
-        VectorThree ore {m_prev_ore[key]};
         Domain* domain {m_origami_system.get_domain(c_i, d_i)};
+        VectorThree pos {m_prev_configs.pos(*domain)};
+        VectorThree ore {m_prev_configs.ore(*domain)};
         m_origami_system.set_checked_domain_config(*domain, pos, ore);
     }
 
@@ -99,18 +135,7 @@ void MCMovetype::write_log_summary_header(ostream* log_stream) {
 Domain* MCMovetype::select_random_domain() {
     int d_i_index {
             m_random_gens.uniform_int(0, m_origami_system.num_domains() - 1)};
-    int counter {0};
-    for (auto chain: m_origami_system.get_chains()) {
-        for (auto domain: chain) {
-            if (counter == d_i_index) {
-                return domain;
-            }
-            else {
-                counter++;
-            }
-        }
-    }
-    return nullptr;
+    return m_origami_system.indexed_domain(d_i_index);
 }
 
 int MCMovetype::select_random_staple_identity() {
@@ -158,10 +183,10 @@ bool MCMovetype::test_acceptance(long double p_ratio) {
     return accept;
 }
 
-bool MCMovetype::staple_is_connector(vector<Domain*> staple) {
+bool MCMovetype::staple_is_connector(const vector<Domain*>& staple) {
     for (auto domain: staple) {
-        if (domain->m_state != Occupancy::unbound) {
-            Domain* bound_domain {domain->m_bound_domain};
+        if (domain->state() != Occupancy::unbound) {
+            Domain* bound_domain {domain->bound_domain()};
             if (bound_domain->m_c == m_origami_system.c_scaffold) {
                 continue;
             }
@@ -177,10 +202,10 @@ bool MCMovetype::staple_is_connector(vector<Domain*> staple) {
     return false;
 }
 
-set<int> MCMovetype::find_staples(vector<Domain*> domains) {
+set<int> MCMovetype::find_staples(const vector<Domain*>& domains) {
     set<int> staples {};
     for (auto domain: domains) {
-        Domain* bound_domain {domain->m_bound_domain};
+        Domain* bound_domain {domain->bound_domain()};
         if (bound_domain != nullptr and bound_domain->m_c != 0) {
             scan_for_scaffold_domain(bound_domain, staples);
         }
@@ -196,12 +221,12 @@ bool MCMovetype::scan_for_scaffold_domain(
     bool bound_to_scaffold {false};
     int c_i {domain->m_c};
     participating_chains.insert(c_i);
-    vector<Domain*> staple {m_origami_system.get_chain(c_i)};
+    const vector<Domain*>& staple {m_origami_system.get_chain(c_i)};
     for (auto cur_domain: staple) {
         if (cur_domain == domain) {
             continue;
         }
-        Domain* bound_domain {cur_domain->m_bound_domain};
+        Domain* bound_domain {cur_domain->bound_domain()};
         if (bound_domain != nullptr) {
 
             // Skip if bound to self
@@ -244,8 +269,6 @@ void MCMovetype::reset_internal() {
     m_modified_domains.clear();
     m_assigned_domains.clear();
     m_added_chains.clear();
-    m_prev_pos.clear();
-    m_prev_ore.clear();
     m_rejected = false;
     m_modifier = 1;
 }
@@ -256,17 +279,18 @@ int MCMovetype::get_attempts() { return m_general_tracker.attempts; }
 
 int MCMovetype::get_accepts() { return m_general_tracker.accepts; }
 
-vector<domainPairT> MCMovetype::find_bound_domains(
-        vector<Domain*> selected_chain) {
+void MCMovetype::find_bound_domains(
+        const vector<Domain*>& selected_chain,
+        vector<domainPairT>& bound_domains) {
 
-    vector<pair<Domain*, Domain*>> bound_domains {};
+    bound_domains.clear();
     int chain_index {selected_chain[0]->m_c};
     for (auto domain: selected_chain) {
-        if (domain->m_bound_domain != nullptr and
-            domain->m_bound_domain->m_c != chain_index) {
+        if (domain->bound_domain() != nullptr and
+            domain->bound_domain()->m_c != chain_index) {
 
             // New domain, old domain
-            bound_domains.push_back({domain, domain->m_bound_domain});
+            bound_domains.push_back({domain, domain->bound_domain()});
         }
     }
 
@@ -274,8 +298,6 @@ vector<domainPairT> MCMovetype::find_bound_domains(
         cout << "System has unbound staple\n";
         throw OrigamiMisuse {};
     }
-
-    return bound_domains;
 }
 
 IdentityMCMovetype::IdentityMCMovetype(
@@ -316,20 +338,15 @@ RegrowthMCMovetype::RegrowthMCMovetype(
                 biases,
                 params) {}
 
-void RegrowthMCMovetype::reset_internal() {
-    m_old_pos.clear();
-    m_old_ore.clear();
-}
-
 double RegrowthMCMovetype::set_growth_point(
         Domain& growth_domain_new,
         Domain& growth_domain_old) {
 
     // Set growth point with complementary orientation
     double delta_e {0};
-    VectorThree o_new {-growth_domain_old.m_ore};
+    VectorThree o_new {-growth_domain_old.ore()};
     delta_e += m_origami_system.set_domain_config(
-            growth_domain_new, growth_domain_old.m_pos, o_new);
+            growth_domain_new, growth_domain_old.pos(), o_new);
     if (m_origami_system.m_constraints_violated) {
         m_rejected = true;
     }
@@ -344,35 +361,38 @@ double RegrowthMCMovetype::set_growth_point(
 
 void RegrowthMCMovetype::grow_staple(
         int d_i_index,
-        vector<Domain*> selected_chain) {
+        const vector<Domain*>& selected_chain) {
+
+    if (m_staple_halves.size() == m_staple_depth) {
+        m_staple_halves.emplace_back();
+    }
+    vector<Domain*>& domains {m_staple_halves[m_staple_depth]};
+    m_staple_depth++;
 
     // Grow in three prime direction
     // (staple domains increase in 3' direction)
     auto first_iter3 {selected_chain.begin() + d_i_index};
     auto last_iter3 {selected_chain.end()};
-    vector<Domain*> domains_three_prime {first_iter3, last_iter3};
-    if (domains_three_prime.size() > 1) {
-        grow_chain(domains_three_prime);
-    }
-    if (m_rejected) {
-        return;
+    domains.assign(first_iter3, last_iter3);
+    if (domains.size() > 1) {
+        grow_chain(domains);
     }
 
     // Grow in five prime direction
-    auto first_iter5 {selected_chain.begin()};
-    auto last_iter5 {selected_chain.begin() + d_i_index + 1};
-    vector<Domain*> domains_five_prime {first_iter5, last_iter5};
-    std::reverse(domains_five_prime.begin(), domains_five_prime.end());
-    if (domains_five_prime.size() > 1) {
-        grow_chain(domains_five_prime);
-    }
-    if (m_rejected) {
-        return;
+    if (not m_rejected) {
+        auto first_iter5 {selected_chain.begin()};
+        auto last_iter5 {selected_chain.begin() + d_i_index + 1};
+        domains.assign(first_iter5, last_iter5);
+        std::reverse(domains.begin(), domains.end());
+        if (domains.size() > 1) {
+            grow_chain(domains);
+        }
     }
+    m_staple_depth--;
 }
 
 pair<Domain*, Domain*> RegrowthMCMovetype::select_new_growthpoint(
-        vector<Domain*> selected_chain) {
+        const vector<Domain*>& selected_chain) {
 
     int growth_di_new {m_random_gens.uniform_int(0, selected_chain.size() - 1)};
     Domain* growth_d_new {selected_chain[growth_di_new]};
@@ -385,7 +405,7 @@ pair<Domain*, Domain*> RegrowthMCMovetype::select_new_growthpoint(
 }
 
 domainPairT RegrowthMCMovetype::select_old_growthpoint(
-        vector<domainPairT> bound_domains) {
+        const vector<domainPairT>& bound_domains) {
 
     int bound_domain_index {
             m_random_gens.uniform_int(0, bound_domains.size() - 1)};
@@ -394,11 +414,12 @@ domainPairT RegrowthMCMovetype::select_old_growthpoint(
     return {growth_domain_new, growth_domain_old};
 }
 
-int RegrowthMCMovetype::num_bound_staple_domains(vector<Domain*> staple) {
+int RegrowthMCMovetype::num_bound_staple_domains(
+        const vector<Domain*>& staple) {
     int num_bd {0};
     for (auto d: staple) {
-        if (d->m_state == Occupancy::bound or
-            d->m_state == Occupancy::misbound) {
+        if (d->state() == Occupancy::bound or
+            d->state() == Occupancy::misbound) {
             num_bd++;
         }
     }
@@ -468,8 +489,9 @@ void CTRegrowthMCMovetype::sel_excluded_staples() {
     }
 }
 
-vector<Domain*> CTRegrowthMCMovetype::select_indices(
-        vector<Domain*> segment,
+void CTRegrowthMCMovetype::select_indices(
+        const vector<Domain*>& segment,
+        vector<Domain*>& domains,
         unsigned int min_length,
         int seg) {
 
@@ -487,7 +509,7 @@ vector<Domain*> CTRegrowthMCMovetype::select_indices(
 
     // Add domains until length reached
     Domain* cur_domain {segment[start_i]};
-    vector<Domain*> domains {};
+    domains.clear();
     while (cur_domain != nullptr and domains.size() != sel_length) {
         domains.push_back(cur_domain);
         cur_domain = (*cur_domain) + m_dir;
@@ -498,27 +520,26 @@ vector<Domain*> CTRegrowthMCMovetype::select_indices(
         back_domain = (*back_domain) + -m_dir;
     }
     if (domains.size() < min_length) {
-        domains = select_indices(segment, min_length, seg);
-        return domains;
+        select_indices(segment, domains, min_length, seg);
+        return;
     }
 
     // If end domain is end of chain, no endpoint
     if (cur_domain != nullptr) {
         m_constraintpoints.add_active_endpoint(
-                cur_domain, cur_domain->m_pos, seg);
+                cur_domain, cur_domain->pos(), seg);
     }
-
-    return domains;
 }
 
 void CTRegrowthMCMovetype::select_noncontig_segs(
-        vector<Domain*>& given_seg,
-        vector<vector<Domain*>>& segs,
-        vector<vector<vector<Domain*>>>& paired_segs,
-        vector<Domain*>& seg_stems,
-        vector<int>& dirs) {
-
-    set<Domain*> domains {};
+        const vector<Domain*>& given_seg) {
+
+    m_seg_dirs.clear();
+    m_seg_stems.clear();
+    m_seg_domains.clear();
+    m_num_seg_domains = 0;
+    m_possible_stems.clear();
+    m_next_stem = 0;
     unsigned int max_length {static_cast<unsigned int>(
             m_random_gens.uniform_int(2, m_max_regrowth))};
     size_t seg_max {static_cast<unsigned int>(
@@ -532,33 +553,25 @@ void CTRegrowthMCMovetype::select_noncontig_segs(
     if ((*seg_start_d) + dir == nullptr) {
         dir *= -1;
     }
-    vector<Domain*> cur_seg {seg_start_d};
-    domains.insert(seg_start_d);
-    deque<Domain*> possible_stems {};
-    dirs.push_back(dir);
-    bool max_length_reached {fill_seg(
-            seg_start_d,
-            max_length,
-            seg_max,
-            dir,
-            domains,
-            possible_stems,
-            cur_seg)};
-    segs.push_back(cur_seg);
+    add_seg(dir);
+    m_segs[0].push_back(seg_start_d);
+    select_seg_domain(seg_start_d);
+    bool max_length_reached {
+            fill_seg(seg_start_d, max_length, seg_max, dir, m_segs[0])};
     Domain* stemd;
-    while (not max_length_reached and possible_stems.size() != 0) {
-        cur_seg.clear();
+    while (not max_length_reached and
+           m_next_stem != m_possible_stems.size()) {
 
         // Select a stem domain
-        stemd = possible_stems.front();
-        possible_stems.pop_front();
-        if (domains.count(stemd) != 0) {
+        stemd = m_possible_stems[m_next_stem];
+        m_next_stem++;
+        if (m_seg_domains.contains(stemd)) {
             continue;
         }
         bool adjacent_d_bound {false};
         for (int test_dir: {-1, 1}) {
             Domain* next_d {*stemd + test_dir};
-            if (next_d != nullptr and domains.count(next_d) != 0) {
+            if (next_d != nullptr and m_seg_domains.contains(next_d)) {
                 adjacent_d_bound = true;
                 break;
             }
@@ -566,16 +579,12 @@ void CTRegrowthMCMovetype::select_noncontig_segs(
         if (adjacent_d_bound) {
             continue;
         }
-        cur_seg.push_back(stemd);
-        domains.insert(stemd);
-        seg_stems.push_back(stemd);
-        if (domains.size() == max_length) {
+        select_seg_domain(stemd);
+        m_seg_stems.push_back(stemd);
+        if (m_num_seg_domains == max_length) {
             max_length_reached = true;
-            segs.push_back(cur_seg);
-            segs.push_back({});
-            paired_segs.push_back({{}, {}});
-            dirs.push_back(1);
-            dirs.push_back(-1);
+            m_segs[add_seg(1)].push_back(stemd);
+            add_seg(-1);
             break;
         }
 
@@ -583,56 +592,44 @@ void CTRegrowthMCMovetype::select_noncontig_segs(
         if (dir1 == 0) {
             dir1 = -1;
         }
-        vector<int> dir_pair {dir1, -dir1};
-        dirs.insert(dirs.end(), dir_pair.begin(), dir_pair.end());
-        vector<vector<Domain*>> seg_pair {{}, {}};
-        segs.insert(segs.end(), seg_pair.begin(), seg_pair.end());
+        size_t first_seg_i {add_seg(dir1)};
+        add_seg(-dir1);
+        m_segs[first_seg_i].push_back(stemd);
         for (size_t i: {0, 1}) {
-            dir = dir_pair[i];
+            dir = m_seg_dirs[first_seg_i + i];
             seg_max = static_cast<size_t>(
                     m_random_gens.uniform_int(0, m_max_seg_regrowth));
+
+            // The stem heads the first segment but is not counted in it
+            vector<Domain*>& seg {m_segs[first_seg_i + i]};
             if (i == 0) {
                 max_length++;
+                seg_max++;
             }
-            vector<Domain*> seg {};
-            max_length_reached = fill_seg(
-                    stemd,
-                    max_length,
-                    seg_max,
-                    dir,
-                    domains,
-                    possible_stems,
-                    seg);
-            seg_pair[i] = seg;
-            if (cur_seg.size() != 0) {
-                seg.insert(seg.begin(), cur_seg[0]);
-            }
-            segs[segs.size() - 2 + i] = seg;
+            max_length_reached =
+                    fill_seg(stemd, max_length, seg_max, dir, seg);
             if (max_length_reached) {
                 break;
             }
-            cur_seg.clear();
         }
-        paired_segs.push_back(seg_pair);
     }
 
     Domain* last_d;
-    last_d = segs[0].back();
-    dir = dirs[0];
+    last_d = m_segs[0].back();
+    dir = m_seg_dirs[0];
     Domain* next_d {*last_d + dir};
     if (next_d != nullptr) {
-        m_constraintpoints.add_active_endpoint(next_d, next_d->m_pos, 0);
+        m_constraintpoints.add_active_endpoint(next_d, next_d->pos(), 0);
     }
 
     int seg_i {1};
-    for (size_t i {0}; i != paired_segs.size(); i++) {
-        Domain* stem_d {seg_stems[i]};
-        Domain* growthpoint {stem_d->m_bound_domain};
+    for (auto stem_d: m_seg_stems) {
+        Domain* growthpoint {stem_d->bound_domain()};
         m_constraintpoints.add_growthpoint(growthpoint, stem_d);
         m_constraintpoints.add_stem_seg_pair(stem_d, {seg_i, seg_i + 1});
-        vector<int> stem_seg_pair {};
-        for (auto seg: paired_segs[i]) {
-            int dir {dirs[seg_i]};
+        for (int i {0}; i != 2; i++) {
+            const vector<Domain*>& seg {m_segs[seg_i]};
+            int dir {m_seg_dirs[seg_i]};
             if (seg.size() != 0) {
                 last_d = seg.back();
             }
@@ -642,17 +639,35 @@ void CTRegrowthMCMovetype::select_noncontig_segs(
             Domain* next_d {*last_d + dir};
             if (next_d != nullptr) {
                 m_constraintpoints.add_active_endpoint(
-                        next_d, next_d->m_pos, seg_i);
+                        next_d, next_d->pos(), seg_i);
             }
             seg_i++;
         }
     }
 }
 
+size_t CTRegrowthMCMovetype::add_seg(int dir) {
+    size_t seg_i {m_seg_dirs.size()};
+    if (seg_i == m_segs.size()) {
+        m_segs.emplace_back();
+    }
+    m_segs[seg_i].clear();
+    m_seg_dirs.push_back(dir);
+
+    return seg_i;
+}
+
+void CTRegrowthMCMovetype::select_seg_domain(Domain* d) {
+    if (not m_seg_domains.contains(d)) {
+        m_seg_domains[d] = m_num_seg_domains;
+        m_num_seg_domains++;
+    }
+}
+
 bool CTRegrowthMCMovetype::excluded_staples_bound() {
     bool bound_to_system {false};
     for (auto exs_i: m_excluded_staples) {
-        vector<Domain*> exs {m_origami_system.get_chain(exs_i)};
+        const vector<Domain*>& exs {m_origami_system.get_chain(exs_i)};
         for (auto exd: exs) {
             set<int> dummy_set {};
             if (scan_for_scaffold_domain(exd, dummy_set)) {
@@ -670,12 +685,10 @@ bool CTRegrowthMCMovetype::fill_seg(
         size_t max_length,
         size_t seg_max_length,
         int dir,
-        set<Domain*>& domains,
-        deque<Domain*>& possible_stems,
         vector<Domain*>& seg) {
 
     Domain* cur_d {start_d};
-    check_for_stemds(cur_d, possible_stems);
+    check_for_stemds(cur_d);
     Domain* next_d {start_d};
     Domain* next_next_d {start_d};
     bool max_length_reached {false};
@@ -685,35 +698,33 @@ bool CTRegrowthMCMovetype::fill_seg(
             break;
         }
         next_next_d = *next_d + dir;
-        if (next_next_d != nullptr and domains.count(next_next_d) != 0) {
+        if (next_next_d != nullptr and m_seg_domains.contains(next_next_d)) {
             break;
         }
         seg.push_back(next_d);
-        domains.insert(next_d);
-        if (domains.size() == max_length) {
+        select_seg_domain(next_d);
+        if (m_num_seg_domains == max_length) {
             max_length_reached = true;
             break;
         }
         cur_d = next_d;
-        check_for_stemds(cur_d, possible_stems);
+        check_for_stemds(cur_d);
     }
 
     return max_length_reached;
 }
 
-void CTRegrowthMCMovetype::check_for_stemds(
-        Domain* cur_d,
-        deque<Domain*>& possible_stems) {
+void CTRegrowthMCMovetype::check_for_stemds(Domain* cur_d) {
 
-    if (cur_d->m_state == Occupancy::bound) {
-        Domain* bound_d {cur_d->m_bound_domain};
+    if (cur_d->state() == Occupancy::bound) {
+        Domain* bound_d {cur_d->bound_domain()};
         for (int staple_dir: {-1, 1}) {
             Domain* neighbour_d {*bound_d + staple_dir};
             if (neighbour_d != nullptr and
-                neighbour_d->m_state == Occupancy::bound) {
-                Domain* bound_neighbour_d {neighbour_d->m_bound_domain};
+                neighbour_d->state() == Occupancy::bound) {
+                Domain* bound_neighbour_d {neighbour_d->bound_domain()};
                 if (bound_neighbour_d->m_c == m_origami_system.c_scaffold) {
-                    possible_stems.push_back(bound_neighbour_d);
+                    m_possible_stems.push_back(bound_neighbour_d);
                 }
             }
         }
@@ -38,7 +38,11 @@ ThermoOfHybrid calc_unitless_hybridization_thermo(
         string seq,
         double temp,
         double cation_M) {
-    ThermoOfHybrid DH_DS {calc_hybridization_H_and_S(seq, cation_M)};
+    return calc_unitless_thermo(
+            calc_hybridization_H_and_S(seq, cation_M), temp);
+}
+
+ThermoOfHybrid calc_unitless_thermo(ThermoOfHybrid DH_DS, double temp) {
 
     // Convert from kcal/mol to unitless dimension
     DH_DS.enthalpy = DH_DS.enthalpy * J_Per_Cal * 1000 / R / temp;
@@ -134,31 +138,38 @@ vector<string> find_longest_contig_complement(string seq_i, string seq_j) {
 
     seq_three = calc_comp_seq(seq_three);
 
-    // Iterate through all lengths and starting points
-    vector<string> comp_seqs {};
-    for (int subseq_len {(int)seq_three.size()}; subseq_len != 0;
-         subseq_len--) {
-        for (unsigned int start_i {0};
-             start_i != (seq_three.size() - subseq_len + 1);
-             start_i++) {
-            string subseq {seq_three.substr(start_i, subseq_len)};
-            size_t subseq_i {seq_five.find(subseq)};
-            int subseq_count {0};
-            while (subseq_i != string::npos) {
-                subseq_i = seq_five.find(subseq, subseq_i + 1);
-                subseq_count++;
+    // Lengths of the common prefixes of every pair of suffixes, filled from
+    // the back so that each entry only needs its diagonal successor
+    size_t len_three {seq_three.size()};
+    size_t len_five {seq_five.size()};
+    vector<int> prefix_lens((len_three + 1) * (len_five + 1), 0);
+    auto prefix_len = [&prefix_lens, len_five](size_t i, size_t j) -> int& {
+        return prefix_lens[i * (len_five + 1) + j];
+    };
+    int max_len {0};
+    for (size_t i {len_three}; i-- != 0;) {
+        for (size_t j {len_five}; j-- != 0;) {
+            if (seq_three[i] == seq_five[j]) {
+                prefix_len(i, j) = prefix_len(i + 1, j + 1) + 1;
+                max_len = std::max(max_len, prefix_len(i, j));
             }
-            for (int i {0}; i != subseq_count; i++) {
-                comp_seqs.push_back(subseq);
-            }
-        }
-        if (comp_seqs.empty()) {
-            continue;
         }
-        else {
-            return comp_seqs;
+    }
+
+    // Each longest subsequence of the first is included once for every
+    // (possibly overlapping) occurence in the second
+    vector<string> comp_seqs {};
+    if (max_len == 0) {
+        return comp_seqs;
+    }
+    for (size_t i {0}; i != len_three; i++) {
+        for (size_t j {0}; j != len_five; j++) {
+            if (prefix_len(i, j) >= max_len) {
+                comp_seqs.push_back(seq_three.substr(i, max_len));
+            }
         }
     }
+
     return comp_seqs;
 }
 
@@ -0,0 +1,191 @@
+// occupancy_grid.cpp
+
+#include "occupancy_grid.h"
+
+namespace occupancyGrid {
+
+// Blocks of padding added on a side of the directory when it has to grow
+const int directory_padding {2};
+
+Occupancy OccupancyGrid::occupancy(const VectorThree& pos) const {
+    Site* site {find_site(pos)};
+    if (site == nullptr) {
+        return Occupancy::unassigned;
+    }
+    return site->occupancy;
+}
+
+Domain* OccupancyGrid::unbound_domain(const VectorThree& pos) const {
+    Site* site {find_site(pos)};
+    if (site == nullptr) {
+        return nullptr;
+    }
+    return site->unbound_domain;
+}
+
+void OccupancyGrid::read_site(
+        const VectorThree& pos,
+        Occupancy& occupancy,
+        Domain*& unbound_domain) const {
+    Site* site {find_site(pos)};
+    if (site == nullptr) {
+        occupancy = Occupancy::unassigned;
+        unbound_domain = nullptr;
+        return;
+    }
+    occupancy = site->occupancy;
+    unbound_domain = site->unbound_domain;
+}
+
+void OccupancyGrid::set_unbound(const VectorThree& pos, Domain* domain) {
+    Site& site {get_site(pos)};
+    site.occupancy = Occupancy::unbound;
+    site.unbound_domain = domain;
+}
+
+void OccupancyGrid::set_bound(const VectorThree& pos, Occupancy state) {
+    Site& site {get_site(pos)};
+    site.occupancy = state;
+    site.unbound_domain = nullptr;
+}
+
+void OccupancyGrid::unassign(const VectorThree& pos) {
+    Site* site {find_site(pos)};
+    if (site != nullptr) {
+        *site = Site {};
+    }
+}
+
+void OccupancyGrid::translate(const VectorThree& disp) {
+
+    // Blocks are kept rather than rebuilt, so that recentering does not
+    // allocate once the blocks around the system exist
+    m_moved_sites.clear();
+    for (int b_x {0}; b_x != m_dims[0]; b_x++) {
+        for (int b_y {0}; b_y != m_dims[1]; b_y++) {
+            for (int b_z {0}; b_z != m_dims[2]; b_z++) {
+                int b_i {(b_x * m_dims[1] + b_y) * m_dims[2] + b_z};
+                Block* block {m_blocks[b_i].get()};
+                if (block == nullptr) {
+                    continue;
+                }
+                for (int s_i {0}; s_i != c_block_sites; s_i++) {
+                    Site& site {(*block)[s_i]};
+                    if (site.occupancy == Occupancy::unassigned) {
+                        continue;
+                    }
+                    VectorThree pos {
+                            ((m_origin[0] + b_x) << c_block_bits) +
+                                    (s_i >> (2 * c_block_bits)),
+                            ((m_origin[1] + b_y) << c_block_bits) +
+                                    ((s_i >> c_block_bits) & c_block_mask),
+                            ((m_origin[2] + b_z) << c_block_bits) +
+                                    (s_i & c_block_mask)};
+                    m_moved_sites.push_back({pos + disp, site});
+                    site = Site {};
+                }
+            }
+        }
+    }
+    for (auto& moved_site: m_moved_sites) {
+        get_site(moved_site.first) = moved_site.second;
+    }
+}
+
+void OccupancyGrid::clear() {
+    m_origin = {{0, 0, 0}};
+    m_dims = {{0, 0, 0}};
+    m_blocks.clear();
+}
+
+OccupancyGrid::Site* OccupancyGrid::find_site(const VectorThree& pos) const {
+    int b_i {block_index(block_coords(pos))};
+    if (b_i == -1 or m_blocks[b_i] == nullptr) {
+        return nullptr;
+    }
+
+    return &(*m_blocks[b_i])[site_index(pos)];
+}
+
+OccupancyGrid::Site& OccupancyGrid::get_site(const VectorThree& pos) {
+    array<int, 3> block_pos {block_coords(pos)};
+    int b_i {block_index(block_pos)};
+    if (b_i == -1) {
+        grow_directory(block_pos);
+        b_i = block_index(block_pos);
+    }
+    if (m_blocks[b_i] == nullptr) {
+        m_blocks[b_i].reset(new Block {});
+    }
+
+    return (*m_blocks[b_i])[site_index(pos)];
+}
+
+array<int, 3> OccupancyGrid::block_coords(const VectorThree& pos) {
+
+    // Arithmetic shifts floor negative coordinates
+    return {{pos[0] >> c_block_bits,
+             pos[1] >> c_block_bits,
+             pos[2] >> c_block_bits}};
+}
+
+int OccupancyGrid::site_index(const VectorThree& pos) {
+
+    // Masking gives the offset into the block for negative coordinates too
+    return ((pos[0] & c_block_mask) << (2 * c_block_bits)) +
+           ((pos[1] & c_block_mask) << c_block_bits) + (pos[2] & c_block_mask);
+}
+
+int OccupancyGrid::block_index(const array<int, 3>& block_pos) const {
+    int b_i {0};
+    for (int i {0}; i != 3; i++) {
+        int offset {block_pos[i] - m_origin[i]};
+        if (offset < 0 or offset >= m_dims[i]) {
+            return -1;
+        }
+        b_i = b_i * m_dims[i] + offset;
+    }
+
+    return b_i;
+}
+
+void OccupancyGrid::grow_directory(const array<int, 3>& block_pos) {
+    array<int, 3> origin {};
+    array<int, 3> dims {};
+    for (int i {0}; i != 3; i++) {
+        int lower {m_origin[i]};
+        int upper {m_origin[i] + m_dims[i]};
+        if (m_dims[i] == 0) {
+            lower = block_pos[i] - directory_padding;
+            upper = block_pos[i] + directory_padding + 1;
+        }
+        else if (block_pos[i] < lower) {
+            lower = block_pos[i] - directory_padding;
+        }
+        else if (block_pos[i] >= upper) {
+            upper = block_pos[i] + directory_padding + 1;
+        }
+        origin[i] = lower;
+        dims[i] = upper - lower;
+    }
+
+    vector<unique_ptr<Block>> blocks(dims[0] * dims[1] * dims[2]);
+    for (int b_x {0}; b_x != m_dims[0]; b_x++) {
+        for (int b_y {0}; b_y != m_dims[1]; b_y++) {
+            for (int b_z {0}; b_z != m_dims[2]; b_z++) {
+                int old_b_i {(b_x * m_dims[1] + b_y) * m_dims[2] + b_z};
+                int new_b_i {
+                        ((b_x + m_origin[0] - origin[0]) * dims[1] + b_y +
+                         m_origin[1] - origin[1]) *
+                                dims[2] +
+                        b_z + m_origin[2] - origin[2]};
+                blocks[new_b_i] = std::move(m_blocks[old_b_i]);
+            }
+        }
+    }
+    m_origin = origin;
+    m_dims = dims;
+    m_blocks = std::move(blocks);
+}
+
+} // namespace occupancyGrid
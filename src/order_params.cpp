@@ -33,11 +33,11 @@ DistOrderParam::DistOrderParam(
 }
 
 int DistOrderParam::calc_param() {
-    if (m_domain_1.m_state != Occupancy::unassigned and
-        m_domain_2.m_state != Occupancy::unassigned) {
+    if (m_domain_1.state() != Occupancy::unassigned and
+        m_domain_2.state() != Occupancy::unassigned) {
 
         m_defined = true;
-        VectorThree diff_vec {m_domain_2.m_pos - m_domain_1.m_pos};
+        VectorThree diff_vec {m_domain_2.pos() - m_domain_1.pos()};
         m_param = diff_vec.abssum();
         m_checked_param = m_param;
     }
@@ -57,9 +57,9 @@ int DistOrderParam::check_param(
     if (domain.m_d == m_domain_1.m_d) {
         unmodded_domain = &m_domain_2;
     }
-    if (unmodded_domain->m_state != Occupancy::unassigned and
+    if (unmodded_domain->state() != Occupancy::unassigned and
         state != Occupancy::unassigned) {
-        m_checked_param = (new_pos - unmodded_domain->m_pos).abssum();
+        m_checked_param = (new_pos - unmodded_domain->pos()).abssum();
         // Will be defined for configurations where that domain is unassigned
         // Consider using a check defined variable instead
         m_defined = true;
@@ -82,11 +82,11 @@ AdjacentSiteOrderParam::AdjacentSiteOrderParam(
 }
 
 int AdjacentSiteOrderParam::calc_param() {
-    if (m_domain_1.m_state != Occupancy::unassigned and
-        m_domain_2.m_state != Occupancy::unassigned) {
+    if (m_domain_1.state() != Occupancy::unassigned and
+        m_domain_2.state() != Occupancy::unassigned) {
 
         m_defined = true;
-        VectorThree diff_vec {m_domain_2.m_pos - m_domain_1.m_pos};
+        VectorThree diff_vec {m_domain_2.pos() - m_domain_1.pos()};
         auto dist = diff_vec.abssum();
         if (dist == 1) {
             m_param = 1;
@@ -112,11 +112,11 @@ int AdjacentSiteOrderParam::check_param(
     if (domain.m_d == m_domain_1.m_d) {
         unmodded_domain = &m_domain_2;
     }
-    if (unmodded_domain->m_state != Occupancy::unassigned and
+    if (unmodded_domain->state() != Occupancy::unassigned and
         state != Occupancy::unassigned) {
         // Will be defined for configurations where that domain is unassigned
         // Consider using a check defined variable instead
-        auto dist = (new_pos - unmodded_domain->m_pos).abssum();
+        auto dist = (new_pos - unmodded_domain->pos()).abssum();
         if (dist == 1) {
             m_checked_param = 1;
         }
@@ -249,20 +249,7 @@ StapleTypeFullyBoundOrderParam::StapleTypeFullyBoundOrderParam(
 }
 
 int StapleTypeFullyBoundOrderParam::calc_param() {
-    m_param = 0;
-    for (auto staple_i: m_origami.staples_of_ident(m_c_ident)) {
-        bool fully_bound {true};
-        for (auto domain: m_origami.get_chain(staple_i)) {
-            if (domain->m_state != Occupancy::bound) {
-                fully_bound = false;
-                break;
-            }
-        }
-        if (fully_bound) {
-            m_param = 1;
-            break;
-        }
-    }
+    m_param = m_origami.staple_stats(m_c_ident).fully_bound_copies > 0;
 
     return m_param;
 }
@@ -458,7 +445,7 @@ SystemOrderParams::SystemOrderParams(
 
     // Setup dependency table
     vector<pair<int, int>> keys {};
-    for (auto chain: origami.get_chains()) {
+    for (auto& chain: origami.get_chains()) {
         for (auto domain: chain) {
             pair<int, int> key {domain->m_c, domain->m_d};
             m_domain_update_ops[key] = {};
@@ -34,14 +34,14 @@ bool OrientationRotationMCMovetype::internal_attempt_move() {
     Domain* domain {select_random_domain()};
     VectorThree o_new {select_random_orientation()};
 
-    if (domain->m_state == Occupancy::bound or
-        domain->m_state == Occupancy::misbound) {
+    if (domain->state() == Occupancy::bound or
+        domain->state() == Occupancy::misbound) {
         double delta_e {0};
-        VectorThree o_old {domain->m_ore};
-        Domain* bound_domain {domain->m_bound_domain};
+        VectorThree o_old {domain->ore()};
+        Domain* bound_domain {domain->bound_domain()};
         delta_e += m_origami_system.unassign_domain(*bound_domain);
         m_origami_system.set_domain_orientation(*domain, o_new);
-        VectorThree pos {domain->m_pos};
+        VectorThree pos {domain->pos()};
         delta_e +=
                 m_origami_system.set_domain_config(*bound_domain, pos, -o_new);
         if (not m_origami_system.m_constraints_violated) {
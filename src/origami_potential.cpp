@@ -3,40 +3,78 @@
 #include "origami_potential.h"
 #include "nearest_neighbour.h"
 
-#include <fstream>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <type_traits>
 #include <utility>
 
-#include <boost/archive/text_iarchive.hpp>
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/serialization/unordered_map.hpp>
-#include <boost/serialization/utility.hpp>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace potential {
 
 using std::cout;
 
+using direction::Direction;
+using direction::encode;
+using direction::negate;
+using direction::same;
+using domainContainer::HalfTurnDomain;
+using domainContainer::ThreeQuarterTurnDomain;
 using nearestNeighbour::calc_comp_seq;
 using utility::Occupancy;
 using utility::OrigamiMisuse;
 
-bool check_domain_orientations_opposing(Domain& cd_i, Domain& cd_j) {
+// Fixed capacity list of candidate domain pairs for the junction checks,
+// which run for every domain binding and so should not allocate
+class DomainPairs {
+  public:
+    void push_back(const pair<Domain*, Domain*>& domain_pair) {
+        m_pairs[m_size] = domain_pair;
+        m_size++;
+    }
+    const pair<Domain*, Domain*>* begin() const { return m_pairs.data(); }
+    const pair<Domain*, Domain*>* end() const {
+        return m_pairs.data() + m_size;
+    }
+
+  private:
+    std::array<pair<Domain*, Domain*>, 3> m_pairs;
+    int m_size {0};
+};
+
+bool check_domain_orientations_opposing(
+        const TrialStates& states,
+        Domain& cd_i,
+        Domain& cd_j) {
     bool domain_orientations_opposing {true};
-    if (cd_i.m_ore != -cd_j.m_ore) {
+    Direction ore_i {encode(states.ore(&cd_i))};
+    if (not same(ore_i, negate(encode(states.ore(&cd_j))))) {
         domain_orientations_opposing = false;
         return domain_orientations_opposing;
     }
     return domain_orientations_opposing;
 }
 
-bool check_domains_exist_and_bound(vector<Domain*> cdv) {
+bool check_domains_exist_and_bound(
+        const TrialStates& states,
+        std::initializer_list<Domain*> cdv) {
     bool exists_and_bound {true};
     for (auto cd: cdv) {
         if (cd == nullptr) {
             exists_and_bound = false;
             break;
         }
-        bool cd_bound {cd->m_state == Occupancy::bound};
+        bool cd_bound {states.state(cd) == Occupancy::bound};
         if (not cd_bound) {
             exists_and_bound = false;
             break;
@@ -46,14 +84,14 @@ bool check_domains_exist_and_bound(vector<Domain*> cdv) {
     return exists_and_bound;
 }
 
-bool doubly_contiguous(Domain* cd_1, Domain* cd_2) {
+bool doubly_contiguous(const TrialStates& states, Domain* cd_1, Domain* cd_2) {
 
     if (cd_1->m_c != cd_2->m_c or cd_2->m_d != cd_1->m_d + 1) {
         return false;
     }
 
-    Domain* cd_bound_1 {cd_1->m_bound_domain};
-    Domain* cd_bound_2 {cd_2->m_bound_domain};
+    Domain* cd_bound_1 {states.bound_domain(cd_1)};
+    Domain* cd_bound_2 {states.bound_domain(cd_2)};
     if (cd_bound_1->m_c != cd_bound_2->m_c) {
         return false;
     }
@@ -65,22 +103,28 @@ bool doubly_contiguous(Domain* cd_1, Domain* cd_2) {
     return false;
 }
 
-bool check_pair_stacked(Domain* cd_1, Domain* cd_2) {
+template <typename DomainT>
+bool check_pair_stacked(
+        const TrialStates& states,
+        Domain* cd_1,
+        Domain* cd_2) {
     bool stacked {false};
     if (cd_1->m_d > cd_2->m_d) {
         Domain* hold {cd_1};
         cd_1 = cd_2;
         cd_2 = hold;
     }
-    VectorThree ndr {cd_2->m_pos - cd_1->m_pos};
-    if (ndr != cd_1->m_ore and ndr != -cd_1->m_ore) {
-        stacked = cd_1->check_twist_constraint(ndr, *cd_2);
+    Direction ndr {encode(states.pos(cd_2) - states.pos(cd_1))};
+    Direction ore {encode(states.ore(cd_1))};
+    if (not same(ndr, ore) and not same(ndr, negate(ore))) {
+        stacked = DomainT::twist_obeyed(ndr, ore, encode(states.ore(cd_2)));
     }
 
     return stacked;
 }
 
 int check_junction_stacking_penalty(
+        const TrialStates& states,
         Domain& cd_j1,
         Domain& cd_j2,
         Domain& cd_j3,
@@ -89,18 +133,18 @@ int check_junction_stacking_penalty(
         Domain& cd_k2) {
 
     int stacking_penalty {0};
-    VectorThree ndr_k1 {cd_k2.m_pos - cd_k1.m_pos};
+    Direction ndr_k1 {encode(states.pos(&cd_k2) - states.pos(&cd_k1))};
 
     // Junction penalty only applies if kink pair have one particular config
     // This is also known as the crossover config
-    if (ndr_k1 == cd_k1.m_ore) {
+    if (same(ndr_k1, encode(states.ore(&cd_k1)))) {
 
         // Change next domain vector signs to match domain order
-        VectorThree ndr_1 {cd_j2.m_pos - cd_j1.m_pos};
+        VectorThree ndr_1 {states.pos(&cd_j2) - states.pos(&cd_j1)};
         if (cd_j1.m_d > cd_j2.m_d) {
             ndr_1 = -ndr_1;
         }
-        VectorThree ndr_3 {cd_j4.m_pos - cd_j3.m_pos};
+        VectorThree ndr_3 {states.pos(&cd_j4) - states.pos(&cd_j3)};
         if (cd_j3.m_d > cd_j4.m_d) {
             ndr_3 = -ndr_3;
         }
@@ -122,13 +166,76 @@ int check_junction_stacking_penalty(
     return stacking_penalty;
 }
 
+namespace {
+
+// Bumped whenever the layout or the meaning of energy cache files changes
+constexpr uint32_t c_energy_cache_version {1};
+constexpr char c_energy_cache_magic[8] {'L', 'D', 'O', 'E', 'N', 'E', 'R', 'G'};
+
+static_assert(
+        std::is_trivially_copyable<PairEnergies>::value,
+        "Pair energies are written to the cache files as raw bytes");
+
+// Tables already calculated in this process, by cache key, so that replicas
+// run as threads of one process hold a single copy
+std::mutex shared_tables_mutex {};
+unordered_map<uint64_t, std::weak_ptr<EnergyTables>> shared_tables {};
+
+// Fixed size start of an energy cache file, followed by the pair entries
+struct EnergyCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_size;
+    uint64_t key;
+    uint64_t num_entries;
+    double init_enthalpy;
+    double init_entropy;
+    double init_energy;
+};
+
+static_assert(
+        sizeof(EnergyCacheHeader) % alignof(PairEnergies) == 0,
+        "Pair energies are read in place after the header");
+
+// 64 bit FNV-1a, which unlike std::hash is the same between builds and so
+// can name files that outlive the run
+class ContentHash {
+  public:
+    void add(const void* data, size_t size) {
+        const unsigned char* bytes {static_cast<const unsigned char*>(data)};
+        for (size_t i {0}; i != size; i++) {
+            m_hash ^= bytes[i];
+            m_hash *= 1099511628211ull;
+        }
+    }
+    template <typename T>
+    void add(const T& value) {
+        static_assert(std::is_arithmetic<T>::value, "Hash values, not objects");
+        add(&value, sizeof(value));
+    }
+    void add(const string& value) {
+        add(value.size());
+        add(value.data(), value.size());
+    }
+    uint64_t value() const { return m_hash; }
+
+  private:
+    uint64_t m_hash {14695981039346656037ull};
+};
+
+} // namespace
+
 BindingPotential::BindingPotential(OrigamiPotential& pot): m_pot {pot} {}
 
-DeltaConfig BindingPotential::bind_domains(Domain& cd_i, Domain& cd_j) {
+DeltaConfig BindingPotential::bind_domains(
+        const TrialStates& states,
+        Domain& cd_i,
+        Domain& cd_j) {
 
+    m_states = &states;
     m_delta_config = {};
     m_constraints_violated = false;
-    if (not check_domain_orientations_opposing(cd_i, cd_j)) {
+    if (not check_domain_orientations_opposing(*m_states, cd_i, cd_j)) {
         m_constraints_violated = true;
         return {};
     }
@@ -137,13 +244,17 @@ DeltaConfig BindingPotential::bind_domains(Domain& cd_i, Domain& cd_j) {
     if (m_constraints_violated) {
         return {};
     }
-    m_delta_config.e += m_pot.hybridization_energy(cd_i, cd_j);
+    m_delta_config.e += m_pot.pair_energies(cd_i, cd_j).hyb_energy;
 
     return m_delta_config;
 }
 
-DeltaConfig BindingPotential::check_stacking(Domain& cd_i, Domain& cd_j) {
+DeltaConfig BindingPotential::check_stacking(
+        const TrialStates& states,
+        Domain& cd_i,
+        Domain& cd_j) {
 
+    m_states = &states;
     m_delta_config = {};
     m_constraints_violated = false;
     calc_stacking_and_steric_terms(cd_i, cd_j);
@@ -156,15 +267,15 @@ void BindingPotential::check_triplet_single_stacking(
         Domain* cd_h2,
         Domain* cd_h3) {
 
-    VectorThree ndr_1 {cd_h2->m_pos - cd_h1->m_pos};
+    VectorThree ndr_1 {m_states->pos(cd_h2) - m_states->pos(cd_h1)};
 
     // Does not apply to crossover configuration
-    if (ndr_1 == cd_h1->m_ore) {
+    if (ndr_1 == m_states->ore(cd_h1)) {
         return;
     }
-    VectorThree ndr_2 {cd_h3->m_pos - cd_h2->m_pos};
+    VectorThree ndr_2 {m_states->pos(cd_h3) - m_states->pos(cd_h2)};
     if (ndr_1 != ndr_2) {
-        m_delta_config.e -= m_pot.stacking_energy(*cd_h2, *cd_h3);
+        m_delta_config.e -= m_pot.pair_energies(*cd_h2, *cd_h3).stacking_energy;
         m_delta_config.stacked_pairs -= 1;
         //cout << "(" << cd_h1->m_c << " " << cd_h1->m_d << "), (" << cd_h2->m_c
         //     << " " << cd_h2->m_d << "), (" << cd_h3->m_c << " " << cd_h3->m_d
@@ -177,11 +288,13 @@ void BindingPotential::check_triplet_double_stacking(
         Domain* cd_h2,
         Domain* cd_h3) {
 
-    VectorThree ndr_1 {cd_h2->m_pos - cd_h1->m_pos};
-    VectorThree ndr_2 {cd_h3->m_pos - cd_h2->m_pos};
+    VectorThree ndr_1 {m_states->pos(cd_h2) - m_states->pos(cd_h1)};
+    VectorThree ndr_2 {m_states->pos(cd_h3) - m_states->pos(cd_h2)};
     if (ndr_1 != ndr_2) {
-        m_delta_config.e -= m_pot.stacking_energy(*cd_h1, *cd_h2) / 2;
-        m_delta_config.e -= m_pot.stacking_energy(*cd_h2, *cd_h3) / 2;
+        m_delta_config.e -=
+                m_pot.pair_energies(*cd_h1, *cd_h2).stacking_energy / 2;
+        m_delta_config.e -=
+                m_pot.pair_energies(*cd_h2, *cd_h3).stacking_energy / 2;
         m_delta_config.stacked_pairs -= 1;
         //cout << "(" << cd_h1->m_c << " " << cd_h1->m_d << "), (" << cd_h2->m_c
         //     << " " << cd_h2->m_d << "), (" << cd_h3->m_c << " " << cd_h3->m_d
@@ -194,14 +307,15 @@ void BindingPotential::check_triply_contig_helix(
         Domain* cd_h2,
         Domain* cd_h3) {
 
-    VectorThree ndr_1 {cd_h2->m_pos - cd_h1->m_pos};
-    VectorThree ndr_2 {cd_h3->m_pos - cd_h2->m_pos};
+    VectorThree ndr_1 {m_states->pos(cd_h2) - m_states->pos(cd_h1)};
+    VectorThree ndr_2 {m_states->pos(cd_h3) - m_states->pos(cd_h2)};
     if (ndr_1 != ndr_2) {
         m_constraints_violated = true;
     }
 }
 
-void JunctionBindingPotential::calc_stacking_and_steric_terms(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::calc_stacking_and_steric_terms(
         Domain& cd_i,
         Domain& cd_j) {
 
@@ -220,15 +334,16 @@ void JunctionBindingPotential::calc_stacking_and_steric_terms(
     check_central_triplet_stacking_combos(cd_i, cd_j);
 }
 
-void JunctionBindingPotential::check_constraints(Domain* cd, int j) {
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_constraints(Domain* cd, int j) {
     for (int i: {-1, 0}) {
         Domain* cd_1 {*cd + i};
         Domain* cd_2 {*cd + (i + 1)};
-        if (not check_domains_exist_and_bound({cd_1, cd_2})) {
+        if (not check_domains_exist_and_bound(*m_states, {cd_1, cd_2})) {
             continue;
         }
-        Domain& cd_bound_1 {*cd_1->m_bound_domain};
-        Domain& cd_bound_2 {*cd_2->m_bound_domain};
+        Domain& cd_bound_1 {*m_states->bound_domain(cd_1)};
+        Domain& cd_bound_2 {*m_states->bound_domain(cd_2)};
         bool bound_same_chain {cd_bound_1.m_c == cd_bound_2.m_c};
         if (bound_same_chain) {
 
@@ -258,11 +373,11 @@ void JunctionBindingPotential::check_constraints(Domain* cd, int j) {
     Domain* cd_forw {*cd + 1};
 
     // Have not checked the middle triplet on the same chain
-    if (check_domains_exist_and_bound({cd_prev, cd_forw})) {
-        if (check_pair_stacked(cd, cd_forw)) {
-            if (check_pair_stacked(cd_prev, cd)) {
-                if (doubly_contiguous(cd_prev, cd) and
-                    doubly_contiguous(cd, cd_forw)) {
+    if (check_domains_exist_and_bound(*m_states, {cd_prev, cd_forw})) {
+        if (check_pair_stacked<DomainT>(*m_states, cd, cd_forw)) {
+            if (check_pair_stacked<DomainT>(*m_states, cd_prev, cd)) {
+                if (doubly_contiguous(*m_states, cd_prev, cd) and
+                    doubly_contiguous(*m_states, cd, cd_forw)) {
                     check_triply_contig_helix(cd_prev, cd, cd_forw);
                     if (m_constraints_violated) {
                         return;
@@ -277,18 +392,22 @@ void JunctionBindingPotential::check_constraints(Domain* cd, int j) {
     }
 }
 
-void JunctionBindingPotential::check_regular_pair_constraints(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_regular_pair_constraints(
         Domain* cd_1,
         Domain* cd_2,
         int i) {
 
-    VectorThree ndr {cd_2->m_pos - cd_1->m_pos};
-    if (not cd_1->check_kink_constraint(ndr, *cd_2)) {
+    Direction ndr {encode(m_states->pos(cd_2) - m_states->pos(cd_1))};
+    if (not DomainT::kink_obeyed(
+                ndr,
+                encode(m_states->ore(cd_1)),
+                encode(m_states->ore(cd_2)))) {
         m_constraints_violated = true;
         return;
     }
-    if (check_pair_stacked(cd_1, cd_2)) {
-        m_delta_config.e += m_pot.stacking_energy(*cd_1, *cd_2);
+    if (check_pair_stacked<DomainT>(*m_states, cd_1, cd_2)) {
+        m_delta_config.e += m_pot.pair_energies(*cd_1, *cd_2).stacking_energy;
         m_delta_config.stacked_pairs += 1;
         //cout << cd_1->m_c << " " << cd_1->m_d << ", " << cd_2->m_c << " "
         //     << cd_2->m_d << "\n";
@@ -311,7 +430,8 @@ void JunctionBindingPotential::check_regular_pair_constraints(
     }
 }
 
-void JunctionBindingPotential::check_doubly_contig_helix_pair(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_doubly_contig_helix_pair(
         Domain* cd_1,
         Domain* cd_2,
         int i,
@@ -323,13 +443,14 @@ void JunctionBindingPotential::check_doubly_contig_helix_pair(
     }
 
     // Twist constraint needs this to be checked first
-    VectorThree ndr {cd_2->m_pos - cd_1->m_pos};
-    if (ndr == cd_1->m_ore or ndr == -cd_1->m_ore) {
+    Direction ndr {encode(m_states->pos(cd_2) - m_states->pos(cd_1))};
+    Direction ore {encode(m_states->ore(cd_1))};
+    if (same(ndr, ore) or same(ndr, negate(ore))) {
         m_constraints_violated = true;
         return;
     }
-    if (cd_1->check_twist_constraint(ndr, *cd_2)) {
-        m_delta_config.e += m_pot.stacking_energy(*cd_1, *cd_2);
+    if (DomainT::twist_obeyed(ndr, ore, encode(m_states->ore(cd_2)))) {
+        m_delta_config.e += m_pot.pair_energies(*cd_1, *cd_2).stacking_energy;
         m_delta_config.stacked_pairs += 1;
         //cout << cd_1->m_c << " " << cd_1->m_d << ", " << cd_2->m_c << " "
         //     << cd_2->m_d << "\n";
@@ -348,7 +469,8 @@ void JunctionBindingPotential::check_doubly_contig_helix_pair(
     }
 }
 
-void JunctionBindingPotential::check_doubly_contig_junction_pair(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_doubly_contig_junction_pair(
         Domain* cd_1,
         Domain* cd_2,
         int j) {
@@ -359,10 +481,10 @@ void JunctionBindingPotential::check_doubly_contig_junction_pair(
     Domain* cd_j4;
     Domain* cd_k1 {cd_1};
     Domain* cd_k2 {cd_2};
-    VectorThree ndr {cd_k2->m_pos - cd_k1->m_pos};
+    VectorThree ndr {m_states->pos(cd_k2) - m_states->pos(cd_k1)};
 
     // They just have the crossover config
-    if (cd_k1->m_ore != ndr) {
+    if (m_states->ore(cd_k1) != ndr) {
         m_constraints_violated = true;
         return;
     }
@@ -380,24 +502,25 @@ void JunctionBindingPotential::check_doubly_contig_junction_pair(
     // or it is a helix, which means it is not possible as there cannot be a
     // triply conitigous set which is a helix with one pair and junction with
     // another.
-    vector<pair<Domain*, Domain*>> first_sel {};
+    DomainPairs first_sel {};
     first_sel.push_back({*cd_1 + -1, cd_1});
-    first_sel.push_back({*cd_1->m_bound_domain + 1, cd_1->m_bound_domain});
+    Domain* cd_1_bound {m_states->bound_domain(cd_1)};
+    first_sel.push_back({*cd_1_bound + 1, cd_1_bound});
     for (auto sel1: first_sel) {
         cd_j1 = sel1.first;
         cd_j2 = sel1.second;
         cd_j3 = cd_k2;
         cd_j4 = *cd_k2 + 1;
-        if (check_domains_exist_and_bound({cd_j4})) {
-            if (check_domains_exist_and_bound({cd_j1})) {
+        if (check_domains_exist_and_bound(*m_states, {cd_j4})) {
+            if (check_domains_exist_and_bound(*m_states, {cd_j1})) {
                 check_junction(cd_j1, cd_j2, cd_j3, cd_j4, cd_k1, cd_k2);
             }
         }
 
-        cd_j3 = cd_k2->m_bound_domain;
+        cd_j3 = m_states->bound_domain(cd_k2);
         cd_j4 = *cd_j3 + -1;
-        if (check_domains_exist_and_bound({cd_j4})) {
-            if (check_domains_exist_and_bound({cd_j1})) {
+        if (check_domains_exist_and_bound(*m_states, {cd_j4})) {
+            if (check_domains_exist_and_bound(*m_states, {cd_j1})) {
                 check_junction(cd_j1, cd_j2, cd_j3, cd_j4, cd_k1, cd_k2);
             }
         }
@@ -408,7 +531,8 @@ void JunctionBindingPotential::check_doubly_contig_junction_pair(
     // to
 }
 
-void JunctionBindingPotential::check_junction(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_junction(
         Domain* cd_j1,
         Domain* cd_j2,
         Domain* cd_j3,
@@ -430,30 +554,41 @@ void JunctionBindingPotential::check_junction(
         cd_j3 = hold;
     }
     // this is inefficient for three quarter domains
-    if (not(check_pair_stacked(cd_j1, cd_j2) and
-            check_pair_stacked(cd_j3, cd_j4))) {
+    if (not(check_pair_stacked<DomainT>(*m_states, cd_j1, cd_j2) and
+            check_pair_stacked<DomainT>(*m_states, cd_j3, cd_j4))) {
         return;
     }
-    if (not cd_j1->check_junction_constraint(
-                *cd_j2, *cd_j3, *cd_j4, *cd_k1, *cd_k2)) {
+    Direction ndr_1 {encode(m_states->pos(cd_j2) - m_states->pos(cd_j1))};
+    if (cd_j1->m_d > cd_j2->m_d) {
+        ndr_1 = negate(ndr_1);
+    }
+    if (not DomainT::junction_obeyed(
+                encode(m_states->pos(cd_k2) - m_states->pos(cd_k1)),
+                encode(m_states->ore(cd_k1)),
+                ndr_1,
+                encode(m_states->ore(cd_k2)))) {
         m_constraints_violated = true;
         return;
     }
     auto stacking_penalty {check_junction_stacking_penalty(
+            *m_states,
             *cd_j1, *cd_j2, *cd_j3, *cd_j4, *cd_k1, *cd_k2)};
     if (stacking_penalty == 1) {
-        m_delta_config.e -= m_pot.stacking_energy(*cd_j1, *cd_j2) / 2;
-        m_delta_config.e -= m_pot.stacking_energy(*cd_j3, *cd_j4) / 2;
+        m_delta_config.e -=
+                m_pot.pair_energies(*cd_j1, *cd_j2).stacking_energy / 2;
+        m_delta_config.e -=
+                m_pot.pair_energies(*cd_j3, *cd_j4).stacking_energy / 2;
         m_delta_config.stacked_pairs -= 1;
     }
     else if (stacking_penalty == 2) {
-        m_delta_config.e -= m_pot.stacking_energy(*cd_j1, *cd_j2);
-        m_delta_config.e -= m_pot.stacking_energy(*cd_j3, *cd_j4);
+        m_delta_config.e -= m_pot.pair_energies(*cd_j1, *cd_j2).stacking_energy;
+        m_delta_config.e -= m_pot.pair_energies(*cd_j3, *cd_j4).stacking_energy;
         m_delta_config.stacked_pairs -= 2;
     }
 }
 
-void JunctionBindingPotential::check_backward_triplet_stacking_combos(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_backward_triplet_stacking_combos(
         Domain* cd_1,
         Domain* cd_2,
         int i) {
@@ -463,17 +598,17 @@ void JunctionBindingPotential::check_backward_triplet_stacking_combos(
     Domain* cd_h3;
     cd_h2 = cd_1;
     cd_h3 = cd_2;
-    if (not check_pair_stacked(cd_h2, cd_h3)) {
+    if (not check_pair_stacked<DomainT>(*m_states, cd_h2, cd_h3)) {
         return;
     }
 
     // Check same chain
     cd_h1 = *cd_1 + -1;
 
-    bool h2_h3_doubly_contig {doubly_contiguous(cd_h2, cd_h3)};
-    if (check_domains_exist_and_bound({cd_h1})) {
-        bool h1_h2_doubly_contig {doubly_contiguous(cd_h1, cd_h2)};
-        if (check_pair_stacked(cd_h1, cd_h2)) {
+    bool h2_h3_doubly_contig {doubly_contiguous(*m_states, cd_h2, cd_h3)};
+    if (check_domains_exist_and_bound(*m_states, {cd_h1})) {
+        bool h1_h2_doubly_contig {doubly_contiguous(*m_states, cd_h1, cd_h2)};
+        if (check_pair_stacked<DomainT>(*m_states, cd_h1, cd_h2)) {
             if (h1_h2_doubly_contig and h2_h3_doubly_contig) {
                 check_triply_contig_helix(cd_h1, cd_h2, cd_h3);
                 if (m_constraints_violated) {
@@ -489,28 +624,30 @@ void JunctionBindingPotential::check_backward_triplet_stacking_combos(
 
     // Check helices that extend to bound chain
     Domain* cd_h2_prev {cd_h1};
-    cd_h1 = *(cd_1->m_bound_domain) + 1;
-    if (check_domains_exist_and_bound({cd_h1}) and
-            cd_h1->m_bound_domain != cd_h2_prev and
-            cd_h1->m_bound_domain != cd_h3) {
-        if (check_pair_stacked(cd_1->m_bound_domain, cd_h1)) {
+    Domain* cd_1_bound {m_states->bound_domain(cd_1)};
+    cd_h1 = *cd_1_bound + 1;
+    if (check_domains_exist_and_bound(*m_states, {cd_h1}) and
+            m_states->bound_domain(cd_h1) != cd_h2_prev and
+            m_states->bound_domain(cd_h1) != cd_h3) {
+        if (check_pair_stacked<DomainT>(*m_states, cd_1_bound, cd_h1)) {
             check_triplet_double_stacking(cd_h1, cd_h2, cd_h3);
         }
     }
-    cd_h1 = *(cd_1->m_bound_domain) + -1;
-    if (check_domains_exist_and_bound({cd_h1}) and
-            cd_h1->m_bound_domain != cd_h2_prev and
-            cd_h1->m_bound_domain != cd_h3) {
-        if (check_pair_stacked(cd_h1, cd_1->m_bound_domain)) {
+    cd_h1 = *cd_1_bound + -1;
+    if (check_domains_exist_and_bound(*m_states, {cd_h1}) and
+            m_states->bound_domain(cd_h1) != cd_h2_prev and
+            m_states->bound_domain(cd_h1) != cd_h3) {
+        if (check_pair_stacked<DomainT>(*m_states, cd_h1, cd_1_bound)) {
             check_triplet_double_stacking(cd_h1, cd_h2, cd_h3);
         }
         else {
-            check_triplet_single_stacking(cd_h1, cd_1->m_bound_domain, cd_h3);
+            check_triplet_single_stacking(cd_h1, cd_1_bound, cd_h3);
         }
     }
 }
 
-void JunctionBindingPotential::check_forward_triplet_stacking_combos(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_forward_triplet_stacking_combos(
         Domain* cd_1,
         Domain* cd_2,
         int i) {
@@ -520,16 +657,19 @@ void JunctionBindingPotential::check_forward_triplet_stacking_combos(
     Domain* cd_h3;
     cd_h2 = cd_2;
     cd_h1 = cd_1;
-    bool first_pair_stacked {check_pair_stacked(cd_h1, cd_h2)};
+    bool first_pair_stacked {
+            check_pair_stacked<DomainT>(*m_states, cd_h1, cd_h2)};
 
     // Check same chain
     cd_h3 = *(cd_2) + 1;
-    bool h1_h2_doubly_contig {doubly_contiguous(cd_h1, cd_h2)};
+    bool h1_h2_doubly_contig {doubly_contiguous(*m_states, cd_h1, cd_h2)};
 
-    if (check_domains_exist_and_bound({cd_h3})) {
-        bool second_pair_stacked {check_pair_stacked(cd_h2, cd_h3)};
+    if (check_domains_exist_and_bound(*m_states, {cd_h3})) {
+        bool second_pair_stacked {
+                check_pair_stacked<DomainT>(*m_states, cd_h2, cd_h3)};
         if (first_pair_stacked and second_pair_stacked) {
-            bool h2_h3_doubly_contig {doubly_contiguous(cd_h2, cd_h3)};
+            bool h2_h3_doubly_contig {
+                    doubly_contiguous(*m_states, cd_h2, cd_h3)};
             if (h1_h2_doubly_contig and h2_h3_doubly_contig) {
                 check_triply_contig_helix(cd_h1, cd_h2, cd_h3);
                 if (m_constraints_violated) {
@@ -545,11 +685,12 @@ void JunctionBindingPotential::check_forward_triplet_stacking_combos(
 
     // Check helices that extend to bound chain
     Domain* cd_h2_next {cd_h3};
-    cd_h3 = *(cd_2->m_bound_domain) + 1;
-    if (check_domains_exist_and_bound({cd_h3}) and
-            cd_h3->m_bound_domain != cd_h2_next and
-            cd_h3->m_bound_domain != cd_h1) {
-        if (check_pair_stacked(cd_2->m_bound_domain, cd_h3)) {
+    Domain* cd_2_bound {m_states->bound_domain(cd_2)};
+    cd_h3 = *cd_2_bound + 1;
+    if (check_domains_exist_and_bound(*m_states, {cd_h3}) and
+            m_states->bound_domain(cd_h3) != cd_h2_next and
+            m_states->bound_domain(cd_h3) != cd_h1) {
+        if (check_pair_stacked<DomainT>(*m_states, cd_2_bound, cd_h3)) {
             if (first_pair_stacked) {
                 check_triplet_double_stacking(cd_h1, cd_h2, cd_h3);
             }
@@ -558,11 +699,11 @@ void JunctionBindingPotential::check_forward_triplet_stacking_combos(
             }
         }
     }
-    cd_h3 = *(cd_2->m_bound_domain) + -1;
-    if (check_domains_exist_and_bound({cd_h3}) and
-            cd_h3->m_bound_domain != cd_h2_next and
-            cd_h3->m_bound_domain != cd_h1) {
-        if (check_pair_stacked(cd_h3, cd_2->m_bound_domain)) {
+    cd_h3 = *cd_2_bound + -1;
+    if (check_domains_exist_and_bound(*m_states, {cd_h3}) and
+            m_states->bound_domain(cd_h3) != cd_h2_next and
+            m_states->bound_domain(cd_h3) != cd_h1) {
+        if (check_pair_stacked<DomainT>(*m_states, cd_h3, cd_2_bound)) {
             if (first_pair_stacked) {
                 check_triplet_double_stacking(cd_h1, cd_h2, cd_h3);
             }
@@ -571,12 +712,13 @@ void JunctionBindingPotential::check_forward_triplet_stacking_combos(
             }
         }
         else if (first_pair_stacked) {
-            check_triplet_single_stacking(cd_h3, cd_2->m_bound_domain, cd_h1);
+            check_triplet_single_stacking(cd_h3, cd_2_bound, cd_h1);
         }
     }
 }
 
-void JunctionBindingPotential::check_central_triplet_stacking_combos(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_central_triplet_stacking_combos(
         Domain& cd_i,
         Domain& cd_j) {
 
@@ -587,11 +729,11 @@ void JunctionBindingPotential::check_central_triplet_stacking_combos(
     Domain* cd_h3;
     cd_h3 = cd_j + 1;
     Domain* cd_h2_next {cd_i + 1};
-    if (check_domains_exist_and_bound({cd_h1, cd_h3}) and
-        cd_h3->m_bound_domain != cd_h2_next and
-        (not doubly_contiguous(cd_h1, cd_h2))) {
-        if (check_pair_stacked(&cd_j, cd_h3)) {
-            if (check_pair_stacked(cd_h1, cd_h2)) {
+    if (check_domains_exist_and_bound(*m_states, {cd_h1, cd_h3}) and
+        m_states->bound_domain(cd_h3) != cd_h2_next and
+        (not doubly_contiguous(*m_states, cd_h1, cd_h2))) {
+        if (check_pair_stacked<DomainT>(*m_states, &cd_j, cd_h3)) {
+            if (check_pair_stacked<DomainT>(*m_states, cd_h1, cd_h2)) {
                 check_triplet_double_stacking(cd_h1, cd_h2, cd_h3);
             }
             else {
@@ -600,18 +742,18 @@ void JunctionBindingPotential::check_central_triplet_stacking_combos(
         }
     }
     cd_h3 = cd_j + -1;
-    if (check_domains_exist_and_bound({cd_h1, cd_h3}) and
-        cd_h3->m_bound_domain != cd_h1 and
-        (not doubly_contiguous(cd_h1, cd_h2))) {
-        if (check_pair_stacked(cd_h1, cd_h2)) {
-            if (check_pair_stacked(cd_h3, &cd_j)) {
+    if (check_domains_exist_and_bound(*m_states, {cd_h1, cd_h3}) and
+        m_states->bound_domain(cd_h3) != cd_h1 and
+        (not doubly_contiguous(*m_states, cd_h1, cd_h2))) {
+        if (check_pair_stacked<DomainT>(*m_states, cd_h1, cd_h2)) {
+            if (check_pair_stacked<DomainT>(*m_states, cd_h3, &cd_j)) {
                 check_triplet_double_stacking(cd_h1, cd_h2, cd_h3);
             }
             else {
                 check_triplet_single_stacking(cd_h3, &cd_j, cd_h1);
             }
         }
-        else if (check_pair_stacked(cd_h3, &cd_j)) {
+        else if (check_pair_stacked<DomainT>(*m_states, cd_h3, &cd_j)) {
             check_triplet_single_stacking(cd_h1, cd_h2, cd_h3);
         }
     }
@@ -620,20 +762,20 @@ void JunctionBindingPotential::check_central_triplet_stacking_combos(
     cd_h3 = cd_i + 1;
     cd_h1 = cd_j + 1;
     Domain* cd_h2_prev {cd_i + -1};
-    if (check_domains_exist_and_bound({cd_h1, cd_h3}) and
-        cd_h1->m_bound_domain != cd_h3 and
-        (not doubly_contiguous(cd_h2, cd_h3))) {
-        if (check_pair_stacked(&cd_j, cd_h1) and
-            check_pair_stacked(cd_h2, cd_h3)) {
+    if (check_domains_exist_and_bound(*m_states, {cd_h1, cd_h3}) and
+        m_states->bound_domain(cd_h1) != cd_h3 and
+        (not doubly_contiguous(*m_states, cd_h2, cd_h3))) {
+        if (check_pair_stacked<DomainT>(*m_states, &cd_j, cd_h1) and
+            check_pair_stacked<DomainT>(*m_states, cd_h2, cd_h3)) {
             check_triplet_double_stacking(cd_h1, cd_h2, cd_h3);
         }
     }
     cd_h1 = cd_j + -1;
-    if (check_domains_exist_and_bound({cd_h1, cd_h3}) and
-        cd_h1->m_bound_domain != cd_h2_prev and
-        (not doubly_contiguous(cd_h2, cd_h3))) {
-        if (check_pair_stacked(cd_h2, cd_h3)) {
-            if (check_pair_stacked(cd_h1, &cd_j)) {
+    if (check_domains_exist_and_bound(*m_states, {cd_h1, cd_h3}) and
+        m_states->bound_domain(cd_h1) != cd_h2_prev and
+        (not doubly_contiguous(*m_states, cd_h2, cd_h3))) {
+        if (check_pair_stacked<DomainT>(*m_states, cd_h2, cd_h3)) {
+            if (check_pair_stacked<DomainT>(*m_states, cd_h1, &cd_j)) {
                 check_triplet_double_stacking(cd_h1, cd_h2, cd_h3);
             }
             else {
@@ -643,7 +785,8 @@ void JunctionBindingPotential::check_central_triplet_stacking_combos(
     }
 }
 
-void JunctionBindingPotential::check_backward_single_junction(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_backward_single_junction(
         Domain* cd_1,
         Domain* cd_2) {
 
@@ -656,33 +799,35 @@ void JunctionBindingPotential::check_backward_single_junction(
     Domain* cd_k2;
 
     // Find possible kink pair combinations
-    vector<pair<Domain*, Domain*>> first_sel {};
+    DomainPairs first_sel {};
 
     // Add kink pair that is the same chain as the first junction pair
     Domain* cd_j3_bac {cd_j3->m_backward_domain};
     first_sel.push_back({cd_j3, cd_j3_bac});
 
     // Add kink pairs that are on the chain bound to j3
-    Domain* cd_j3_bound {cd_j3->m_bound_domain};
-    Domain* cd_j4_bound {cd_j4->m_bound_domain};
+    Domain* cd_j3_bound {m_states->bound_domain(cd_j3)};
+    Domain* cd_j4_bound {m_states->bound_domain(cd_j4)};
     Domain* cd_j3_bound_for {cd_j3_bound->m_forward_domain};
     Domain* cd_j3_bound_bac {cd_j3_bound->m_backward_domain};
 
     // Only one direction if doubly contig helix
-    if (cd_j3_bound_for == cd_j4->m_bound_domain) {
+    if (cd_j3_bound_for == m_states->bound_domain(cd_j4)) {
         first_sel.push_back({cd_j3_bound, cd_j3_bound_bac});
     }
 
     // Otherwise have to consider possibily of next pair being doubly contig
     // Will already be included with the same chain above
     else if (
-            check_domains_exist_and_bound({cd_j3_bac, cd_j3_bound_bac}) and
-            cd_j3_bac->m_bound_domain == cd_j3_bound_bac) {
+            check_domains_exist_and_bound(
+                    *m_states, {cd_j3_bac, cd_j3_bound_bac}) and
+            m_states->bound_domain(cd_j3_bac) == cd_j3_bound_bac) {
         first_sel.push_back({cd_j3_bound, cd_j3_bound_for});
     }
     else if (
-            check_domains_exist_and_bound({cd_j3_bac, cd_j3_bound_for}) and
-            cd_j3_bac->m_bound_domain == cd_j3_bound_for) {
+            check_domains_exist_and_bound(
+                    *m_states, {cd_j3_bac, cd_j3_bound_for}) and
+            m_states->bound_domain(cd_j3_bac) == cd_j3_bound_for) {
         first_sel.push_back({cd_j3_bound, cd_j3_bound_bac});
     }
     else {
@@ -692,17 +837,17 @@ void JunctionBindingPotential::check_backward_single_junction(
     for (auto sel1: first_sel) {
         cd_k2 = sel1.first;
         cd_k1 = sel1.second;
-        if (not check_domains_exist_and_bound({cd_k1})) {
+        if (not check_domains_exist_and_bound(*m_states, {cd_k1})) {
             continue;
         }
 
         // If kink is stacked, not a kink
-        if (check_pair_stacked(cd_k1, cd_k2)) {
+        if (check_pair_stacked<DomainT>(*m_states, cd_k1, cd_k2)) {
             continue;
         }
 
         // Find possible second junction pairs
-        vector<pair<Domain*, Domain*>> second_sel {};
+        DomainPairs second_sel {};
 
         // Add junction that is on the same chain as the kink pair
         int dir {cd_k1->m_d - cd_k2->m_d};
@@ -710,13 +855,13 @@ void JunctionBindingPotential::check_backward_single_junction(
         second_sel.push_back({cd_k1, cd_k1_next});
 
         // Add junction pairs that are on chain bound to k2
-        Domain* cd_k1_bound {cd_k1->m_bound_domain};
+        Domain* cd_k1_bound {m_states->bound_domain(cd_k1)};
         Domain* cd_k1_bound_for {cd_k1_bound->m_forward_domain};
         Domain* cd_k1_bound_bac {cd_k1_bound->m_backward_domain};
-        if (check_domains_exist_and_bound({cd_k1_next})) {
+        if (check_domains_exist_and_bound(*m_states, {cd_k1_next})) {
 
             // Prevent double counting
-            Domain* cd_k1_next_bound {cd_k1_next->m_bound_domain};
+            Domain* cd_k1_next_bound {m_states->bound_domain(cd_k1_next)};
             if (cd_k1_bound_for != cd_k1_next_bound) {
                 second_sel.push_back({cd_k1_bound, cd_k1_bound_for});
             }
@@ -731,7 +876,7 @@ void JunctionBindingPotential::check_backward_single_junction(
         for (auto sel2: second_sel) {
             cd_j2 = sel2.first;
             cd_j1 = sel2.second;
-            if (not check_domains_exist_and_bound({cd_j1})) {
+            if (not check_domains_exist_and_bound(*m_states, {cd_j1})) {
                 continue;
             }
             check_junction(cd_j1, cd_j2, cd_j3, cd_j4, cd_k1, cd_k2);
@@ -739,7 +884,8 @@ void JunctionBindingPotential::check_backward_single_junction(
     }
 }
 
-void JunctionBindingPotential::check_forward_single_junction(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_forward_single_junction(
         Domain* cd_1,
         Domain* cd_2) {
 
@@ -752,15 +898,15 @@ void JunctionBindingPotential::check_forward_single_junction(
     Domain* cd_k2;
 
     // Find possible kink pair combinations
-    vector<pair<Domain*, Domain*>> first_sel {};
+    DomainPairs first_sel {};
 
     // Add kink pair that is the same chain as the first junction pair
     Domain* cd_j2_for {cd_j2->m_forward_domain};
     first_sel.push_back({cd_j2, cd_j2_for});
 
     // Add kink pairs that are on the chain bound to j2
-    Domain* cd_j1_bound {cd_j1->m_bound_domain};
-    Domain* cd_j2_bound {cd_j2->m_bound_domain};
+    Domain* cd_j1_bound {m_states->bound_domain(cd_j1)};
+    Domain* cd_j2_bound {m_states->bound_domain(cd_j2)};
     Domain* cd_j2_bound_for {cd_j2_bound->m_forward_domain};
     Domain* cd_j2_bound_bac {cd_j2_bound->m_backward_domain};
 
@@ -772,13 +918,15 @@ void JunctionBindingPotential::check_forward_single_junction(
     // Otherwise have to consider possibily of next pair being doubly contig
     // Will already be included with the same chain above
     else if (
-            check_domains_exist_and_bound({cd_j2_for, cd_j2_bound_bac}) and
-            cd_j2_for->m_bound_domain == cd_j2_bound_bac) {
+            check_domains_exist_and_bound(
+                    *m_states, {cd_j2_for, cd_j2_bound_bac}) and
+            m_states->bound_domain(cd_j2_for) == cd_j2_bound_bac) {
         first_sel.push_back({cd_j2_bound, cd_j2_bound_for});
     }
     else if (
-            check_domains_exist_and_bound({cd_j2_for, cd_j2_bound_for}) and
-            cd_j2_for->m_bound_domain == cd_j2_bound_for) {
+            check_domains_exist_and_bound(
+                    *m_states, {cd_j2_for, cd_j2_bound_for}) and
+            m_states->bound_domain(cd_j2_for) == cd_j2_bound_for) {
         first_sel.push_back({cd_j2_bound, cd_j2_bound_bac});
     }
     else {
@@ -788,17 +936,17 @@ void JunctionBindingPotential::check_forward_single_junction(
     for (auto sel1: first_sel) {
         cd_k1 = sel1.first;
         cd_k2 = sel1.second;
-        if (not check_domains_exist_and_bound({cd_k2})) {
+        if (not check_domains_exist_and_bound(*m_states, {cd_k2})) {
             continue;
         }
 
         // If kink is stacked, not a kink
-        if (check_pair_stacked(cd_k1, cd_k2)) {
+        if (check_pair_stacked<DomainT>(*m_states, cd_k1, cd_k2)) {
             continue;
         }
 
         // Find possible second junction pairs
-        vector<pair<Domain*, Domain*>> second_sel {};
+        DomainPairs second_sel {};
 
         // Add junction that is on the same chain as the kink pair
         int dir {cd_k2->m_d - cd_k1->m_d};
@@ -806,13 +954,13 @@ void JunctionBindingPotential::check_forward_single_junction(
         second_sel.push_back({cd_k2, cd_k2_next});
 
         // Add junction pairs that are on chain bound to k2
-        Domain* cd_k2_bound {cd_k2->m_bound_domain};
+        Domain* cd_k2_bound {m_states->bound_domain(cd_k2)};
         Domain* cd_k2_bound_for {cd_k2_bound->m_forward_domain};
         Domain* cd_k2_bound_bac {cd_k2_bound->m_backward_domain};
-        if (check_domains_exist_and_bound({cd_k2_next})) {
+        if (check_domains_exist_and_bound(*m_states, {cd_k2_next})) {
 
             // Prevent double counting
-            Domain* cd_k2_next_bound {cd_k2_next->m_bound_domain};
+            Domain* cd_k2_next_bound {m_states->bound_domain(cd_k2_next)};
             if (cd_k2_bound_for != cd_k2_next_bound) {
                 second_sel.push_back({cd_k2_bound, cd_k2_bound_for});
             }
@@ -827,7 +975,7 @@ void JunctionBindingPotential::check_forward_single_junction(
         for (auto sel2: second_sel) {
             cd_j3 = sel2.first;
             cd_j4 = sel2.second;
-            if (not check_domains_exist_and_bound({cd_j4})) {
+            if (not check_domains_exist_and_bound(*m_states, {cd_j4})) {
                 continue;
             }
             check_junction(cd_j1, cd_j2, cd_j3, cd_j4, cd_k1, cd_k2);
@@ -835,7 +983,8 @@ void JunctionBindingPotential::check_forward_single_junction(
     }
 }
 
-void JunctionBindingPotential::check_central_single_junction(
+template <typename DomainT>
+void JunctionBindingPotential<DomainT>::check_central_single_junction(
         Domain* cd_1,
         Domain* cd_2) {
 
@@ -848,27 +997,28 @@ void JunctionBindingPotential::check_central_single_junction(
     Domain* cd_k2 {cd_2};
 
     // Kinked pair cannot be doubly contiguous
-    if (cd_k1->m_bound_domain->m_c == cd_k2->m_bound_domain->m_c and
-        abs(cd_k1->m_bound_domain->m_d - cd_k2->m_bound_domain->m_d) == 1) {
+    Domain* cd_k1_bound {m_states->bound_domain(cd_k1)};
+    Domain* cd_k2_bound {m_states->bound_domain(cd_k2)};
+    if (cd_k1_bound->m_c == cd_k2_bound->m_c and
+        abs(cd_k1_bound->m_d - cd_k2_bound->m_d) == 1) {
         return;
     }
 
     // Find possible first junction pairs
-    vector<pair<Domain*, Domain*>> first_sel {};
+    DomainPairs first_sel {};
 
     // Add first junction pair that is on the same chain as the kink pair
     Domain* cd_k1_bac {cd_k1->m_backward_domain};
     first_sel.push_back({cd_k1, cd_k1_bac});
 
     // Add first junction pairs bound to k1
-    Domain* cd_k1_bound {cd_k1->m_bound_domain};
     Domain* cd_k1_bound_for {cd_k1_bound->m_forward_domain};
     Domain* cd_k1_bound_bac {cd_k1_bound->m_backward_domain};
-    if (check_domains_exist_and_bound({cd_k1_bac})) {
+    if (check_domains_exist_and_bound(*m_states, {cd_k1_bac})) {
 
         // If j1 and j2 are doubly contiguous, then this will be double
         // counted
-        Domain* cd_k1_bac_bound {cd_k1_bac->m_bound_domain};
+        Domain* cd_k1_bac_bound {m_states->bound_domain(cd_k1_bac)};
         if (cd_k1_bound_for != cd_k1_bac_bound) {
             first_sel.push_back({cd_k1_bound, cd_k1_bound_for});
         }
@@ -883,26 +1033,25 @@ void JunctionBindingPotential::check_central_single_junction(
     for (auto sel1: first_sel) {
         cd_j2 = sel1.first;
         cd_j1 = sel1.second;
-        if (not check_domains_exist_and_bound({cd_j1})) {
+        if (not check_domains_exist_and_bound(*m_states, {cd_j1})) {
             continue;
         }
 
         // Find possible second junction pairs
-        vector<pair<Domain*, Domain*>> second_sel {};
+        DomainPairs second_sel {};
 
         // Add junction pair that is on the same chain as the kink pair
         Domain* cd_k2_for {cd_k2->m_forward_domain};
         second_sel.push_back({cd_k2, cd_k2_for});
 
         // Add junction pairs that are on chain bound to k2
-        Domain* cd_k2_bound {cd_k2->m_bound_domain};
         Domain* cd_k2_bound_for {cd_k2_bound->m_forward_domain};
         Domain* cd_k2_bound_bac {cd_k2_bound->m_backward_domain};
-        if (check_domains_exist_and_bound({cd_k2_for})) {
+        if (check_domains_exist_and_bound(*m_states, {cd_k2_for})) {
 
             // If j3 and j4 are doubly contiguous, then this will be double
             // counted
-            Domain* cd_k2_for_bound {cd_k2_for->m_bound_domain};
+            Domain* cd_k2_for_bound {m_states->bound_domain(cd_k2_for)};
             if (cd_k2_bound_for != cd_k2_for_bound) {
                 second_sel.push_back({cd_k2_bound, cd_k2_bound_for});
             }
@@ -917,7 +1066,7 @@ void JunctionBindingPotential::check_central_single_junction(
         for (auto sel2: second_sel) {
             cd_j3 = sel2.first;
             cd_j4 = sel2.second;
-            if (not check_domains_exist_and_bound({cd_j4})) {
+            if (not check_domains_exist_and_bound(*m_states, {cd_j4})) {
                 continue;
             }
             check_junction(cd_j1, cd_j2, cd_j3, cd_j4, cd_k1, cd_k2);
@@ -925,18 +1074,52 @@ void JunctionBindingPotential::check_central_single_junction(
     }
 }
 
+template class JunctionBindingPotential<HalfTurnDomain>;
+template class JunctionBindingPotential<ThreeQuarterTurnDomain>;
+
+PairEnergyTable::PairEnergyTable(const vector<vector<int>>& identities) {
+    int min_ident {0};
+    int max_ident {0};
+    for (auto& c_idents: identities) {
+        for (auto d_ident: c_idents) {
+            min_ident = std::min(min_ident, d_ident);
+            max_ident = std::max(max_ident, d_ident);
+        }
+    }
+    m_min_ident = min_ident;
+    m_width = max_ident - min_ident + 1;
+    m_entries.resize(m_width * m_width);
+    m_data = m_entries.data();
+}
+
+void PairEnergyTable::use_mapped_entries(
+        const PairEnergies* entries,
+        std::shared_ptr<const char> mapping) {
+
+    // Mapped read only, which the non-const accessors never write after
+    m_data = const_cast<PairEnergies*>(entries);
+    m_mapping = mapping;
+    vector<PairEnergies> {}.swap(m_entries);
+}
+
 MisbindingPotential::MisbindingPotential(OrigamiPotential& pot): m_pot {pot} {}
 
-double OpposingMisbindingPotential::bind_domains(Domain& cd_i, Domain& cd_j) {
+double OpposingMisbindingPotential::bind_domains(
+        const TrialStates& states,
+        Domain& cd_i,
+        Domain& cd_j) {
     m_constraints_violated = true;
-    if (not check_domain_orientations_opposing(cd_i, cd_j)) {
+    if (not check_domain_orientations_opposing(states, cd_i, cd_j)) {
         return 0;
     }
     m_constraints_violated = false;
-    return m_pot.hybridization_energy(cd_i, cd_j);
+    return m_pot.pair_energies(cd_i, cd_j).hyb_energy;
 }
 
-double DisallowedMisbindingPotential::bind_domains(Domain&, Domain&) {
+double DisallowedMisbindingPotential::bind_domains(
+        const TrialStates&,
+        Domain&,
+        Domain&) {
     m_constraints_violated = true;
     return 0;
 }
@@ -956,13 +1139,24 @@ OrigamiPotential::OrigamiPotential(
         m_complementary_entropies {entropies},
         m_stacking_pot {params.m_stacking_pot},
         m_hybridization_pot {params.m_hybridization_pot},
-        m_apply_mean_field_cor {params.m_apply_mean_field_cor} {
+        m_apply_mean_field_cor {params.m_apply_mean_field_cor},
+        m_analytic_energies {params.m_analytic_energies},
+        m_ref_temp {params.m_temp} {
 
-    if (params.m_binding_pot == "FourBody") {
-        m_binding_pot = new JunctionBindingPotential(*this);
+    // The binding potential is specialized on the domain model here, once
+    if (params.m_binding_pot != "FourBody") {
+        std::cout << "No such binding potential";
+    }
+    else if (params.m_domain_type == "HalfTurn") {
+        m_binding_pot = new JunctionBindingPotential<HalfTurnDomain>(*this);
+    }
+    else if (params.m_domain_type == "ThreeQuarterTurn") {
+        m_binding_pot =
+                new JunctionBindingPotential<ThreeQuarterTurnDomain>(*this);
     }
     else {
-        std::cout << "No such binding potential";
+        cout << "Unknown domain type " << params.m_domain_type << "\n";
+        throw OrigamiMisuse {};
     }
 
     if (params.m_misbinding_pot == "Opposing") {
@@ -990,7 +1184,7 @@ OrigamiPotential::OrigamiPotential(
         m_misbinding_s = params.m_misbinding_s;
     }
 
-    get_energies();
+    m_energies = &energy_tables(m_temp, 1);
 }
 
 OrigamiPotential::~OrigamiPotential() {
@@ -999,92 +1193,196 @@ OrigamiPotential::~OrigamiPotential() {
 }
 
 void OrigamiPotential::update_temp(double temp, double stacking_mult) {
-
-    // Update hybridization and stacking energy tables
     m_temp = temp;
-    pair<double, double> key {temp, stacking_mult};
-    if (m_stacking_energy_tables.count(key) == 0) {
-
-        // THIS ONLY WORKS FOR CONSTANT STACKING
-        double old_stacking_ene {m_stacking_ene};
-        m_stacking_ene *= stacking_mult;
-        get_energies();
-        m_stacking_ene = old_stacking_ene;
-        m_hybridization_energy_tables[temp] = m_hybridization_energies;
-        m_hybridization_enthalpy_tables[temp] = m_hybridization_enthalpies;
-        m_hybridization_entropy_tables[temp] = m_hybridization_entropies;
-        m_stacking_energy_tables[key] = m_stacking_energies;
+    if (m_analytic_energies) {
+
+        // Reduced enthalpies go as 1/T and entropies are constant, as are
+        // sequence specific stacking energies
+        m_enthalpy_scale = m_ref_temp / temp;
+        if (m_stacking_pot == "Constant") {
+            m_stacking_scale = m_enthalpy_scale * stacking_mult;
+        }
     }
     else {
-        m_hybridization_energies = m_hybridization_energy_tables[temp];
-        m_hybridization_enthalpies = m_hybridization_enthalpy_tables[temp];
-        m_hybridization_entropies = m_hybridization_entropy_tables[temp];
-        m_stacking_energies = m_stacking_energy_tables[key];
+        m_energies = &energy_tables(temp, stacking_mult);
     }
 }
 
-void OrigamiPotential::get_energies() {
-    // Get S, H, and G for all possible interactions and store
-    /*if (m_energy_filebase.size() != 0) {
-        if (not read_energies_from_file()) {
-            calc_energies();
+void OrigamiPotential::precompute_energy_tables(
+        const vector<double>& temps,
+        const vector<double>& stacking_mults) {
+
+    if (m_analytic_energies) {
+        return;
+    }
+    for (size_t i {0}; i != temps.size(); i++) {
+        double stacking_mult {stacking_mults.empty() ? 1 : stacking_mults[i]};
+        energy_tables(temps[i], stacking_mult);
+    }
+}
+
+EnergyTables& OrigamiPotential::energy_tables(
+        double temp,
+        double stacking_mult) {
+
+    pair<double, double> key {temp, stacking_mult};
+    auto tables_it {m_energy_tables.find(key)};
+    if (tables_it != m_energy_tables.end()) {
+        return *tables_it->second;
+    }
+
+    // Calculations work on the current tables at the current temperature
+    EnergyTables* current_tables {m_energies};
+    double current_temp {m_temp};
+    double current_stacking_ene {m_stacking_ene};
+    m_temp = temp;
+
+    // THIS ONLY WORKS FOR CONSTANT STACKING
+    m_stacking_ene *= stacking_mult;
+
+    // Only one potential calculates any given tables, the rest share them
+    {
+        std::lock_guard<std::mutex> lock {shared_tables_mutex};
+        uint64_t cache_key {energy_cache_key()};
+        std::shared_ptr<EnergyTables> tables {shared_tables[cache_key].lock()};
+        if (not tables) {
+            tables = std::make_shared<EnergyTables>();
+            tables->pairs = PairEnergyTable {m_identities};
+            m_energies = tables.get();
+            get_energies();
+            shared_tables[cache_key] = tables;
         }
+        m_energy_tables[key] = tables;
+    }
+    m_energies = current_tables;
+    m_temp = current_temp;
+    m_stacking_ene = current_stacking_ene;
+
+    return *m_energy_tables[key];
+}
+
+void OrigamiPotential::get_energies() {
+    // Get S, H, and G for all possible interactions and store, reusing
+    // the tables of an earlier run of the same system if there are any
+    if (m_energy_filebase.size() == 0) {
+        calc_energies();
+        return;
+    }
+    uint64_t key {energy_cache_key()};
+    string filename {energy_cache_filename(key)};
+    if (read_energies_from_file(filename, key)) {
+        return;
+    }
+
+    // Processes starting together wait here for the first one to write the
+    // file rather than all calculating the same tables
+    utility::FileLock lock {filename + ".lock"};
+    if (not read_energies_from_file(filename, key)) {
+        calc_energies();
+        write_energies_to_file(filename, key);
+
+        // Read back so that this process shares the mapped copy too
+        read_energies_from_file(filename, key);
     }
-    else {
-    */
-    calc_energies();
-    //}
 }
 
 void OrigamiPotential::calc_energies() {
     // Calculate S, H, and G for all possible interactions and store
 
     ThermoOfHybrid DH_DS {nearestNeighbour::calc_unitless_init_thermo(m_temp)};
-    m_init_enthalpy = DH_DS.enthalpy;
-    m_init_entropy = DH_DS.entropy;
-    m_init_energy = m_init_enthalpy - m_init_entropy;
-
-    // Loop through all pairs of sequences
-    for (size_t c_i {0}; c_i != m_identities.size(); c_i++) {
-        for (size_t c_j {0}; c_j != m_identities.size(); c_j++) {
-            size_t c_i_length {m_identities[c_i].size()};
-            size_t c_j_length {m_identities[c_j].size()};
-            for (size_t d_i {0}; d_i != c_i_length; d_i++) {
-                int d_i_ident {m_identities[c_i][d_i]};
-                for (size_t d_j {0}; d_j != c_j_length; d_j++) {
-                    int d_j_ident {m_identities[c_j][d_j]};
-                    pair<int, int> key {d_i_ident, d_j_ident};
-                    if (m_hybridization_pot == "NearestNeighbour") {
-                        string seq_i {m_sequences[c_i][d_i]};
-                        string seq_j {m_sequences[c_j][d_j]};
-                        calc_hybridization_energy(seq_i, seq_j, key);
-                    }
-                    else if (m_hybridization_pot == "Uniform") {
-                        calc_hybridization_energy(key);
-                    }
-                    else if (m_hybridization_pot == "Specified") {
-                        set_hybridization_energy(key);
-                    }
-                    else {
-                        std::cout << "No such hybridization potential";
-                    }
-
-                    if (m_stacking_pot == "SequenceSpecific") {
-                        string seq_i {m_sequences[c_i][d_i]};
-                        string seq_j {m_sequences[c_j][d_j]};
-                        calc_stacking_energy(seq_i, seq_j, key);
-                    }
-                    else if (m_stacking_pot == "Constant") {
-                        calc_stacking_energy(key);
-                    }
-                    else {
-                        std::cout << "No such stacking potential";
-                    }
+    m_energies->init_enthalpy = DH_DS.enthalpy;
+    m_energies->init_entropy = DH_DS.entropy;
+    m_energies->init_energy = DH_DS.enthalpy - DH_DS.entropy;
+
+    // Loop through all pairs of identities; an identity may appear on more
+    // than one chain but only needs to be calculated once
+    if (m_unique_domains.empty()) {
+        std::set<int> seen_idents {};
+        for (size_t c_i {0}; c_i != m_identities.size(); c_i++) {
+            for (size_t d_i {0}; d_i != m_identities[c_i].size(); d_i++) {
+                if (seen_idents.insert(m_identities[c_i][d_i]).second) {
+                    m_unique_domains.push_back({c_i, d_i});
                 }
             }
         }
     }
-    write_energies_to_file();
+    for (auto domain_i: m_unique_domains) {
+        size_t c_i {domain_i.first};
+        size_t d_i {domain_i.second};
+        int d_i_ident {m_identities[c_i][d_i]};
+        for (auto domain_j: m_unique_domains) {
+            size_t c_j {domain_j.first};
+            size_t d_j {domain_j.second};
+            int d_j_ident {m_identities[c_j][d_j]};
+            pair<int, int> key {d_i_ident, d_j_ident};
+            if (m_hybridization_pot == "NearestNeighbour") {
+                string seq_i {m_sequences[c_i][d_i]};
+                string seq_j {m_sequences[c_j][d_j]};
+                calc_hybridization_energy(seq_i, seq_j, key);
+            }
+            else if (m_hybridization_pot == "Uniform") {
+                calc_hybridization_energy(key);
+            }
+            else if (m_hybridization_pot == "Specified") {
+                set_hybridization_energy(key);
+            }
+            else {
+                std::cout << "No such hybridization potential";
+            }
+
+            if (m_stacking_pot == "SequenceSpecific") {
+                string seq_i {m_sequences[c_i][d_i]};
+                string seq_j {m_sequences[c_j][d_j]};
+                calc_stacking_energy(seq_i, seq_j, key);
+            }
+            else if (m_stacking_pot == "Constant") {
+                calc_stacking_energy(key);
+            }
+            else {
+                std::cout << "No such stacking potential";
+            }
+        }
+    }
+}
+
+const vector<ThermoOfHybrid>& OrigamiPotential::comp_seq_thermos(
+        string seq_i,
+        string seq_j,
+        pair<int, int> key) {
+
+    auto thermos_it {m_comp_seq_thermos.find(key)};
+    if (thermos_it != m_comp_seq_thermos.end()) {
+        return thermos_it->second;
+    }
+    vector<string> comp_seqs {
+            nearestNeighbour::find_longest_contig_complement(seq_i, seq_j)};
+    if (comp_seqs.size() != 0) {
+        if (key.first == -key.second) {
+
+            // Check that sequences are complementary if they should be
+            if (comp_seqs[0].size() != seq_i.size() and
+                seq_i.size() == seq_j.size()) {
+                cout << "Sequences that should be complementary are not\n";
+                throw OrigamiMisuse {};
+            }
+        }
+
+        // Check that sequences are not complementary if they shouldn't be
+        else {
+            if (comp_seqs[0].size() == seq_i.size() and
+                seq_i.size() == seq_j.size()) {
+                cout << "Sequences that should not be complementary are\n";
+                throw OrigamiMisuse {};
+            }
+        }
+    }
+    vector<ThermoOfHybrid>& thermos {m_comp_seq_thermos[key]};
+    for (auto comp_seq: comp_seqs) {
+        thermos.push_back(nearestNeighbour::calc_hybridization_H_and_S(
+                comp_seq, m_cation_M));
+    }
+
+    return thermos;
 }
 
 void OrigamiPotential::calc_hybridization_energy(
@@ -1094,24 +1392,23 @@ void OrigamiPotential::calc_hybridization_energy(
 
     double H_hyb {0};
     double S_hyb {0};
-    vector<string> comp_seqs {
-            nearestNeighbour::find_longest_contig_complement(seq_i, seq_j)};
+    const vector<ThermoOfHybrid>& thermos {
+            comp_seq_thermos(seq_i, seq_j, key)};
     int N {0};
 
     // No interaction if no complementary sequence
-    if (comp_seqs.size() == 0) {
+    if (thermos.size() == 0) {
         H_hyb = 0;
         S_hyb = 0;
     }
     else {
 
         // Take average value of H and S of all equal length comp seqs
-        for (auto comp_seq: comp_seqs) {
+        for (auto thermo: thermos) {
             ThermoOfHybrid DH_DS {
-                    nearestNeighbour::calc_unitless_hybridization_thermo(
-                            comp_seq, m_temp, m_cation_M)};
-            H_hyb += DH_DS.enthalpy - m_init_enthalpy;
-            S_hyb += DH_DS.entropy - m_init_entropy;
+                    nearestNeighbour::calc_unitless_thermo(thermo, m_temp)};
+            H_hyb += DH_DS.enthalpy - m_energies->init_enthalpy;
+            S_hyb += DH_DS.entropy - m_energies->init_entropy;
             N++;
         }
         H_hyb /= N;
@@ -1119,32 +1416,15 @@ void OrigamiPotential::calc_hybridization_energy(
 
         S_hyb += log(6);
 
-        if (key.first == -key.second) {
-            if (m_apply_mean_field_cor) {
-                S_hyb += 3 * log(6);
-            }
-
-            // Check that sequences are complementary if they should be
-            if (comp_seqs[0].size() != seq_i.size() and
-                seq_i.size() == seq_j.size()) {
-                cout << "Sequences that should be complementary are not\n";
-                throw OrigamiMisuse {};
-            }
-        }
-
-        // Check that sequences are not complementary if they shouldn't be
-        else {
-            if (comp_seqs[0].size() == seq_i.size() and
-                seq_i.size() == seq_j.size()) {
-                cout << "Sequences that should not be complementary are\n";
-                throw OrigamiMisuse {};
-            }
+        if (key.first == -key.second and m_apply_mean_field_cor) {
+            S_hyb += 3 * log(6);
         }
     }
 
-    m_hybridization_enthalpies[key] = H_hyb;
-    m_hybridization_entropies[key] = S_hyb;
-    m_hybridization_energies[key] = H_hyb - S_hyb;
+    PairEnergies& energies {m_energies->pairs(key.first, key.second)};
+    energies.hyb_enthalpy = H_hyb;
+    energies.hyb_entropy = S_hyb;
+    energies.hyb_energy = H_hyb - S_hyb;
 }
 
 void OrigamiPotential::calc_hybridization_energy(pair<int, int> key) {
@@ -1164,9 +1444,10 @@ void OrigamiPotential::calc_hybridization_energy(pair<int, int> key) {
 
     S_hyb += log(6);
 
-    m_hybridization_enthalpies[key] = H_hyb;
-    m_hybridization_entropies[key] = S_hyb;
-    m_hybridization_energies[key] = H_hyb - S_hyb;
+    PairEnergies& energies {m_energies->pairs(key.first, key.second)};
+    energies.hyb_enthalpy = H_hyb;
+    energies.hyb_entropy = S_hyb;
+    energies.hyb_energy = H_hyb - S_hyb;
 }
 
 void OrigamiPotential::set_hybridization_energy(pair<int, int> key) {
@@ -1187,9 +1468,10 @@ void OrigamiPotential::set_hybridization_energy(pair<int, int> key) {
 
     S_hyb += log(6);
 
-    m_hybridization_enthalpies[key] = H_hyb;
-    m_hybridization_entropies[key] = S_hyb;
-    m_hybridization_energies[key] = H_hyb - S_hyb;
+    PairEnergies& energies {m_energies->pairs(key.first, key.second)};
+    energies.hyb_enthalpy = H_hyb;
+    energies.hyb_entropy = S_hyb;
+    energies.hyb_energy = H_hyb - S_hyb;
 }
 
 void OrigamiPotential::calc_stacking_energy(
@@ -1199,96 +1481,154 @@ void OrigamiPotential::calc_stacking_energy(
 
     double s_energy {nearestNeighbour::calc_seq_spec_stacking_energy(
             seq_i, seq_j, m_temp, m_cation_M)};
-    m_stacking_energies[key] = s_energy;
+    m_energies->pairs(key.first, key.second).stacking_energy = s_energy;
 }
 
 void OrigamiPotential::calc_stacking_energy(pair<int, int> key) {
-    m_stacking_energies[key] = m_stacking_ene / m_temp;
+    m_energies->pairs(key.first, key.second).stacking_energy =
+            m_stacking_ene / m_temp;
 }
 
-bool OrigamiPotential::read_energies_from_file() {
+uint64_t OrigamiPotential::energy_cache_key() const {
 
-    // Read energies from file, return false if not present
-    string temp_string {"_" + std::to_string(static_cast<int>(m_temp))};
+    // Everything the tables are calculated from
+    ContentHash hash {};
+    hash.add(c_energy_cache_version);
+    hash.add(m_identities.size());
+    for (auto& c_idents: m_identities) {
+        hash.add(c_idents.size());
+        for (auto d_ident: c_idents) {
+            hash.add(d_ident);
+        }
+    }
+    hash.add(m_sequences.size());
+    for (auto& c_seqs: m_sequences) {
+        hash.add(c_seqs.size());
+        for (auto& d_seq: c_seqs) {
+            hash.add(d_seq);
+        }
+    }
+    hash.add(m_complementary_enthalpies.size());
+    for (auto enthalpy: m_complementary_enthalpies) {
+        hash.add(enthalpy);
+    }
+    hash.add(m_complementary_entropies.size());
+    for (auto entropy: m_complementary_entropies) {
+        hash.add(entropy);
+    }
+    hash.add(m_hybridization_pot);
+    hash.add(m_stacking_pot);
+    hash.add(m_apply_mean_field_cor);
+    hash.add(m_cation_M);
+    hash.add(m_stacking_ene);
+    hash.add(m_binding_h);
+    hash.add(m_binding_s);
+    hash.add(m_misbinding_h);
+    hash.add(m_misbinding_s);
+    hash.add(m_temp);
+
+    return hash.value();
+}
 
-    // Hybridization free energies, enthalpies, entropies
-    string henergy_filename {m_energy_filebase + temp_string + ".hene"};
-    string hhenergy_filename {m_energy_filebase + temp_string + ".hhene"};
-    string hsenergy_filename {m_energy_filebase + temp_string + ".hsene"};
+string OrigamiPotential::energy_cache_filename(uint64_t key) const {
+    std::ostringstream filename {};
+    filename << m_energy_filebase << "_" << std::hex << std::setw(16)
+             << std::setfill('0') << key << ".energies";
 
-    // Stacking energies
-    string senergy_filename {m_energy_filebase + temp_string + ".sene"};
+    return filename.str();
+}
 
-    std::ifstream henergy_file {henergy_filename};
-    std::ifstream hhenergy_file {henergy_filename};
-    std::ifstream hsenergy_file {henergy_filename};
-    std::ifstream senergy_file {senergy_filename};
+bool OrigamiPotential::read_energies_from_file(string filename, uint64_t key) {
 
-    bool files_present {
-            henergy_file and hhenergy_file and hsenergy_file and senergy_file};
-    if (files_present) {
-        boost::archive::text_iarchive h_arch {henergy_file};
-        h_arch >> m_hybridization_energies;
-        boost::archive::text_iarchive hh_arch {hhenergy_file};
-        hh_arch >> m_hybridization_enthalpies;
-        boost::archive::text_iarchive hs_arch {hsenergy_file};
-        hs_arch >> m_hybridization_entropies;
-        boost::archive::text_iarchive s_arch {senergy_file};
-        s_arch >> m_stacking_energies;
+    // Map energies from file, return false if not present or not usable
+    size_t file_size;
+    std::shared_ptr<const char> mapped {utility::map_file(filename, file_size)};
+    if (not mapped or file_size < sizeof(EnergyCacheHeader)) {
+        return false;
     }
 
-    return files_present;
+    EnergyCacheHeader header;
+    std::memcpy(&header, mapped.get(), sizeof(header));
+    PairEnergyTable& pairs {m_energies->pairs};
+    bool usable {
+            std::memcmp(
+                    header.magic,
+                    c_energy_cache_magic,
+                    sizeof(header.magic)) == 0 and
+            header.version == c_energy_cache_version and
+            header.entry_size == sizeof(PairEnergies) and
+            header.key == key and header.num_entries == pairs.size() and
+            file_size ==
+                    sizeof(header) + pairs.size() * sizeof(PairEnergies)};
+    if (usable) {
+        pairs.use_mapped_entries(
+                reinterpret_cast<const PairEnergies*>(
+                        mapped.get() + sizeof(header)),
+                mapped);
+        m_energies->init_enthalpy = header.init_enthalpy;
+        m_energies->init_entropy = header.init_entropy;
+        m_energies->init_energy = header.init_energy;
+    }
+
+    return usable;
 }
 
-void OrigamiPotential::write_energies_to_file() {
-    string temp_string {"_" + std::to_string(static_cast<int>(m_temp))};
-
-    // Hybridization energies, enthalpies, entropies
-    string henergy_filename {m_energy_filebase + temp_string + ".hene"};
-    string hhenergy_filename {m_energy_filebase + temp_string + ".hhene"};
-    string hsenergy_filename {m_energy_filebase + temp_string + ".hsene"};
-
-    // Stacking energies
-    string senergy_filename {m_energy_filebase + temp_string + ".sene"};
-
-    std::ofstream henergy_file {henergy_filename};
-    boost::archive::text_oarchive h_arch {henergy_file};
-    h_arch << m_hybridization_energies;
-    std::ofstream hhenergy_file {hhenergy_filename};
-    boost::archive::text_oarchive hh_arch {hhenergy_file};
-    hh_arch << m_hybridization_enthalpies;
-    std::ofstream hsenergy_file {hsenergy_filename};
-    boost::archive::text_oarchive hs_arch {hsenergy_file};
-    hs_arch << m_hybridization_entropies;
-    std::ofstream senergy_file {senergy_filename};
-    boost::archive::text_oarchive s_arch {senergy_file};
-    s_arch << m_stacking_energies;
+void OrigamiPotential::write_energies_to_file(string filename, uint64_t key) {
+
+    // Written to a unique file and then renamed over the cache file, so that
+    // ranks writing at once never leave a partial file to be read
+    EnergyCacheHeader header {};
+    std::memcpy(header.magic, c_energy_cache_magic, sizeof(header.magic));
+    header.version = c_energy_cache_version;
+    header.entry_size = sizeof(PairEnergies);
+    header.key = key;
+    header.num_entries = m_energies->pairs.size();
+    header.init_enthalpy = m_energies->init_enthalpy;
+    header.init_entropy = m_energies->init_entropy;
+    header.init_energy = m_energies->init_energy;
+
+    string temp_filename {filename + ".XXXXXX"};
+    int fd {mkstemp(&temp_filename[0])};
+    if (fd == -1) {
+        cout << "Could not write energy cache " << filename << "\n";
+        return;
+    }
+
+    // Other users and runs may share the cache, so do not keep it private
+    bool written {
+            fchmod(fd, 0644) == 0 and
+            write(fd, &header, sizeof(header)) ==
+                    static_cast<ssize_t>(sizeof(header)) and
+            write(fd,
+                  m_energies->pairs.data(),
+                  header.num_entries * sizeof(PairEnergies)) ==
+                    static_cast<ssize_t>(
+                            header.num_entries * sizeof(PairEnergies))};
+    written = (close(fd) == 0) and written;
+    if (not written or std::rename(temp_filename.c_str(), filename.c_str()) !=
+                               0) {
+        std::remove(temp_filename.c_str());
+        cout << "Could not write energy cache " << filename << "\n";
+    }
 }
 
 DeltaConfig OrigamiPotential::bind_domain(Domain& cd_i) {
-    m_constraints_violated = false;
-    Domain& cd_j {*cd_i.m_bound_domain};
-    bool comp {check_domains_complementary(cd_i, cd_j)};
-    DeltaConfig delta_config {};
-    if (comp) {
-        delta_config = m_binding_pot->bind_domains(cd_i, cd_j);
-        m_constraints_violated = m_binding_pot->m_constraints_violated;
-    }
-    else {
-        delta_config.e += m_misbinding_pot->bind_domains(cd_i, cd_j);
-        m_constraints_violated = m_misbinding_pot->m_constraints_violated;
-    }
+    DeltaConfig delta_config {bind_pair(
+            TrialStates {},
+            cd_i,
+            *cd_i.bound_domain(),
+            m_constraints_violated)};
     // DEBUG
     /*if (not m_constraints_violated) {
         if (cd_i.m_backward_domain != nullptr and
-    cd_i.m_backward_domain->m_state != Occupancy::unassigned) { VectorThree ndr
-    {cd_i.m_pos - cd_i.m_backward_domain->m_pos}; if (ndr.abssum() != 1) { cout
+    cd_i.m_backward_domain->state() != Occupancy::unassigned) { VectorThree ndr
+    {cd_i.pos() - cd_i.m_backward_domain->pos()}; if (ndr.abssum() != 1) { cout
     << "Contiguous domains not on adjacent sites\n"; throw OrigamiMisuse {};
             }
         }
-        if (cd_i.m_forward_domain != nullptr and cd_i.m_forward_domain->m_state
-    != Occupancy::unassigned) { VectorThree ndr {cd_i.m_pos -
-    cd_i.m_forward_domain->m_pos}; if (ndr.abssum() != 1) { cout << "Contiguous
+        if (cd_i.m_forward_domain != nullptr and cd_i.m_forward_domain->state()
+    != Occupancy::unassigned) { VectorThree ndr {cd_i.pos() -
+    cd_i.m_forward_domain->pos()}; if (ndr.abssum() != 1) { cout << "Contiguous
     domains not on adjacent sites\n"; throw OrigamiMisuse {};
             }
         }
@@ -1297,45 +1637,84 @@ DeltaConfig OrigamiPotential::bind_domain(Domain& cd_i) {
     return delta_config;
 }
 
+DeltaConfig OrigamiPotential::evaluate_binding(
+        Domain& cd_i,
+        const VectorThree& pos,
+        const VectorThree& ore,
+        Domain& cd_j,
+        bool& constraints_violated) {
+
+    Occupancy state {Occupancy::misbound};
+    if (check_domains_complementary(cd_i, cd_j)) {
+        state = Occupancy::bound;
+    }
+    TrialStates states {cd_i, pos, ore, cd_j, state};
+
+    return bind_pair(states, cd_i, cd_j, constraints_violated);
+}
+
+DeltaConfig OrigamiPotential::bind_pair(
+        const TrialStates& states,
+        Domain& cd_i,
+        Domain& cd_j,
+        bool& constraints_violated) {
+
+    DeltaConfig delta_config {};
+    if (check_domains_complementary(cd_i, cd_j)) {
+        delta_config = m_binding_pot->bind_domains(states, cd_i, cd_j);
+        constraints_violated = m_binding_pot->m_constraints_violated;
+    }
+    else {
+        delta_config.e += m_misbinding_pot->bind_domains(states, cd_i, cd_j);
+        constraints_violated = m_misbinding_pot->m_constraints_violated;
+    }
+
+    return delta_config;
+}
+
 DeltaConfig OrigamiPotential::check_stacking(Domain& cd_i, Domain& cd_j) {
 
-    return m_binding_pot->check_stacking(cd_i, cd_j);
+    return m_binding_pot->check_stacking(TrialStates {}, cd_i, cd_j);
 }
 
 double OrigamiPotential::hybridization_energy(
         const Domain& cd_i,
         const Domain& cd_j) const {
-    pair<int, int> key {cd_i.m_d_ident, cd_j.m_d_ident};
-    return m_hybridization_energies.at(key);
+    return pair_energies(cd_i, cd_j).hyb_energy;
 }
 
 double OrigamiPotential::hybridization_enthalpy(
         const Domain& cd_i,
         const Domain& cd_j) const {
-    pair<int, int> key {cd_i.m_d_ident, cd_j.m_d_ident};
-    return m_hybridization_enthalpies.at(key);
+    return pair_energies(cd_i, cd_j).hyb_enthalpy;
 }
 
 double OrigamiPotential::hybridization_entropy(
         const Domain& cd_i,
         const Domain& cd_j) const {
-    pair<int, int> key {cd_i.m_d_ident, cd_j.m_d_ident};
-    return m_hybridization_entropies.at(key);
+    return pair_energies(cd_i, cd_j).hyb_entropy;
 }
 
-double OrigamiPotential::init_enthalpy() const { return m_init_enthalpy; }
+double OrigamiPotential::init_enthalpy() const {
+    return m_energies->init_enthalpy * m_enthalpy_scale;
+}
 
-double OrigamiPotential::init_entropy() const { return m_init_entropy; }
+double OrigamiPotential::init_entropy() const {
+    return m_energies->init_entropy;
+}
 
-double OrigamiPotential::init_energy() const { return m_init_energy; }
+double OrigamiPotential::init_energy() const {
+    return init_enthalpy() - init_entropy();
+}
 
 double OrigamiPotential::stacking_energy(const Domain& cd_i, const Domain& cd_j)
         const {
-    pair<int, int> key {cd_i.m_d_ident, cd_j.m_d_ident};
-    return m_stacking_energies.at(key);
+    return pair_energies(cd_i, cd_j).stacking_energy;
 }
 
-bool OrigamiPotential::check_domains_complementary(Domain& cd_i, Domain& cd_j) {
+bool OrigamiPotential::check_domains_complementary(
+        const Domain& cd_i,
+        const Domain& cd_j) const {
     bool comp;
     if (cd_i.m_d_ident == -cd_j.m_d_ident) {
         comp = true;
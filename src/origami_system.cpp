@@ -14,11 +14,8 @@ namespace origami {
 
 using std::abs;
 using std::cout;
-using std::max_element;
 
 using biasFunctions::SystemBiases;
-using domainContainer::HalfTurnDomain;
-using domainContainer::ThreeQuarterTurnDomain;
 using files::OrigamiInputFile;
 using files::OrigamiTrajInputFile;
 using orderParams::SystemOrderParams;
@@ -58,7 +55,7 @@ OrigamiSystem::OrigamiSystem(
         m_reduced_staple_us {chempots_to_reduced_chempots(m_staple_us, m_temp)},
         m_reduced_fugacity {staple_M},
         m_cyclic {cyclic},
-        m_domain_type {params.m_domain_type},
+        m_domain_pool {params.m_domain_type, identities},
         m_apply_mean_field_cor {params.m_apply_mean_field_cor},
         m_pot {identities, sequences, enthalpies, entropies, params} {
 
@@ -71,22 +68,24 @@ OrigamiSystem::OrigamiSystem(
     m_biases = std::make_unique<SystemBiases>(*this, *m_ops, params);
 }
 
-OrigamiSystem::~OrigamiSystem() {
-    for (auto chain: m_domains) {
-        for (auto domain: chain) {
-            delete domain;
-        }
-    }
-}
+OrigamiSystem::~OrigamiSystem() {}
 
-vector<vector<Domain*>> OrigamiSystem::get_chains() { return m_domains; }
+const vector<vector<Domain*>>& OrigamiSystem::get_chains() const {
+    return m_domains;
+}
 
-vector<Domain*> OrigamiSystem::get_last_chain() { return m_domains.back(); }
+const vector<Domain*>& OrigamiSystem::get_last_chain() const {
+    return m_domains.back();
+}
 
 int OrigamiSystem::num_staples() const { return m_num_staples; }
 
 int OrigamiSystem::num_domains() { return m_num_domains; }
 
+Domain* OrigamiSystem::indexed_domain(int d_i_index) const {
+    return m_domain_list[d_i_index];
+}
+
 int OrigamiSystem::num_bound_domain_pairs() const {
     return m_num_bound_domain_pairs;
 }
@@ -119,17 +118,17 @@ int OrigamiSystem::num_staples_of_ident(int staple_ident) const {
     return m_identity_to_index[staple_ident].size();
 }
 
-vector<int> OrigamiSystem::staples_of_ident(int c_ident) {
+const vector<int>& OrigamiSystem::staples_of_ident(int c_ident) const {
     return m_identity_to_index[c_ident];
 }
 
-vector<int> OrigamiSystem::complementary_scaffold_domains(
+const vector<int>& OrigamiSystem::complementary_scaffold_domains(
         int staple_ident) const {
     return m_staple_ident_to_scaffold_ds[staple_ident];
 }
 
 Domain* OrigamiSystem::unbound_domain_at(VectorThree pos) const {
-    return m_pos_to_unbound_d.at(pos);
+    return m_occupancies.unbound_domain(pos);
 }
 
 bool OrigamiSystem::check_domains_complementary(Domain& cd_i, Domain& cd_j) {
@@ -142,48 +141,45 @@ SystemOrderParams& OrigamiSystem::get_system_order_params() { return *m_ops; }
 
 SystemBiases& OrigamiSystem::get_system_biases() { return *m_biases; }
 
-vector<Domain*> OrigamiSystem::get_chain(int c_i) {
-    int c_i_index {utility::index(m_chain_indices, c_i)};
-    return m_domains[c_i_index];
+const vector<Domain*>& OrigamiSystem::get_chain(int c_i) const {
+    return m_domains[m_chain_slots.index(c_i)];
 }
 
 Domain* OrigamiSystem::get_domain(int c_i, int d_i) {
     return get_chain(c_i)[d_i];
 }
 
-vector<int> OrigamiSystem::get_staple_counts() {
-    vector<int> staple_counts(m_identities.size() - 1, 0);
-    for (size_t c_i {1}; c_i != m_domains.size(); c_i++) {
-        int c_ident {m_domains[c_i][0]->m_c_ident};
-        staple_counts[c_ident - 1]++;
+vector<int> OrigamiSystem::get_staple_counts() const {
+    vector<int> staple_counts {};
+    staple_counts.reserve(m_staple_stats.size() - 1);
+    for (size_t c_ident {1}; c_ident != m_staple_stats.size(); c_ident++) {
+        staple_counts.push_back(m_staple_stats[c_ident].copies);
     }
 
     return staple_counts;
 }
 
-int OrigamiSystem::num_unique_staples() const {
-    int unique_staple_count {0};
-    for (auto indices: m_identity_to_index) {
-        if (indices.size() > 0) {
-            unique_staple_count++;
-        }
-    }
+int OrigamiSystem::num_unique_staples() const { return m_num_unique_staples; }
 
-    // Minus one to remove scaffold
-    return unique_staple_count - 1;
+const StapleStats& OrigamiSystem::staple_stats(int c_ident) const {
+    return m_staple_stats[c_ident];
+}
+
+vector<int> OrigamiSystem::ordered_chain_indices() const {
+    return m_chain_slots.ordered_handles();
 }
 
 Chains OrigamiSystem::chains() const {
     // Return chains data structure for current config
     Chains chains;
-    for (size_t i {0}; i != m_domains.size(); i++) {
-        int c_i_ident {m_chain_identities.at(i)};
-        int c_i {m_chain_indices.at(i)};
+    for (auto c_i: ordered_chain_indices()) {
+        int i {m_chain_slots.index(c_i)};
+        int c_i_ident {m_chain_identities[i]};
         vector<VectorThree> positions;
         vector<VectorThree> orientations;
         for (auto domain: m_domains[i]) {
-            positions.push_back(domain->m_pos);
-            orientations.push_back(domain->m_ore);
+            positions.push_back(domain->pos());
+            orientations.push_back(domain->ore());
         }
         Chain chain {c_i, c_i_ident, positions, orientations};
         chains.push_back(chain);
@@ -192,64 +188,105 @@ Chains OrigamiSystem::chains() const {
 }
 
 Occupancy OrigamiSystem::position_occupancy(VectorThree pos) const {
-    Occupancy occ;
-    if (m_position_occupancies.count(pos) == 0) {
-        occ = Occupancy::unassigned;
+    return m_occupancies.occupancy(pos);
+}
+
+void OrigamiSystem::check_enthalpy_and_entropy() {
+    double pair_enthalpy {0};
+    double pair_entropy {0};
+
+    // Stream through the state arrays, counting each pair from its lower id
+    for (auto& slab: m_domain_pool.slabs()) {
+        for (int i {0}; i != slab->size; i++) {
+            Occupancy state {slab->states[i]};
+            if (state != Occupancy::bound and state != Occupancy::misbound) {
+                continue;
+            }
+            Domain& domain {*slab->domains[i]};
+            Domain& bound_domain {*slab->bound_domains[i]};
+            if (domain.m_id > bound_domain.m_id) {
+                continue;
+            }
+            pair_enthalpy += m_pot.hybridization_enthalpy(domain, bound_domain);
+            pair_entropy += m_pot.hybridization_entropy(domain, bound_domain);
+        }
     }
-    else {
-        occ = m_position_occupancies.at(pos);
+
+    // Tolerance is as arbitrary as for the energy check
+    double eps {0.000001};
+    if (std::abs(pair_enthalpy - m_pair_enthalpy) > eps or
+        std::abs(pair_entropy - m_pair_entropy) > eps) {
+        cout << "Inconsistency in hybridization enthalpy or entropy\n";
+        cout << m_pair_enthalpy << " " << pair_enthalpy << " ";
+        cout << m_pair_entropy << " " << pair_entropy << "\n";
+        throw OrigamiMisuse {};
     }
-    return occ;
+
+    // Prevent rounding errors from building up
+    m_pair_enthalpy = pair_enthalpy;
+    m_pair_entropy = pair_entropy;
 }
 
-void OrigamiSystem::update_enthalpy_and_entropy() {
-    m_hyb_enthalpy = 0;
-    m_hyb_entropy = 0;
-    set<Domain*> accounted_domains; // Domains whose energy is already counted
-    for (auto chain: m_domains) {
+void OrigamiSystem::check_staple_stats() const {
+    vector<StapleStats> staple_stats(m_identities.size());
+    for (auto& chain: m_domains) {
+        StapleStats& stats {staple_stats[chain[0]->m_c_ident]};
+        stats.copies++;
+        int paired_domains {0};
+        int bound_domains {0};
         for (auto domain: chain) {
-            Occupancy state {domain->m_state};
-            if (state == Occupancy::bound or state == Occupancy::misbound) {
-                if (find(accounted_domains.begin(),
-                         accounted_domains.end(),
-                         domain) == accounted_domains.end()) {
-                    Domain& bound_domain {*domain->m_bound_domain};
-                    m_hyb_enthalpy +=
-                            m_pot.hybridization_enthalpy(*domain, bound_domain);
-                    m_hyb_entropy +=
-                            m_pot.hybridization_entropy(*domain, bound_domain);
-                    accounted_domains.insert(domain->m_bound_domain);
-                }
-            }
+            paired_domains += domain->state() == Occupancy::bound or
+                              domain->state() == Occupancy::misbound;
+            bound_domains += domain->state() == Occupancy::bound;
+        }
+        stats.bound_copies += paired_domains > 0;
+        stats.fully_bound_copies +=
+                bound_domains == static_cast<int>(chain.size());
+    }
+    for (size_t c_ident {0}; c_ident != staple_stats.size(); c_ident++) {
+        const StapleStats& expected {staple_stats[c_ident]};
+        const StapleStats& stats {m_staple_stats[c_ident]};
+        if (expected.copies != stats.copies or
+            expected.bound_copies != stats.bound_copies or
+            expected.fully_bound_copies != stats.fully_bound_copies) {
+            cout << "Inconsistency in statistics of identity " << c_ident
+                 << "\n";
+            throw OrigamiMisuse {};
         }
     }
+}
+
+double OrigamiSystem::hybridization_enthalpy() const {
+
+    // Initiation enthalpy
+    return m_pair_enthalpy + (m_domains.size() - 1) * m_pot.init_enthalpy();
+}
 
+double OrigamiSystem::hybridization_entropy() const {
+    double hyb_entropy {m_pair_entropy};
     if (m_apply_mean_field_cor) {
 
         // Fix overcorrection for first chain relative entropy
-        m_hyb_entropy -= (m_domains.size() - 1) * log(6);
+        hyb_entropy -= (m_domains.size() - 1) * log(6);
 
         // Mean field entropy correction for first scaffold domains
         if (m_num_fully_bound_domain_pairs >= 1) {
-            m_hyb_entropy -= 2 * log(6);
+            hyb_entropy -= 2 * log(6);
         }
         if (m_num_fully_bound_domain_pairs >= 2) {
-            m_hyb_entropy -= log(3);
+            hyb_entropy -= log(3);
         }
     }
 
-    // Initiation energy
-    m_hyb_enthalpy += (m_domains.size() - 1) * m_pot.init_enthalpy();
-    m_hyb_entropy += (m_domains.size() - 1) * m_pot.init_entropy();
+    // Initiation entropy
+    hyb_entropy += (m_domains.size() - 1) * m_pot.init_entropy();
 
-    m_stacking_energy = m_energy - (m_hyb_enthalpy - m_hyb_entropy);
+    return hyb_entropy;
 }
 
-double OrigamiSystem::hybridization_enthalpy() { return m_hyb_enthalpy; }
-
-double OrigamiSystem::hybridization_entropy() { return m_hyb_entropy; }
-
-double OrigamiSystem::stacking_energy() { return m_stacking_energy; }
+double OrigamiSystem::stacking_energy() const {
+    return m_energy - (hybridization_enthalpy() - hybridization_entropy());
+}
 
 bool OrigamiSystem::configuration_fully_set() {
     if (m_num_unassigned_domains == 0) {
@@ -267,21 +304,28 @@ double OrigamiSystem::init_energy() { return m_pot.init_energy(); }
 void OrigamiSystem::check_all_constraints() {
 
     //cout << "\nChecking all constraints\n";
-    // Unassign everything (and check nothing was already unassigned)
+    check_enthalpy_and_entropy();
+    check_staple_stats();
+
+    // Unassign everything (and check nothing was already unassigned) in one
+    // pass over the state arrays. Domains of free chains are unassigned too,
+    // so only the count of assigned domains tells if any in use were not
     if (m_num_unassigned_domains != 0) {
         throw OrigamiMisuse {};
     }
-    for (auto chain: m_domains) {
-        for (auto domain: chain) {
-            if (domain->m_state == Occupancy::unassigned) {
-                cout << "Domain unassigned after move complete\n";
-                throw OrigamiMisuse {};
-            }
-            else {
-                unassign_domain(*domain);
+    int assigned_domains {0};
+    for (auto& slab: m_domain_pool.slabs()) {
+        for (int i {0}; i != slab->size; i++) {
+            if (slab->states[i] != Occupancy::unassigned) {
+                unassign_domain(*slab->domains[i]);
+                assigned_domains++;
             }
         }
     }
+    if (assigned_domains != m_num_domains) {
+        cout << "Domain unassigned after move complete\n";
+        throw OrigamiMisuse {};
+    }
 
     if (m_apply_mean_field_cor) {
 
@@ -312,6 +356,8 @@ void OrigamiSystem::check_all_constraints() {
 
         // Prevent rounding errors from building up
         m_energy = 0;
+        m_pair_enthalpy = 0;
+        m_pair_entropy = 0;
     }
 
     // Reset configuration
@@ -347,11 +393,63 @@ double OrigamiSystem::check_domain_constraints(
     //cout << m_num_stacked_domain_pairs << " Checking domain constraints ("
     //<< cd_i.m_c << " " << cd_i.m_d << ")\n";
 
-    DeltaConfig delta_config {
-            internal_check_domain_constraints(cd_i, pos, ore)};
-    internal_unassign_domain(cd_i);
+    TrialResult trial {evaluate_trial(cd_i, pos, ore)};
+    m_constraints_violated = trial.constraints_violated;
 
-    return delta_config.e;
+    return trial.e;
+}
+
+TrialResult OrigamiSystem::evaluate_trial(
+        Domain& cd_i,
+        VectorThree pos,
+        VectorThree ore) {
+    Occupancy occupancy;
+    Domain* cd_j;
+    m_occupancies.read_site(pos, occupancy, cd_j);
+    TrialResult trial {
+            internal_evaluate_trial(cd_i, pos, ore, occupancy, cd_j)};
+    check_trial_bias(cd_i, pos, ore, trial);
+
+    return trial;
+}
+
+void OrigamiSystem::evaluate_neighbour_trials(
+        Domain& cd_i,
+        VectorThree growth_pos,
+        NeighbourTrials& trials) {
+    for (size_t i {0}; i != trials.size(); i++) {
+        NeighbourTrial& trial {trials[i]};
+        trial.pos = growth_pos + utility::vectors[i];
+        m_occupancies.read_site(
+                trial.pos, trial.occupancy, trial.unbound_domain);
+        trial.result = {};
+        switch (trial.occupancy) {
+        case Occupancy::bound:
+        case Occupancy::misbound:
+            trial.ore = {0, 0, 0};
+            trial.result.constraints_violated = true;
+            continue;
+        case Occupancy::unbound:
+            trial.ore = -trial.unbound_domain->ore();
+            trial.result = internal_evaluate_trial(
+                    cd_i,
+                    trial.pos,
+                    trial.ore,
+                    trial.occupancy,
+                    trial.unbound_domain);
+            check_trial_bias(cd_i, trial.pos, trial.ore, trial.result);
+            break;
+        case Occupancy::unassigned:
+            trial.ore = {0, 0, 0};
+            trial.result = internal_evaluate_trial(
+                    cd_i, trial.pos, {1, 0, 0}, trial.occupancy, nullptr);
+            check_trial_bias(cd_i, trial.pos, {1, 0, 0}, trial.result);
+        }
+    }
+}
+
+long long int OrigamiSystem::config_version() const {
+    return m_config_version;
 }
 
 void OrigamiSystem::check_distance_constraints() {
@@ -362,7 +460,7 @@ void OrigamiSystem::check_distance_constraints() {
                 continue;
             }
             else {
-                VectorThree dist {next_domain->m_pos - domain->m_pos};
+                VectorThree dist {next_domain->pos() - domain->pos()};
                 if (dist.abssum() != 1) {
                     cout << "Contiguous domains not on adjacent sites\n";
                     throw OrigamiMisuse {};
@@ -386,7 +484,8 @@ double OrigamiSystem::unassign_domain(Domain& cd_i) {
 
 int OrigamiSystem::add_chain(int c_i_ident) {
     // Add chain with domains in unassigned state and return chain index.
-    m_current_c_i += 1;
+    int c_i {m_chain_slots.insert()};
+    append_chain(c_i, c_i_ident);
 
     // Mean field correction hack
     if (m_apply_mean_field_cor) {
@@ -396,71 +495,94 @@ int OrigamiSystem::add_chain(int c_i_ident) {
     // Initiation energy hack
     m_energy += m_pot.init_energy();
 
-    return add_chain(c_i_ident, m_current_c_i);
+    return c_i;
 }
 
 int OrigamiSystem::add_chain(int c_i_ident, int c_i) {
     // Add chain with given index
+    m_chain_slots.insert(c_i);
+    append_chain(c_i, c_i_ident);
+
+    return c_i;
+}
+
+void OrigamiSystem::append_chain(int c_i, int c_i_ident) {
+    // Check out domains for a chain whose index is already in the slot map
     m_identity_to_index[c_i_ident].push_back(c_i);
-    m_chain_indices.push_back(c_i);
+    m_chain_ident_positions.push_back(m_identity_to_index[c_i_ident].size() - 1);
     m_chain_identities.push_back(c_i_ident);
+    m_chain_paired_domains.push_back(0);
+    m_chain_bound_domains.push_back(0);
+    if (m_journal_active) {
+        m_journal_chains.push_back(c_i);
+    }
+    m_staple_stats[c_i_ident].copies++;
+    if (c_i_ident != c_scaffold and m_staple_stats[c_i_ident].copies == 1) {
+        m_num_unique_staples++;
+    }
 
-    int chain_length {static_cast<int>(m_identities[c_i_ident].size())};
-    m_domains.push_back({});
-    m_num_staples++;
-    Domain* prev_domain {nullptr};
-    for (int d_i {0}; d_i != chain_length; d_i++) {
-        int d_i_ident {m_identities[c_i_ident][d_i]};
-        Domain* domain;
-        if (m_domain_type == "HalfTurn") {
-            domain = new HalfTurnDomain {
-                    c_i, c_i_ident, d_i, d_i_ident, chain_length};
-        }
-        else if (m_domain_type == "ThreeQuarterTurn") {
-            domain = new ThreeQuarterTurnDomain {
-                    c_i, c_i_ident, d_i, d_i_ident, chain_length};
-        }
-        else {
-            throw OrigamiMisuse {};
-        }
-
-        // Set forward and backwards domains
-        if (prev_domain != nullptr) {
-            prev_domain->m_forward_domain = domain;
+    m_domains.push_back(m_domain_pool.checkout_chain(c_i, c_i_ident));
+    for (auto domain: m_domains.back()) {
+        if (domain->m_id >= static_cast<int>(m_domain_list_indices.size())) {
+            m_domain_list_indices.resize(domain->m_id + 1);
         }
-
-        domain->m_backward_domain = prev_domain;
-        domain->m_forward_domain = nullptr;
-
-        m_domains.back().push_back(domain);
-        prev_domain = domain;
-
-        m_num_domains++;
-        m_num_unassigned_domains++;
+        m_domain_list_indices[domain->m_id] = m_domain_list.size();
+        m_domain_list.push_back(domain);
     }
-
-    return c_i;
+    m_num_staples++;
+    m_num_domains += m_domains.back().size();
+    m_num_unassigned_domains += m_domains.back().size();
 }
 
 void OrigamiSystem::delete_chain(int c_i) {
     // Delete chain c_i_
 
-    int c_i_index {utility::index(m_chain_indices, c_i)};
+    // Deleted domains could not be restored, so the journal is abandoned
+    m_journal_active = false;
+    int c_i_index {m_chain_slots.index(c_i)};
     int c_i_ident {m_chain_identities[c_i_index]};
-
-    // Index in m_identity_to_index of given index and type
-    int j {utility::index(m_identity_to_index[c_i_ident], c_i)};
-    m_identity_to_index[c_i_ident].erase(
-            m_identity_to_index[c_i_ident].begin() + j);
-    m_chain_indices.erase(m_chain_indices.begin() + c_i_index);
-    m_chain_identities.erase(m_chain_identities.begin() + c_i_index);
     m_num_domains -= m_domains[c_i_index].size();
+    m_num_unassigned_domains -= m_domains[c_i_index].size();
     m_num_staples--;
+
+    // Swap the last domains of the flat list into the deleted ones' places
     for (auto domain: m_domains[c_i_index]) {
-        delete domain;
-        m_num_unassigned_domains--;
+        int i {m_domain_list_indices[domain->m_id]};
+        Domain* moved_domain {m_domain_list.back()};
+        m_domain_list[i] = moved_domain;
+        m_domain_list_indices[moved_domain->m_id] = i;
+        m_domain_list.pop_back();
+    }
+    m_domain_pool.return_chain(m_domains[c_i_index]);
+
+    // The pool only takes back unassigned chains, so none of its copies
+    // were counted as bound
+    StapleStats& stats {m_staple_stats[c_i_ident]};
+    stats.copies--;
+    if (c_i_ident != c_scaffold and stats.copies == 0) {
+        m_num_unique_staples--;
     }
-    m_domains.erase(m_domains.begin() + c_i_index);
+
+    // Swap the last index of the same identity into the deleted one's place
+    vector<int>& ident_indices {m_identity_to_index[c_i_ident]};
+    int j {m_chain_ident_positions[c_i_index]};
+    int moved_c_i {ident_indices.back()};
+    ident_indices[j] = moved_c_i;
+    ident_indices.pop_back();
+    m_chain_ident_positions[m_chain_slots.index(moved_c_i)] = j;
+
+    // Swap the last chain into the deleted one's working index
+    m_chain_slots.erase(c_i);
+    std::swap(m_domains[c_i_index], m_domains.back());
+    m_domains.pop_back();
+    m_chain_identities[c_i_index] = m_chain_identities.back();
+    m_chain_identities.pop_back();
+    m_chain_ident_positions[c_i_index] = m_chain_ident_positions.back();
+    m_chain_ident_positions.pop_back();
+    m_chain_paired_domains[c_i_index] = m_chain_paired_domains.back();
+    m_chain_paired_domains.pop_back();
+    m_chain_bound_domains[c_i_index] = m_chain_bound_domains.back();
+    m_chain_bound_domains.pop_back();
 
     // Mean field correction hack
     if (m_apply_mean_field_cor) {
@@ -486,20 +608,20 @@ double OrigamiSystem::set_checked_domain_config(
 
     // Update internal energy
     double delta_e {0};
-    if (cd_i.m_state == Occupancy::misbound) {
-        delta_e += m_pot.hybridization_energy(cd_i, *cd_i.m_bound_domain);
+    if (cd_i.state() == Occupancy::misbound) {
+        delta_e += m_pot.hybridization_energy(cd_i, *cd_i.bound_domain());
     }
-    else if (cd_i.m_state == Occupancy::bound) {
-        delta_e += m_pot.hybridization_energy(cd_i, *cd_i.m_bound_domain);
+    else if (cd_i.state() == Occupancy::bound) {
+        delta_e += m_pot.hybridization_energy(cd_i, *cd_i.bound_domain());
         DeltaConfig delta_config;
-        delta_config = m_pot.check_stacking(cd_i, *cd_i.m_bound_domain);
+        delta_config = m_pot.check_stacking(cd_i, *cd_i.bound_domain());
         delta_e += delta_config.e;
         m_num_stacked_domain_pairs += delta_config.stacked_pairs;
     }
 
     // Mean field entropy correction for first scaffold domains
     if (m_apply_mean_field_cor) {
-        if (cd_i.m_state == Occupancy::bound) {
+        if (cd_i.state() == Occupancy::bound) {
             if (m_num_fully_bound_domain_pairs == 1) {
                 delta_e += 2 * log(6);
             }
@@ -522,63 +644,156 @@ double OrigamiSystem::set_domain_config(
     //cd_i.m_c
     //<< " "
     //<< cd_i.m_d << ")\n";
-    if (cd_i.m_state != Occupancy::unassigned) {
+    if (cd_i.state() != Occupancy::unassigned) {
         cout << "Trying to set an already assigned domain\n";
         throw OrigamiMisuse {};
     }
 
-    // Check constraints and update if obeyed, otherwise throw
-    DeltaConfig delta_config {
-            internal_check_domain_constraints(cd_i, pos, ore)};
-    if (m_constraints_violated) {
-        internal_unassign_domain(cd_i);
-    }
-    else {
-        m_energy += delta_config.e;
-        m_num_stacked_domain_pairs += delta_config.stacked_pairs;
+    // Check constraints and update if obeyed
+    Occupancy occupancy;
+    Domain* cd_j;
+    m_occupancies.read_site(pos, occupancy, cd_j);
+    TrialResult trial {
+            internal_evaluate_trial(cd_i, pos, ore, occupancy, cd_j)};
+    m_constraints_violated = trial.constraints_violated;
+    if (not m_constraints_violated) {
+        update_domain(cd_i, pos, ore);
+        update_occupancies(cd_i, pos);
+        m_energy += trial.e;
+        m_num_stacked_domain_pairs += trial.stacked_pairs;
         m_num_unassigned_domains--;
     }
-    return delta_config.e;
+    return trial.e;
 }
 
 void OrigamiSystem::set_domain_orientation(Domain& cd_i, VectorThree ore) {
-    Occupancy occupancy {cd_i.m_state};
+    Occupancy occupancy {cd_i.state()};
     if (occupancy == Occupancy::bound) {
         m_constraints_violated = true;
     }
     else {
-        cd_i.m_ore = ore;
+        note_domain_change(cd_i);
+        cd_i.ore() = ore;
     }
 }
 
 void OrigamiSystem::center(int centering_domain) {
     // Translate the system such that the first scaffold domain is on the origin
 
-    // The maps that go from a position to something need to be reset
-    unordered_map<VectorThree, Domain*> pos_to_unbound_d {};
-    unordered_map<VectorThree, Occupancy> position_occupancies {};
-    VectorThree refpos {m_domains[0][centering_domain]->m_pos};
-    for (auto chain: m_domains) {
+    VectorThree refpos {m_domains[0][centering_domain]->pos()};
+    for (auto& chain: m_domains) {
         for (auto domain: chain) {
-            VectorThree new_pos {domain->m_pos - refpos};
-            pos_to_unbound_d[new_pos] = m_pos_to_unbound_d[domain->m_pos];
-            position_occupancies[new_pos] =
-                    m_position_occupancies[domain->m_pos];
-            domain->m_pos = new_pos;
+            domain->pos() = domain->pos() - refpos;
         }
     }
-    m_pos_to_unbound_d = pos_to_unbound_d;
-    m_position_occupancies = position_occupancies;
+    m_occupancies.translate(-refpos);
+    m_config_version++;
+}
+
+void OrigamiSystem::begin_journal() {
+    m_journal_active = true;
+    m_journal.clear();
+    m_journal_chains.clear();
+    m_journal_epoch++;
+    m_journal_counts = {
+            m_energy,
+            m_pair_enthalpy,
+            m_pair_entropy,
+            m_num_unassigned_domains,
+            m_num_bound_domain_pairs,
+            m_num_fully_bound_domain_pairs,
+            m_num_self_bound_domain_pairs,
+            m_num_stacked_domain_pairs};
+}
+
+bool OrigamiSystem::undo_journal() {
+    if (not m_journal_active) {
+        return false;
+    }
+    m_journal_active = false;
+    m_config_version++;
+
+    // Clear every site a changed domain is on before any are refilled, as
+    // a site may have been vacated by one domain and taken by another
+    for (auto& record: m_journal) {
+        Domain& domain {*record.domain};
+        if (domain.state() != Occupancy::unassigned) {
+            m_occupancies.unassign(domain.pos());
+        }
+    }
+    for (auto& record: m_journal) {
+        Domain& domain {*record.domain};
+        Occupancy state {domain.state()};
+        domain.pos() = record.pos;
+        domain.ore() = record.ore;
+        domain.state() = record.state;
+        domain.bound_domain() = record.bound_domain;
+        update_staple_stats(domain, state);
+        if (record.state == Occupancy::unbound) {
+            m_occupancies.set_unbound(record.pos, &domain);
+        }
+        else if (record.state != Occupancy::unassigned) {
+            m_occupancies.set_bound(record.pos, record.state);
+        }
+    }
+    for (auto& record: m_journal) {
+        update_restored_domain(*record.domain);
+    }
+
+    // Domains of added chains are all unassigned again by this point
+    for (auto c_i: m_journal_chains) {
+        delete_chain(c_i);
+    }
+
+    m_energy = m_journal_counts.energy;
+    m_pair_enthalpy = m_journal_counts.pair_enthalpy;
+    m_pair_entropy = m_journal_counts.pair_entropy;
+    m_num_unassigned_domains = m_journal_counts.num_unassigned_domains;
+    m_num_bound_domain_pairs = m_journal_counts.num_bound_domain_pairs;
+    m_num_fully_bound_domain_pairs =
+            m_journal_counts.num_fully_bound_domain_pairs;
+    m_num_self_bound_domain_pairs =
+            m_journal_counts.num_self_bound_domain_pairs;
+    m_num_stacked_domain_pairs = m_journal_counts.num_stacked_domain_pairs;
+    m_constraints_violated = false;
+
+    return true;
+}
+
+void OrigamiSystem::discard_journal() { m_journal_active = false; }
+
+void OrigamiSystem::note_domain_change(Domain& cd_i) {
+    m_config_version++;
+    if (not m_journal_active) {
+        return;
+    }
+
+    // Only the state from before the first change is needed
+    if (cd_i.m_id >= static_cast<int>(m_journal_stamps.size())) {
+        m_journal_stamps.resize(cd_i.m_id + 1, 0);
+    }
+    if (m_journal_stamps[cd_i.m_id] == m_journal_epoch) {
+        return;
+    }
+    m_journal_stamps[cd_i.m_id] = m_journal_epoch;
+    m_journal.push_back(
+            {&cd_i,
+             cd_i.pos(),
+             cd_i.ore(),
+             cd_i.state(),
+             cd_i.bound_domain()});
 }
 
 void OrigamiSystem::set_all_domains() {
-    // Use current positions and orientations
-    for (auto chain: m_domains) {
+    // Use current positions and orientations. This goes chain by chain
+    // rather than over the state arrays, as it is the order that sets the
+    // sum of the energy, and domains of free chains must be left unassigned
+    for (auto& chain: m_domains) {
         for (auto domain: chain) {
-            set_domain_config(*domain, domain->m_pos, domain->m_ore);
+            set_domain_config(*domain, domain->pos(), domain->ore());
             if (m_constraints_violated) {
                 cout << "Constaints in violation after move complete\n";
-                set_domain_config(*domain, domain->m_pos, domain->m_ore);
+                set_domain_config(*domain, domain->pos(), domain->ore());
                 throw OrigamiMisuse {};
             }
         }
@@ -590,25 +805,25 @@ void OrigamiSystem::set_all_domains(Chains config) {
     // Use given positions and orientations
 
     // Set position and orientation of domains
-    for (size_t i {0}; i != config.size(); i++) {
-        Chain chain {config[i]};
-        int num_domains {static_cast<int>(m_domains[i].size())};
+    for (auto& chain: config) {
+        const vector<Domain*>& domains {get_chain(chain.index)};
+        int num_domains {static_cast<int>(domains.size())};
         for (int d_i {0}; d_i != num_domains; d_i++) {
-            Domain* domain {m_domains[i][d_i]};
+            Domain* domain {domains[d_i]};
             VectorThree pos = chain.positions[d_i];
             VectorThree ore = chain.orientations[d_i];
-            domain->m_pos = pos;
-            domain->m_ore = ore;
+            domain->pos() = pos;
+            domain->ore() = ore;
         }
     }
 
     // Set all domains and check all constraints
-    for (auto chain: m_domains) {
+    for (auto& chain: m_domains) {
         for (auto domain: chain) {
-            set_domain_config(*domain, domain->m_pos, domain->m_ore);
+            set_domain_config(*domain, domain->pos(), domain->ore());
             if (m_constraints_violated) {
                 cout << "Constaints in violation after move complete\n";
-                set_domain_config(*domain, domain->m_pos, domain->m_ore);
+                set_domain_config(*domain, domain->pos(), domain->ore());
                 throw OrigamiMisuse {};
             }
         }
@@ -619,9 +834,16 @@ void OrigamiSystem::set_all_domains(Chains config) {
 void OrigamiSystem::update_temp(double temp, double stacking_mult) {
     m_temp = temp;
     m_pot.update_temp(temp, stacking_mult);
+    m_config_version++;
     update_energy();
 }
 
+void OrigamiSystem::precompute_energy_tables(
+        const vector<double>& temps,
+        const vector<double>& stacking_mults) {
+    m_pot.precompute_energy_tables(temps, stacking_mults);
+}
+
 void OrigamiSystem::update_staple_us(double temp, double staple_u_mult) {
     for (size_t i {0}; i != m_staple_us.size(); i++) {
         m_staple_us[i] = m_reduced_staple_us[i] * temp * staple_u_mult;
@@ -633,6 +855,7 @@ void OrigamiSystem::initialize_complementary_associations() {
     // Staple identities are 1 indexed (scaffold is 0)
     m_staple_ident_to_scaffold_ds.push_back({});
     m_identity_to_index.push_back({});
+    m_staple_stats.resize(m_identities.size());
     for (unsigned int i {1}; i != m_identities.size(); ++i) {
         m_identity_to_index.push_back({});
         vector<int> staple {m_identities[i]};
@@ -672,10 +895,6 @@ void OrigamiSystem::initialize_staples(Chains chains) {
 
     // Initiation energy hack
     m_energy += (m_domains.size() - 1) * m_pot.init_energy();
-
-    // Current unique chain index
-    m_current_c_i =
-            *max_element(m_chain_indices.begin(), m_chain_indices.end());
 }
 
 void OrigamiSystem::initialize_scaffold(Chain scaffold_chain) {
@@ -695,8 +914,8 @@ void OrigamiSystem::initialize_scaffold(Chain scaffold_chain) {
 
 DeltaConfig OrigamiSystem::internal_unassign_domain(Domain& cd_i) {
     // Deletes positions, orientations, and removes/unassigns occupancies.
-    Occupancy occupancy {cd_i.m_state};
-    Domain* cd_j {cd_i.m_bound_domain};
+    Occupancy occupancy {cd_i.state()};
+    Domain* cd_j {cd_i.bound_domain()};
     DeltaConfig delta_config {};
     switch (occupancy) {
     case Occupancy::bound:
@@ -740,32 +959,68 @@ DeltaConfig OrigamiSystem::internal_unassign_domain(Domain& cd_i) {
 }
 
 double OrigamiSystem::unassign_bound_domain(Domain& cd_i) {
-    Domain& cd_j {*cd_i.m_bound_domain};
+    Domain& cd_j {*cd_i.bound_domain()};
     double delta_e {-m_pot.hybridization_energy(cd_i, cd_j)};
+    update_pair_thermo(cd_i, cd_j, -1);
+
+    note_domain_change(cd_i);
+    note_domain_change(cd_j);
+    cd_i.bound_domain() = nullptr;
+    cd_j.bound_domain() = nullptr;
+    Occupancy old_state {cd_i.state()};
+    cd_i.state() = Occupancy::unassigned;
+    update_staple_stats(cd_i, old_state);
+
+    m_occupancies.set_unbound(cd_i.pos(), &cd_j);
+    cd_j.state() = Occupancy::unbound;
+    update_staple_stats(cd_j, old_state);
+    return delta_e;
+}
 
-    cd_i.m_bound_domain = nullptr;
-    cd_j.m_bound_domain = nullptr;
-    cd_i.m_state = Occupancy::unassigned;
+void OrigamiSystem::update_pair_thermo(Domain& cd_i, Domain& cd_j, int sign) {
 
-    m_pos_to_unbound_d[cd_i.m_pos] = &cd_j;
-    m_position_occupancies[cd_i.m_pos] = Occupancy::unbound;
-    cd_j.m_state = Occupancy::unbound;
-    return delta_e;
+    // Pairs are always looked up from the lower id, as in the full recount
+    Domain& cd_1 {cd_i.m_id < cd_j.m_id ? cd_i : cd_j};
+    Domain& cd_2 {cd_i.m_id < cd_j.m_id ? cd_j : cd_i};
+    PairEnergies energies {m_pot.pair_energies(cd_1, cd_2)};
+    m_pair_enthalpy += sign * energies.hyb_enthalpy;
+    m_pair_entropy += sign * energies.hyb_entropy;
+}
+
+void OrigamiSystem::update_staple_stats(Domain& cd_i, Occupancy old_state) {
+
+    // Only transitions into and out of the bound and misbound states count
+    int c_i_index {m_chain_slots.index(cd_i.m_c)};
+    int& paired_domains {m_chain_paired_domains[c_i_index]};
+    int& bound_domains {m_chain_bound_domains[c_i_index]};
+    int num_domains {static_cast<int>(m_domains[c_i_index].size())};
+    bool was_paired {paired_domains > 0};
+    bool was_fully_bound {bound_domains == num_domains};
+    auto paired = [](Occupancy state) {
+        return state == Occupancy::bound or state == Occupancy::misbound;
+    };
+    paired_domains += paired(cd_i.state()) - paired(old_state);
+    bound_domains += (cd_i.state() == Occupancy::bound) -
+                     (old_state == Occupancy::bound);
+
+    StapleStats& stats {m_staple_stats[cd_i.m_c_ident]};
+    stats.bound_copies += (paired_domains > 0) - was_paired;
+    stats.fully_bound_copies += (bound_domains == num_domains) - was_fully_bound;
 }
 
 void OrigamiSystem::unassign_unbound_domain(Domain& cd_i) {
-    VectorThree pos {cd_i.m_pos};
-    m_pos_to_unbound_d.erase(pos);
-    m_position_occupancies.erase(pos);
-    cd_i.m_state = Occupancy::unassigned;
+    note_domain_change(cd_i);
+    m_occupancies.unassign(cd_i.pos());
+    cd_i.state() = Occupancy::unassigned;
 }
 
 void OrigamiSystem::update_domain(
         Domain& cd_i,
         VectorThree pos,
         VectorThree ore) {
-    cd_i.m_pos = pos;
-    cd_i.m_ore = ore;
+    note_domain_change(cd_i);
+    cd_i.pos() = pos;
+    cd_i.ore() = ore;
 }
 
 void OrigamiSystem::update_occupancies(Domain& cd_i, VectorThree pos) {
@@ -787,19 +1042,21 @@ void OrigamiSystem::update_occupancies(Domain& cd_i, VectorThree pos) {
             new_state = Occupancy::misbound;
         }
 
-        m_pos_to_unbound_d.erase(pos);
-        cd_i.m_state = new_state;
-        cd_j->m_state = new_state;
-        m_position_occupancies[pos] = new_state;
-        cd_j->m_bound_domain = &cd_i;
-        cd_i.m_bound_domain = cd_j;
+        note_domain_change(*cd_j);
+        cd_i.state() = new_state;
+        cd_j->state() = new_state;
+        m_occupancies.set_bound(pos, new_state);
+        cd_j->bound_domain() = &cd_i;
+        cd_i.bound_domain() = cd_j;
+        update_pair_thermo(cd_i, *cd_j, 1);
+        update_staple_stats(cd_i, Occupancy::unassigned);
+        update_staple_stats(*cd_j, Occupancy::unbound);
         break;
     }
     case Occupancy::unassigned:
         new_state = Occupancy::unbound;
-        cd_i.m_state = new_state;
-        m_position_occupancies[pos] = new_state;
-        m_pos_to_unbound_d[pos] = &cd_i;
+        cd_i.state() = new_state;
+        m_occupancies.set_unbound(pos, &cd_i);
         break;
     default:
         cout << "Trying to bind to an already bound domain\n";
@@ -814,7 +1071,11 @@ void OrigamiSystem::update_energy() {
             unassign_domain(*domain);
         }
     }
+
+    // Pair sums were removed with the new tables, so start them over too
     m_energy = 0;
+    m_pair_enthalpy = 0;
+    m_pair_entropy = 0;
 
     // This is only corrected for when removing and adding chains
     if (m_apply_mean_field_cor) {
@@ -827,49 +1088,48 @@ void OrigamiSystem::update_energy() {
     set_all_domains();
 }
 
-DeltaConfig OrigamiSystem::internal_check_domain_constraints(
+TrialResult OrigamiSystem::internal_evaluate_trial(
         Domain& cd_i,
         VectorThree pos,
-        VectorThree ore) {
-    // Updates positions and orientations and returns without reverting if no
-    // constraint violation. But states left unassigned.
-    Occupancy occupancy {position_occupancy(pos)};
-    DeltaConfig delta_config {};
-
+        VectorThree ore,
+        Occupancy occupancy,
+        Domain* unbound_domain) {
+    TrialResult trial {};
     switch (occupancy) {
     case Occupancy::bound:
-        m_constraints_violated = true;
-        m_num_unassigned_domains++;
-        break;
     case Occupancy::misbound:
-        m_constraints_violated = true;
-        m_num_unassigned_domains++;
+        trial.constraints_violated = true;
         break;
-    case Occupancy::unbound:
-        update_domain(cd_i, pos, ore);
-        update_occupancies(cd_i, pos);
-        delta_config = m_pot.bind_domain(cd_i);
-        m_constraints_violated = m_pot.m_constraints_violated;
+    case Occupancy::unbound: {
+        Domain& cd_j {*unbound_domain};
+        if (m_pot.check_domains_complementary(cd_i, cd_j)) {
+            trial.state = Occupancy::bound;
+        }
+        else {
+            trial.state = Occupancy::misbound;
+        }
+        DeltaConfig delta_config {m_pot.evaluate_binding(
+                cd_i, pos, ore, cd_j, trial.constraints_violated)};
+        trial.e = delta_config.e;
+        trial.stacked_pairs = delta_config.stacked_pairs;
         break;
+    }
     case Occupancy::unassigned:
-        update_domain(cd_i, pos, ore);
-        update_occupancies(cd_i, pos);
+        trial.state = Occupancy::unbound;
     }
 
     // Mean field entropy correction for first scaffold domains
-    if (m_apply_mean_field_cor and not m_constraints_violated) {
-        Occupancy new_occupancy {cd_i.m_state};
-        if (new_occupancy == Occupancy::bound) {
-            if (m_num_fully_bound_domain_pairs == 1) {
-                delta_config.e += 2 * log(6);
-            }
-            else if (m_num_fully_bound_domain_pairs == 2) {
-                delta_config.e += log(3);
-            }
+    if (m_apply_mean_field_cor and not trial.constraints_violated and
+        trial.state == Occupancy::bound) {
+        if (m_num_fully_bound_domain_pairs == 0) {
+            trial.e += 2 * log(6);
+        }
+        else if (m_num_fully_bound_domain_pairs == 1) {
+            trial.e += log(3);
         }
     }
 
-    return delta_config;
+    return trial;
 }
 
 OrigamiSystemWithBias::OrigamiSystemWithBias(
@@ -891,35 +1151,18 @@ OrigamiSystemWithBias::OrigamiSystemWithBias(
                 staple_M,
                 params) {}
 
-double OrigamiSystemWithBias::check_domain_constraints(
+void OrigamiSystemWithBias::check_trial_bias(
         Domain& cd_i,
         VectorThree pos,
-        VectorThree ore) {
-
-    double delta_e {OrigamiSystem::check_domain_constraints(cd_i, pos, ore)};
-
-    // Determine what state would be if bound
-    Occupancy state;
-    Occupancy pos_state {position_occupancy(pos)};
-    if (pos_state == Occupancy::unassigned) {
-        state = Occupancy::unbound;
-    }
-    else if (pos_state == Occupancy::unbound) {
-        if (m_pot.check_domains_complementary(*unbound_domain_at(pos), cd_i)) {
-            state = Occupancy::bound;
-        }
-        else {
-            state = Occupancy::misbound;
-        }
-    }
-    else {
-        state = Occupancy::unassigned;
-    }
-
-    m_ops->check_one_domain(cd_i, pos, ore, state);
-    delta_e += m_biases->check_one_domain(cd_i);
+        VectorThree ore,
+        TrialResult& trial) {
+    m_ops->check_one_domain(cd_i, pos, ore, trial.state);
+    trial.e += m_biases->check_one_domain(cd_i);
+}
 
-    return delta_e;
+void OrigamiSystemWithBias::update_restored_domain(Domain& cd_i) {
+    m_ops->update_one_domain(cd_i);
+    m_biases->calc_one_domain(cd_i);
 }
 
 void OrigamiSystemWithBias::delete_chain(int c_i) {
@@ -81,6 +81,9 @@ InputParameters::InputParameters(int argc, char* argv[]) {
             "apply_mean_field_cor",
             po::value<bool>(&m_apply_mean_field_cor)->default_value(false),
             "Apply mean field correction")(
+            "analytic_energies",
+            po::value<bool>(&m_analytic_energies)->default_value(false),
+            "Rescale energies with temperature instead of tabulating them")(
             "min_total_staples",
             po::value<int>(&m_min_total_staples)->default_value(0),
             "Min number of total staples")(
@@ -109,7 +112,7 @@ InputParameters::InputParameters(int argc, char* argv[]) {
             "System bias function multiplier.")(
             "energy_filebase",
             po::value<string>(&m_energy_filebase)->default_value(""),
-            "Filebase for read/write of energies")(
+            "Filebase for read/write of energies, mapped by all processes")(
             "simulation_type",
             po::value<string>(&m_simulation_type)
                     ->default_value("constant_temp"),
@@ -128,12 +131,23 @@ InputParameters::InputParameters(int argc, char* argv[]) {
             "random_seed",
             po::value<int>(&m_random_seed)->default_value(-1),
             "Seed for random number generator")(
+            "random_stream",
+            po::value<int>(&m_random_stream)->default_value(0),
+            "Stream of the seed to draw from, set per replica or window")(
+            "random_engine",
+            po::value<string>(&m_random_engine)->default_value("mt19937_64"),
+            "Random engine: mt19937_64 or xoshiro256pp")(
+            "replica_streams",
+            po::value<bool>(&m_replica_streams)->default_value(false),
+            "Seed replicas and windows with their own streams (always with "
+            "xoshiro256pp)")(
             "movetype_file",
             po::value<string>(&m_movetype_filename),
             "Movetype specificiation file")(
             "num_walks_filename",
             po::value<string>(&m_num_walks_filename)->default_value(""),
-            "Precalculated number of ideal random walks archive")(
+            "Precalculated number of ideal random walks archive, mapped by all "
+            "processes as a table written next to it")(
             "restart_traj_file",
             po::value<string>(&m_restart_traj_file)->default_value(""),
             "Trajectory file to restart from")(
@@ -213,6 +227,16 @@ InputParameters::InputParameters(int argc, char* argv[]) {
             "exchange_interval",
             po::value<int>(&m_exchange_interval)->default_value(0),
             "Steps between exchange attempts")(
+            "exchange_mode",
+            po::value<string>(&m_exchange_mode)->default_value("master"),
+            "Exchange decided on master, pairwise between neighbours, or "
+            "async as replicas become ready")(
+            "replicas_per_rank",
+            po::value<int>(&m_replicas_per_rank)->default_value(1),
+            "Replicas run as threads of each process")(
+            "time_check_swaps",
+            po::value<int>(&m_time_check_swaps)->default_value(10),
+            "Swaps between checks of max_pt_dur in pairwise exchange")(
             "chem_pot_mults",
             po::value<string>(),
             "Factor to multiply base chem pot for each rep")(
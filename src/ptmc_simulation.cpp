@@ -1,14 +1,35 @@
 // ptmc_simulation.cpp
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
+#include <random>
 #include <sstream>
 #include <string>
+#include <thread>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/nonblocking.hpp>
 
 #include "files.h"
 #include "ptmc_simulation.h"
 
 namespace ptmc {
 
+namespace {
+
+// Message tags of the pairwise exchange
+const int c_quantities_tag {1};
+const int c_holders_tag {2};
+const int c_neighbours_tag {3};
+
+// Message tags of the asynchronous exchange
+const int c_offer_tag {4};
+const int c_reply_tag {5};
+const int c_done_tag {6};
+
+} // namespace
+
 using std::cout;
 using std::min;
 using std::pair;
@@ -18,12 +39,94 @@ using std::chrono::steady_clock;
 using files::OrigamiTrajInputFile;
 using origami::Chains;
 
+ReplicaGroup::ReplicaGroup(int size): m_size {size} {}
+
+int ReplicaGroup::size() const { return m_size; }
+
+void ReplicaGroup::gather(
+        mpi::communicator& world,
+        int local_rep,
+        const double* in_values,
+        int n,
+        vector<double>& out_values,
+        int root) {
+
+    {
+        std::lock_guard<std::mutex> lock {m_mutex};
+        m_send_buffer.resize(m_size * n);
+        std::copy(in_values, in_values + n, &m_send_buffer[local_rep * n]);
+    }
+    wait();
+    if (local_rep == 0) {
+        if (world.rank() == root) {
+            mpi::gather(
+                    world, m_send_buffer.data(), m_size * n, out_values, root);
+        }
+        else {
+            mpi::gather(world, m_send_buffer.data(), m_size * n, root);
+        }
+    }
+    wait();
+}
+
+void ReplicaGroup::scatter(
+        mpi::communicator& world,
+        int local_rep,
+        const vector<double>& in_values,
+        double* out_values,
+        int n,
+        int root) {
+
+    if (local_rep == 0) {
+        m_recv_buffer.resize(m_size * n);
+        if (world.rank() == root) {
+            mpi::scatter(
+                    world,
+                    in_values.data(),
+                    m_recv_buffer.data(),
+                    m_size * n,
+                    root);
+        }
+        else {
+            mpi::scatter(world, m_recv_buffer.data(), m_size * n, root);
+        }
+    }
+    wait();
+    std::copy(
+            &m_recv_buffer[local_rep * n],
+            &m_recv_buffer[local_rep * n] + n,
+            out_values);
+    wait();
+}
+
+void ReplicaGroup::wait() {
+    std::unique_lock<std::mutex> lock {m_mutex};
+    long long int generation {m_generation};
+    m_num_arrived++;
+    if (m_num_arrived == m_size) {
+        m_num_arrived = 0;
+        m_generation++;
+        m_released.notify_all();
+    }
+    else {
+        m_released.wait(lock, [&] { return m_generation != generation; });
+    }
+}
+
 PTGCMCSimulation::PTGCMCSimulation(
         OrigamiSystem& origami_system,
         SystemOrderParams& ops,
         SystemBiases& biases,
-        InputParameters& params):
+        InputParameters& params,
+        ReplicaGroup* group,
+        int local_rep):
         GCMCSimulation(origami_system, ops, biases, params),
+        m_env {group == nullptr ? mpi::threading::single
+                                : mpi::threading::serialized},
+        m_group {group},
+        m_local_rep {local_rep},
+        m_rank {m_world.rank() * (group == nullptr ? 1 : group->size()) +
+                local_rep},
         m_num_reps {params.m_num_reps},
         m_swaps {params.m_swaps},
         m_max_pt_dur {params.m_max_pt_dur},
@@ -32,6 +135,57 @@ PTGCMCSimulation::PTGCMCSimulation(
 
     string string_rank {std::to_string(m_rank)};
 
+    // Every process runs the same number of replicas, so a mismatch would
+    // garble the exchanges (checked once per process)
+    if (m_local_rep == 0 and
+        m_num_reps != m_world.size() * params.m_replicas_per_rank) {
+        cout << "Number of replicas must be the number of processes times "
+                "replicas_per_rank\n";
+        throw utility::SimulationMisuse {};
+    }
+
+    // Replicas draw from their own streams of the seed only when asked
+    if (m_params.m_random_seed != -1 and use_replica_streams(m_params)) {
+        m_random_gens.set_seed(m_params.m_random_seed, m_rank);
+    }
+
+    if (params.m_exchange_mode == "pairwise") {
+        m_pairwise = true;
+        m_time_check_swaps = params.m_time_check_swaps;
+        if (m_time_check_swaps < 1) {
+            cout << "Time check interval must be at least one swap\n";
+            throw utility::SimulationMisuse {};
+        }
+    }
+    else if (params.m_exchange_mode == "async") {
+        m_async = true;
+    }
+    else if (params.m_exchange_mode != "master") {
+        cout << "No such exchange mode " << params.m_exchange_mode << "\n";
+        throw utility::SimulationMisuse {};
+    }
+    if (m_group != nullptr and (m_pairwise or m_async)) {
+        cout << "Threaded replicas only support the master exchange mode\n";
+        throw utility::SimulationMisuse {};
+    }
+    if (m_group != nullptr and
+        m_env.thread_level() < mpi::threading::serialized) {
+        cout << "MPI library does not support threaded replicas\n";
+        throw utility::SimulationMisuse {};
+    }
+
+    // Pairwise and async exchange decisions draw from a shared stream
+    if (m_pairwise or m_async) {
+        if (m_params.m_random_seed != -1) {
+            m_exchange_seed = m_params.m_random_seed;
+        }
+        else if (m_rank == m_master_rep) {
+            std::random_device true_random_engine {};
+            m_exchange_seed = true_random_engine();
+        }
+        mpi::broadcast(m_world, m_exchange_seed, m_master_rep);
+    }
+
     // Update starting configs if restarting
     if (m_params.m_restart_traj_filebase != "") {
         string filename {
@@ -93,7 +247,15 @@ void PTGCMCSimulation::initialize_swap_file(InputParameters& params) {
 }
 
 void PTGCMCSimulation::run() {
+    if (m_async) {
+        run_async();
+        return;
+    }
+
     long long int step {0};
+    if (m_pairwise) {
+        initialize_positions();
+    }
 
     auto start = steady_clock::now();
     for (int swap_i {1}; swap_i != m_swaps + 1; swap_i++) {
@@ -106,31 +268,33 @@ void PTGCMCSimulation::run() {
         update_dependent_qs();
         step += m_exchange_interval;
 
-        if (m_rank == m_master_rep) {
-            std::chrono::duration<double> dt {(steady_clock::now() - start)};
-            if (dt.count() > m_max_pt_dur) {
-                master_send_kill(swap_i);
-                cout << "Maximum time allowed reached\n";
-                break;
-            }
-        }
-
-        // Send information from slave nodes to master nodes
-        if (m_rank != m_master_rep) {
-            slave_send(swap_i);
-            if (not slave_receive(swap_i)) {
-                break;
-            }
-        }
-
         // Attempt exchanges between replicas
+        auto exchange_start = steady_clock::now();
+        bool proceed;
+        if (m_pairwise) {
+            proceed = pairwise_exchange(swap_i, step, start);
+        }
         else {
-            write_swap_entry(step);
-            attempt_exchange(swap_i);
+            proceed = master_exchange(swap_i, step, start);
+        }
+        std::chrono::duration<double> exchange_dt {
+                steady_clock::now() - exchange_start};
+        m_num_exchanges++;
+        m_exchange_time += exchange_dt.count();
+        m_max_exchange_time = std::max(m_max_exchange_time, exchange_dt.count());
+        if (not proceed) {
+            break;
         }
     }
 
     // Write end-of-simulation data
+    m_run_time = std::chrono::duration<double> {steady_clock::now() - start}
+                         .count();
+    write_exchange_timing();
+    if (m_pairwise) {
+        gather_positions();
+        combine_exchange_counts();
+    }
     if (m_rank == m_master_rep) {
         write_swap_entry(step);
         write_acceptance_freqs();
@@ -138,8 +302,33 @@ void PTGCMCSimulation::run() {
     }
 }
 
+bool PTGCMCSimulation::master_exchange(
+        int swap_i,
+        long long int step,
+        steady_clock::time_point start) {
+
+    // Collect quantities from all replicas on the master
+    gather_dependent_qs();
+
+    // Attempt exchanges between replicas
+    bool kill {false};
+    if (m_rank == m_master_rep) {
+        std::chrono::duration<double> dt {(steady_clock::now() - start)};
+        if (dt.count() > m_max_pt_dur) {
+            kill = true;
+            cout << "Maximum time allowed reached\n";
+        }
+        else {
+            write_swap_entry(step);
+            attempt_exchange(swap_i);
+        }
+    }
+
+    // Send new quantities (or the kill flag) back to all replicas
+    return scatter_control_qs(kill);
+}
+
 void PTGCMCSimulation::update_dependent_qs() {
-    m_origami_system.update_enthalpy_and_entropy();
     double DH {m_origami_system.hybridization_enthalpy()};
     double D_stacking {m_origami_system.stacking_energy()};
     double bias_e {m_biases.get_total_bias()};
@@ -149,96 +338,542 @@ void PTGCMCSimulation::update_dependent_qs() {
     m_replica_dependent_qs[m_stacking_i] = D_stacking;
 }
 
-void PTGCMCSimulation::slave_send(int swap_i) {
-    for (size_t q_i {0}; q_i != m_replica_dependent_qs.size(); q_i++) {
-        double q {m_replica_dependent_qs[q_i]};
-        m_world.send(m_master_rep, swap_i, q);
+void PTGCMCSimulation::pack_dependent_qs() {
+    m_dependent_buffer.assign(
+            m_replica_dependent_qs.begin(), m_replica_dependent_qs.end());
+    m_dependent_buffer.insert(
+            m_dependent_buffer.end(),
+            m_origami_system.m_staple_us.begin(),
+            m_origami_system.m_staple_us.end());
+    for (size_t staple_ident {1};
+         staple_ident != m_origami_system.m_identities.size();
+         staple_ident++) {
+        m_dependent_buffer.push_back(static_cast<double>(
+                m_origami_system.staple_stats(staple_ident).copies));
     }
-    for (auto staple_u: m_origami_system.m_staple_us) {
-        m_world.send(m_master_rep, swap_i, staple_u);
+}
+
+void PTGCMCSimulation::gather_dependent_qs() {
+    pack_dependent_qs();
+    gather_to_master(
+            m_dependent_buffer.data(),
+            static_cast<int>(m_dependent_buffer.size()),
+            m_gathered_buffer);
+}
+
+void PTGCMCSimulation::gather_to_master(
+        const double* in_values,
+        int n,
+        vector<double>& out_values) {
+
+    if (m_group != nullptr) {
+        m_group->gather(
+                m_world, m_local_rep, in_values, n, out_values, m_master_rep);
     }
-    for (auto staple_n: m_origami_system.get_staple_counts()) {
-        double staple_n_d {static_cast<double>(staple_n)};
-        m_world.send(m_master_rep, swap_i, staple_n_d);
+    else if (m_rank == m_master_rep) {
+        mpi::gather(m_world, in_values, n, out_values, m_master_rep);
+    }
+    else {
+        mpi::gather(m_world, in_values, n, m_master_rep);
     }
 }
 
-bool PTGCMCSimulation::slave_receive(int swap_i) {
-    for (auto i: m_exchange_q_is) {
-        m_world.recv(m_master_rep, swap_i, m_replica_control_qs[i]);
-        if (m_replica_control_qs[i] == 999.0) {
-            return false;
+void PTGCMCSimulation::scatter_from_master(
+        const vector<double>& in_values,
+        double* out_values,
+        int n) {
+
+    if (m_group != nullptr) {
+        m_group->scatter(
+                m_world, m_local_rep, in_values, out_values, n, m_master_rep);
+    }
+    else if (m_rank == m_master_rep) {
+        mpi::scatter(m_world, in_values.data(), out_values, n, m_master_rep);
+    }
+    else {
+        mpi::scatter(m_world, out_values, n, m_master_rep);
+    }
+}
+
+bool PTGCMCSimulation::scatter_control_qs(bool kill) {
+    int block_size {static_cast<int>(m_exchange_q_is.size()) + 1};
+    m_replica_control_buffer.resize(block_size);
+    if (m_rank == m_master_rep) {
+        pack_control_qs();
+        for (int rep_i {0}; rep_i != m_num_reps; rep_i++) {
+            m_control_buffer[rep_i * block_size] = kill ? 1 : 0;
         }
     }
+    scatter_from_master(
+            m_control_buffer, m_replica_control_buffer.data(), block_size);
+
+    if (m_replica_control_buffer[0] != 0) {
+        return false;
+    }
+    for (size_t i {0}; i != m_exchange_q_is.size(); i++) {
+        m_replica_control_qs[m_exchange_q_is[i]] =
+                m_replica_control_buffer[i + 1];
+    }
 
     return true;
 }
 
-void PTGCMCSimulation::master_receive(
-        int swap_i,
+void PTGCMCSimulation::unpack_dependent_qs(
         vector<vector<double>>& dependent_qs,
         vector<vector<vector<double>>>& per_staple_dependent_qs) {
-    master_get_dependent_qs(dependent_qs, per_staple_dependent_qs);
     size_t num_staple_types {m_origami_system.m_identities.size() - 1};
-    for (int rep_i {1}; rep_i != m_num_reps; rep_i++) {
+    size_t block_size {m_dependent_buffer.size()};
+    for (int rep_i {0}; rep_i != m_num_reps; rep_i++) {
+        auto q {m_gathered_buffer.begin() + rep_i * block_size};
         for (size_t i {0}; i != dependent_qs.size(); i++) {
-            double q;
-            m_world.recv(rep_i, swap_i, q);
-            dependent_qs[i].push_back(q);
+            dependent_qs[i].push_back(*q);
+            q++;
         }
         for (size_t i {0}; i != per_staple_dependent_qs.size(); i++) {
-            vector<double> q_per_staple {};
-            for (size_t j {0}; j != num_staple_types; j++) {
-                double q;
-                m_world.recv(rep_i, swap_i, q);
-                q_per_staple.push_back(q);
-            }
-            per_staple_dependent_qs[i].push_back(q_per_staple);
+            per_staple_dependent_qs[i].emplace_back(q, q + num_staple_types);
+            q += num_staple_types;
         }
     }
 }
 
-void PTGCMCSimulation::master_send(int swap_i) {
+void PTGCMCSimulation::pack_control_qs() {
+    size_t block_size {m_exchange_q_is.size() + 1};
+    m_control_buffer.assign(m_num_reps * block_size, 0);
     for (int q_i {0}; q_i != m_num_reps; q_i++) {
         int rep_i {m_q_to_repi[q_i]};
-        if (rep_i == m_master_rep) {
-            for (auto i: m_exchange_q_is) {
-                m_replica_control_qs[i] = m_control_qs[i][q_i];
+        for (size_t i {0}; i != m_exchange_q_is.size(); i++) {
+            m_control_buffer[rep_i * block_size + i + 1] =
+                    m_control_qs[m_exchange_q_is[i]][q_i];
+        }
+    }
+}
+
+void PTGCMCSimulation::initialize_positions() {
+    mpi::broadcast(m_world, m_q_to_repi, m_master_rep);
+    m_position = std::find(m_q_to_repi.begin(), m_q_to_repi.end(), m_rank) -
+                 m_q_to_repi.begin();
+    m_neighbour_positions = neighbour_positions(m_position);
+    m_neighbour_reps.clear();
+    for (auto pos: m_neighbour_positions) {
+        m_neighbour_reps.push_back(pos == -1 ? -1 : m_q_to_repi[pos]);
+    }
+    for (auto i: m_exchange_q_is) {
+        m_replica_control_qs[i] = m_control_qs[i][m_position];
+    }
+}
+
+bool PTGCMCSimulation::pairwise_exchange(
+        int swap_i,
+        long long int step,
+        steady_clock::time_point start) {
+
+    // The time limit is checked on its own schedule, as configs may be
+    // written rarely, and stops every replica once any is over it
+    if (swap_i % m_time_check_swaps == 0) {
+        std::chrono::duration<double> dt {(steady_clock::now() - start)};
+        bool over_time {dt.count() > m_max_pt_dur};
+        bool kill;
+        mpi::all_reduce(m_world, over_time, kill, std::logical_or<bool>());
+        if (kill) {
+            if (m_rank == m_master_rep) {
+                cout << "Maximum time allowed reached\n";
             }
+            return false;
+        }
+    }
+
+    // Writing the swap file needs all replicas
+    if (step % m_config_output_freq == 0) {
+        gather_positions();
+        if (m_rank == m_master_rep) {
+            write_swap_entry(step);
+        }
+    }
+
+    // Swap quantities with the partner and decide on the exchange
+    pack_dependent_qs();
+    int partner_pos {exchange_partner(swap_i, m_position)};
+    int partner_rep {-1};
+    bool accept {false};
+    if (partner_pos != -1) {
+        size_t dir {static_cast<size_t>(
+                std::find(
+                        m_neighbour_positions.begin(),
+                        m_neighbour_positions.end(),
+                        partner_pos) -
+                m_neighbour_positions.begin())};
+        partner_rep = m_neighbour_reps[dir];
+        int buffer_size {static_cast<int>(m_dependent_buffer.size())};
+        m_partner_buffer.resize(buffer_size);
+        mpi::request requests[] {
+                m_world.isend(
+                        partner_rep,
+                        c_quantities_tag,
+                        m_dependent_buffer.data(),
+                        buffer_size),
+                m_world.irecv(
+                        partner_rep,
+                        c_quantities_tag,
+                        m_partner_buffer.data(),
+                        buffer_size)};
+        mpi::wait_all(requests, requests + 2);
+
+        // Both replicas must do the same arithmetic in the same order
+        double p_accept;
+        if (m_position < partner_pos) {
+            p_accept = pair_acceptance_p(
+                    m_position,
+                    partner_pos,
+                    m_dependent_buffer,
+                    m_partner_buffer);
         }
         else {
-            for (auto i: m_exchange_q_is) {
-                m_world.send(rep_i, swap_i, m_control_qs[i][q_i]);
-            }
+            p_accept = pair_acceptance_p(
+                    partner_pos,
+                    m_position,
+                    m_partner_buffer,
+                    m_dependent_buffer);
+        }
+        int pos_1 {std::min(m_position, partner_pos)};
+        int pos_2 {std::max(m_position, partner_pos)};
+        accept = p_accept == 1 or p_accept > shared_uniform(swap_i, pos_1);
+        if (m_position == pos_1) {
+            count_exchange(pos_1, pos_2, accept);
         }
     }
-}
 
-void PTGCMCSimulation::master_send_kill(int swap_i) {
-    for (int q_i {0}; q_i != m_num_reps; q_i++) {
-        int rep_i {m_q_to_repi[q_i]};
-        if (rep_i == m_master_rep) {
+    // Tell the neighbours who now holds this replica's old position
+    int new_holder {accept ? partner_rep : m_rank};
+    m_new_neighbour_reps.assign(m_neighbour_reps.size(), -1);
+    vector<mpi::request> requests {};
+    for (size_t dir {0}; dir != m_neighbour_reps.size(); dir++) {
+        int rep {m_neighbour_reps[dir]};
+        if (rep == -1) {
             continue;
         }
+        requests.push_back(m_world.isend(rep, c_holders_tag, new_holder));
+        requests.push_back(
+                m_world.irecv(rep, c_holders_tag, m_new_neighbour_reps[dir]));
+    }
+    mpi::wait_all(requests.begin(), requests.end());
+
+    // On acceptance take over the partner's position and its neighbours
+    if (not accept) {
+        m_neighbour_reps = m_new_neighbour_reps;
+        return true;
+    }
+    int num_dirs {static_cast<int>(m_new_neighbour_reps.size())};
+    m_partner_neighbour_reps.resize(num_dirs);
+    mpi::request neighbour_requests[] {
+            m_world.isend(
+                    partner_rep,
+                    c_neighbours_tag,
+                    m_new_neighbour_reps.data(),
+                    num_dirs),
+            m_world.irecv(
+                    partner_rep,
+                    c_neighbours_tag,
+                    m_partner_neighbour_reps.data(),
+                    num_dirs)};
+    mpi::wait_all(neighbour_requests, neighbour_requests + 2);
+    m_position = partner_pos;
+    m_neighbour_positions = neighbour_positions(m_position);
+    m_neighbour_reps = m_partner_neighbour_reps;
+    for (auto i: m_exchange_q_is) {
+        m_replica_control_qs[i] = m_control_qs[i][m_position];
+    }
+
+    return true;
+}
+
+double PTGCMCSimulation::pair_acceptance_p(
+        int pos_1,
+        int pos_2,
+        const vector<double>& buffer_1,
+        const vector<double>& buffer_2) {
+
+    vector<pair<double, double>> control_q_pairs {};
+    for (auto& control_q: m_control_qs) {
+        control_q_pairs.push_back({control_q[pos_1], control_q[pos_2]});
+    }
+    vector<pair<double, double>> dependent_q_pairs {};
+    size_t num_qs {m_replica_dependent_qs.size()};
+    for (size_t i {0}; i != num_qs; i++) {
+        dependent_q_pairs.push_back({buffer_1[i], buffer_2[i]});
+    }
+    vector<pair<vector<double>, vector<double>>>
+            per_staple_dependent_q_pairs {};
+    size_t num_staple_types {m_origami_system.m_identities.size() - 1};
+    for (size_t offset {num_qs}; offset != buffer_1.size();
+         offset += num_staple_types) {
+        auto q_1 {buffer_1.begin() + offset};
+        auto q_2 {buffer_2.begin() + offset};
+        per_staple_dependent_q_pairs.push_back(
+                {{q_1, q_1 + num_staple_types},
+                 {q_2, q_2 + num_staple_types}});
+    }
+
+    return calc_acceptance_p(
+            control_q_pairs, dependent_q_pairs, per_staple_dependent_q_pairs);
+}
+
+double PTGCMCSimulation::shared_uniform(int swap_i, int pos) {
+    uint64_t stream {
+            (static_cast<uint64_t>(swap_i) << 32) |
+            static_cast<uint32_t>(pos)};
+    m_exchange_engine.seed(m_exchange_seed, stream);
+
+    // Top 53 bits, as many as a double holds, scaled into [0, 1)
+    return (m_exchange_engine() >> 11) * (1.0 / (1ull << 53));
+}
+
+void PTGCMCSimulation::gather_positions() {
+    if (m_rank == m_master_rep) {
+        vector<int> positions {};
+        mpi::gather(m_world, m_position, positions, m_master_rep);
+        for (int rep {0}; rep != m_num_reps; rep++) {
+            m_q_to_repi[positions[rep]] = rep;
+        }
+    }
+    else {
+        mpi::gather(m_world, m_position, m_master_rep);
+    }
+}
+
+void PTGCMCSimulation::sum_on_master(vector<int>& counts) {
+    int num_counts {static_cast<int>(counts.size())};
+    if (m_rank == m_master_rep) {
+        vector<int> totals(num_counts);
+        mpi::reduce(
+                m_world,
+                counts.data(),
+                num_counts,
+                totals.data(),
+                std::plus<int>(),
+                m_master_rep);
+        counts = totals;
+    }
+    else {
+        mpi::reduce(
+                m_world,
+                counts.data(),
+                num_counts,
+                std::plus<int>(),
+                m_master_rep);
+    }
+}
+
+void PTGCMCSimulation::update_internal(long long int) {
+    if (m_async and m_rank == m_master_rep) {
+        service_offers();
+    }
+}
+
+void PTGCMCSimulation::run_async() {
+    long long int step {0};
+    initialize_positions();
+    if (m_rank == m_master_rep) {
+        m_repi_to_q.resize(m_num_reps);
+        for (int q_i {0}; q_i != m_num_reps; q_i++) {
+            m_repi_to_q[m_q_to_repi[q_i]] = q_i;
+        }
+        m_offer_buffers.resize(m_num_reps);
+        m_offer_swaps.assign(m_num_reps, 0);
+        m_waiting.assign(m_num_reps, false);
+        m_finished.assign(m_num_reps, false);
+
+        // Offers can arrive before the master has packed its own
+        update_dependent_qs();
+        pack_dependent_qs();
+    }
+
+    auto start = steady_clock::now();
+    for (int swap_i {1}; swap_i != m_swaps + 1; swap_i++) {
+        update_control_qs();
+        simulate(m_exchange_interval, step, false, start);
+        update_dependent_qs();
+        step += m_exchange_interval;
+
+        auto exchange_start = steady_clock::now();
+        pack_dependent_qs();
+        bool proceed;
+        if (m_rank == m_master_rep) {
+            write_swap_entry(step);
+            proceed = master_wait_for_exchange(swap_i, start);
+        }
         else {
-            for (size_t i {0}; i != m_exchange_q_is.size(); i++) {
-                double msg {999.0};
-                m_world.send(rep_i, swap_i, msg);
+            proceed = offer_exchange();
+        }
+        std::chrono::duration<double> exchange_dt {
+                steady_clock::now() - exchange_start};
+        m_num_exchanges++;
+        m_exchange_time += exchange_dt.count();
+        m_max_exchange_time = std::max(m_max_exchange_time, exchange_dt.count());
+        if (not proceed) {
+            break;
+        }
+    }
+
+    // The master keeps pairing up the other replicas until they are done
+    if (m_rank == m_master_rep) {
+        finish_async_exchanges();
+    }
+    else if (not m_stopping) {
+        m_world.send(m_master_rep, c_done_tag);
+    }
+
+    // Write end-of-simulation data
+    m_run_time = std::chrono::duration<double> {steady_clock::now() - start}
+                         .count();
+    write_exchange_timing();
+    if (m_rank == m_master_rep) {
+        write_swap_entry(step);
+        write_acceptance_freqs();
+        m_swapfile.close();
+    }
+}
+
+bool PTGCMCSimulation::offer_exchange() {
+    m_world.send(
+            m_master_rep,
+            c_offer_tag,
+            m_dependent_buffer.data(),
+            static_cast<int>(m_dependent_buffer.size()));
+    int block_size {static_cast<int>(m_exchange_q_is.size()) + 1};
+    m_replica_control_buffer.resize(block_size);
+    m_world.recv(
+            m_master_rep,
+            c_reply_tag,
+            m_replica_control_buffer.data(),
+            block_size);
+    if (m_replica_control_buffer[0] != 0) {
+        m_stopping = true;
+        return false;
+    }
+    for (size_t i {0}; i != m_exchange_q_is.size(); i++) {
+        m_replica_control_qs[m_exchange_q_is[i]] =
+                m_replica_control_buffer[i + 1];
+    }
+
+    return true;
+}
+
+bool PTGCMCSimulation::master_wait_for_exchange(
+        int swap_i,
+        steady_clock::time_point start) {
+
+    std::chrono::duration<double> dt {(steady_clock::now() - start)};
+    if (dt.count() > m_max_pt_dur) {
+        m_stopping = true;
+        cout << "Maximum time allowed reached\n";
+        for (int rep {0}; rep != m_num_reps; rep++) {
+            if (rep != m_master_rep and m_waiting[rep]) {
+                release_replica(rep, true);
             }
         }
+
+        return false;
+    }
+
+    m_offer_buffers[m_master_rep] = m_dependent_buffer;
+    m_offer_swaps[m_master_rep] = swap_i;
+    m_waiting[m_master_rep] = true;
+    match_offer(m_master_rep);
+    while (m_waiting[m_master_rep]) {
+        service_offers();
+        std::this_thread::yield();
     }
+
+    return true;
 }
 
-void PTGCMCSimulation::master_get_dependent_qs(
-        vector<vector<double>>& dependent_qs,
-        vector<vector<vector<double>>>& per_staple_dependent_qs) {
-    dependent_qs[m_enthalpy_i].push_back(m_replica_dependent_qs[m_enthalpy_i]);
-    dependent_qs[m_bias_i].push_back(m_replica_dependent_qs[m_bias_i]);
-    dependent_qs[m_stacking_i].push_back(m_replica_dependent_qs[m_stacking_i]);
-    per_staple_dependent_qs[0].push_back(m_origami_system.m_staple_us);
-    vector<int> staple_ns {m_origami_system.get_staple_counts()};
-    vector<double> staple_ns_d {staple_ns.begin(), staple_ns.end()};
-    per_staple_dependent_qs[1].push_back(staple_ns_d);
+void PTGCMCSimulation::finish_async_exchanges() {
+    m_finished[m_master_rep] = true;
+    while (m_num_finished != m_num_reps - 1) {
+        service_offers();
+        std::this_thread::yield();
+    }
+}
+
+void PTGCMCSimulation::service_offers() {
+    while (auto status = m_world.iprobe(mpi::any_source, mpi::any_tag)) {
+        int rep {status->source()};
+        if (status->tag() == c_done_tag) {
+            m_world.recv(rep, c_done_tag);
+            m_finished[rep] = true;
+            m_num_finished++;
+            continue;
+        }
+        m_offer_buffers[rep].resize(m_dependent_buffer.size());
+        m_world.recv(
+                rep,
+                c_offer_tag,
+                m_offer_buffers[rep].data(),
+                static_cast<int>(m_dependent_buffer.size()));
+        if (m_stopping) {
+            release_replica(rep, true);
+            continue;
+        }
+        m_offer_swaps[rep]++;
+        m_waiting[rep] = true;
+        match_offer(rep);
+    }
+}
+
+void PTGCMCSimulation::match_offer(int rep) {
+    int swap_i {m_offer_swaps[rep]};
+    int pos {m_repi_to_q[rep]};
+    int partner_pos {exchange_partner(swap_i, pos)};
+    if (partner_pos == -1) {
+        release_replica(rep, false);
+        return;
+    }
+
+    // The partner may still be waiting on its previous swap
+    int partner_rep {m_q_to_repi[partner_pos]};
+    if (not m_waiting[partner_rep] or m_offer_swaps[partner_rep] != swap_i) {
+        return;
+    }
+
+    int pos_1 {std::min(pos, partner_pos)};
+    int pos_2 {std::max(pos, partner_pos)};
+    int repi1 {m_q_to_repi[pos_1]};
+    int repi2 {m_q_to_repi[pos_2]};
+    double p_accept {pair_acceptance_p(
+            pos_1, pos_2, m_offer_buffers[repi1], m_offer_buffers[repi2])};
+    bool accept {p_accept == 1 or p_accept > shared_uniform(swap_i, pos_1)};
+    count_exchange(pos_1, pos_2, accept);
+    if (accept) {
+        m_q_to_repi[pos_1] = repi2;
+        m_q_to_repi[pos_2] = repi1;
+        m_repi_to_q[repi1] = pos_2;
+        m_repi_to_q[repi2] = pos_1;
+    }
+    release_replica(repi1, false);
+    release_replica(repi2, false);
+}
+
+void PTGCMCSimulation::release_replica(int rep, bool kill) {
+    m_waiting[rep] = false;
+    int pos {m_repi_to_q[rep]};
+    if (rep == m_master_rep) {
+        for (auto i: m_exchange_q_is) {
+            m_replica_control_qs[i] = m_control_qs[i][pos];
+        }
+
+        return;
+    }
+
+    vector<double> block {kill ? 1.0 : 0.0};
+    for (auto i: m_exchange_q_is) {
+        block.push_back(m_control_qs[i][pos]);
+    }
+    m_world.send(
+            rep, c_reply_tag, block.data(), static_cast<int>(block.size()));
+    if (kill) {
+        m_finished[rep] = true;
+        m_num_finished++;
+    }
 }
 
 bool PTGCMCSimulation::test_acceptance(double p_accept) {
@@ -279,7 +914,7 @@ double PTGCMCSimulation::calc_acceptance_p(
     double stacking1 {dependent_q_pairs[m_stacking_i].first};
     double stacking2 {dependent_q_pairs[m_stacking_i].second};
 
-    size_t num_staple_types {m_origami_system.m_identities.size()};
+    size_t num_staple_types {m_origami_system.m_identities.size() - 1};
     double DBU_DN {0};
     for (size_t i {0}; i != num_staple_types; i++) {
         double N1 {per_staple_dependent_q_pairs[1].first[i]};
@@ -310,12 +945,42 @@ void PTGCMCSimulation::write_swap_entry(long long int step) {
     }
 }
 
+void PTGCMCSimulation::write_exchange_timing() {
+    double mean_time {0};
+    if (m_num_exchanges != 0) {
+        mean_time = m_exchange_time / m_num_exchanges;
+    }
+    std::stringstream timing {};
+    timing << "Replicas: " << m_num_reps << "\n";
+    timing << "Exchanges: " << m_num_exchanges << "\n";
+    timing << "Total exchange time (s): " << m_exchange_time << "\n";
+    timing << "Mean exchange latency (s): " << mean_time << "\n";
+    timing << "Max exchange latency (s): " << m_max_exchange_time << "\n";
+    timing << "Idle fraction: " << m_exchange_time / m_run_time << "\n";
+    timing << "\n";
+    *m_logging_stream << timing.str() << std::flush;
+
+    // Idle time of every replica, to compare exchange modes
+    vector<double> idle_times {};
+    gather_to_master(&m_exchange_time, 1, idle_times);
+    if (m_rank == m_master_rep) {
+        cout << timing.str();
+        cout << "Idle time per replica (s):";
+        for (auto idle_time: idle_times) {
+            cout << " " << idle_time;
+        }
+        cout << "\n\n";
+    }
+}
+
 OneDPTGCMCSimulation::OneDPTGCMCSimulation(
         OrigamiSystem& origami_system,
         SystemOrderParams& ops,
         SystemBiases& biases,
-        InputParameters& params):
-        PTGCMCSimulation(origami_system, ops, biases, params),
+        InputParameters& params,
+        ReplicaGroup* group,
+        int local_rep):
+        PTGCMCSimulation(origami_system, ops, biases, params, group, local_rep),
         m_attempt_count(params.m_temps.size() - 1, 0),
         m_swap_count(params.m_temps.size() - 1, 0) {
 
@@ -325,13 +990,11 @@ OneDPTGCMCSimulation::OneDPTGCMCSimulation(
 // Could probably break this into two methods
 void OneDPTGCMCSimulation::initialize_control_qs(InputParameters& params) {
 
-    // Initialize master variables
-    if (m_rank == m_master_rep) {
-        m_control_qs.push_back(params.m_temps);
-        m_control_qs.push_back(params.m_chem_pot_mults);
-        m_control_qs.push_back(params.m_bias_mults);
-        m_control_qs.push_back(params.m_stacking_mults);
-    }
+    // Pairwise exchange needs these on every replica
+    m_control_qs.push_back(params.m_temps);
+    m_control_qs.push_back(params.m_chem_pot_mults);
+    m_control_qs.push_back(params.m_bias_mults);
+    m_control_qs.push_back(params.m_stacking_mults);
 
     // Initialize quantities of each replica (updating origami happens in run)
     for (int i {0}; i != m_num_reps; i++) {
@@ -351,7 +1014,7 @@ void OneDPTGCMCSimulation::attempt_exchange(int swap_i) {
     // Collect results from all replicas
     vector<vector<double>> dependent_qs {{}, {}, {}, {}};
     vector<vector<vector<double>>> per_staple_dependent_qs {{}, {}};
-    master_receive(swap_i, dependent_qs, per_staple_dependent_qs);
+    unpack_dependent_qs(dependent_qs, per_staple_dependent_qs);
 
     // Iterate through pairs in current set and attempt swap
     int swap_set {swap_i % 2};
@@ -395,9 +1058,34 @@ void OneDPTGCMCSimulation::attempt_exchange(int swap_i) {
             m_q_to_repi[i + 1] = repi1;
         }
     }
+}
+
+int OneDPTGCMCSimulation::exchange_partner(int swap_i, int pos) {
+    int swap_set {swap_i % 2};
+    if (pos >= swap_set and (pos - swap_set) % 2 == 0) {
+        return pos + 1 < m_num_reps ? pos + 1 : -1;
+    }
+    else if (pos > swap_set) {
+        return pos - 1;
+    }
+
+    return -1;
+}
+
+vector<int> OneDPTGCMCSimulation::neighbour_positions(int pos) {
+    return {pos - 1, pos + 1 < m_num_reps ? pos + 1 : -1};
+}
+
+void OneDPTGCMCSimulation::count_exchange(int pos_1, int, bool accepted) {
+    m_attempt_count[pos_1]++;
+    if (accepted) {
+        m_swap_count[pos_1]++;
+    }
+}
 
-    // Send updated temperatures and chem. pots to slaves
-    master_send(swap_i);
+void OneDPTGCMCSimulation::combine_exchange_counts() {
+    sum_on_master(m_attempt_count);
+    sum_on_master(m_swap_count);
 }
 
 void OneDPTGCMCSimulation::write_acceptance_freqs() {
@@ -418,8 +1106,10 @@ TwoDPTGCMCSimulation::TwoDPTGCMCSimulation(
         OrigamiSystem& origami_system,
         SystemOrderParams& ops,
         SystemBiases& biases,
-        InputParameters& params):
-        PTGCMCSimulation(origami_system, ops, biases, params),
+        InputParameters& params,
+        ReplicaGroup* group,
+        int local_rep):
+        PTGCMCSimulation(origami_system, ops, biases, params, group, local_rep),
         m_v1_dim {static_cast<int>(params.m_temps.size())},
         m_v2_dim {static_cast<int>(params.m_stacking_mults.size())},
         m_v1s {params.m_temps},
@@ -458,20 +1148,18 @@ void TwoDPTGCMCSimulation::initialize_control_qs(InputParameters& params) {
         }
     }
 
-    if (m_rank == m_master_rep) {
-        //  Temps
-        m_control_qs.push_back(temps);
+    // Pairwise exchange needs these on every replica
+    //  Temps
+    m_control_qs.push_back(temps);
 
-        // Chemical potentials and volumes
-        m_control_qs.push_back(staple_us);
+    // Chemical potentials and volumes
+    m_control_qs.push_back(staple_us);
 
-        // Biases
-        vector<double> bias_mults(temps.size(), 1);
-        m_control_qs.push_back(bias_mults);
+    // Biases
+    m_control_qs.push_back(vector<double>(temps.size(), 1));
 
-        // Stacks
-        m_control_qs.push_back(stacking_mults);
-    }
+    // Stacks
+    m_control_qs.push_back(stacking_mults);
 
     // Initialize quantities of each replica (updating on origami happens
     // in run)
@@ -479,6 +1167,7 @@ void TwoDPTGCMCSimulation::initialize_control_qs(InputParameters& params) {
     m_replica_control_qs[m_staple_u_mult_i] = staple_us[m_rank];
     m_replica_control_qs[m_bias_i] = bias_mults[m_rank];
     m_replica_control_qs[m_stacking_mult_i] = stacking_mults[m_rank];
+    m_origami_system.precompute_energy_tables(temps, stacking_mults);
 }
 
 void TwoDPTGCMCSimulation::attempt_exchange(int swap_i) {
@@ -486,7 +1175,7 @@ void TwoDPTGCMCSimulation::attempt_exchange(int swap_i) {
     // Collect results from all replicas
     vector<vector<double>> dependent_qs {{}, {}, {}, {}};
     vector<vector<vector<double>>> per_staple_dependent_qs {{}, {}};
-    master_receive(swap_i, dependent_qs, per_staple_dependent_qs);
+    unpack_dependent_qs(dependent_qs, per_staple_dependent_qs);
 
     // Iterate through pairs in current set and attempt swap
     int swap_set {swap_i % 4};
@@ -543,9 +1232,60 @@ void TwoDPTGCMCSimulation::attempt_exchange(int swap_i) {
             }
         }
     }
+}
+
+int TwoDPTGCMCSimulation::exchange_partner(int swap_i, int pos) {
+    int swap_set {swap_i % 4};
+    auto lower_in_pair = [this, swap_set](int pos_1) {
+        int i {pos_1 / m_v2_dim};
+        int j {pos_1 % m_v2_dim};
+        return pos_1 >= 0 and i >= m_i_starts[swap_set] and
+               i < m_i_ends[swap_set] and
+               (i - m_i_starts[swap_set]) % m_i_incrs[swap_set] == 0 and
+               j >= m_j_starts[swap_set] and j < m_j_ends[swap_set] and
+               (j - m_j_starts[swap_set]) % m_j_incrs[swap_set] == 0;
+    };
+    int rep_incr {m_rep_incrs[swap_set]};
+    if (lower_in_pair(pos)) {
+        return pos + rep_incr;
+    }
+    else if (lower_in_pair(pos - rep_incr)) {
+        return pos - rep_incr;
+    }
 
-    // Send updated temperatures and chem. pots to slaves
-    master_send(swap_i);
+    return -1;
+}
+
+vector<int> TwoDPTGCMCSimulation::neighbour_positions(int pos) {
+    int i {pos / m_v2_dim};
+    int j {pos % m_v2_dim};
+
+    return {i > 0 ? pos - m_v2_dim : -1,
+            i < m_v1_dim - 1 ? pos + m_v2_dim : -1,
+            j > 0 ? pos - 1 : -1,
+            j < m_v2_dim - 1 ? pos + 1 : -1};
+}
+
+void TwoDPTGCMCSimulation::count_exchange(
+        int pos_1,
+        int pos_2,
+        bool accepted) {
+    int swap_v {pos_2 - pos_1 == m_v2_dim ? 0 : 1};
+    int i {pos_1 / m_v2_dim};
+    int j {pos_1 % m_v2_dim};
+    m_attempt_count[swap_v][i][j]++;
+    if (accepted) {
+        m_swap_count[swap_v][i][j]++;
+    }
+}
+
+void TwoDPTGCMCSimulation::combine_exchange_counts() {
+    for (int swap_v {0}; swap_v != 2; swap_v++) {
+        for (int i {0}; i != m_v1_dim; i++) {
+            sum_on_master(m_attempt_count[swap_v][i]);
+            sum_on_master(m_swap_count[swap_v][i]);
+        }
+    }
 }
 
 void TwoDPTGCMCSimulation::write_acceptance_freqs() {
@@ -593,48 +1333,61 @@ TPTGCMCSimulation::TPTGCMCSimulation(
         OrigamiSystem& origami_system,
         SystemOrderParams& ops,
         SystemBiases& biases,
-        InputParameters& params):
-        OneDPTGCMCSimulation(origami_system, ops, biases, params) {
+        InputParameters& params,
+        ReplicaGroup* group,
+        int local_rep):
+        OneDPTGCMCSimulation(origami_system, ops, biases, params, group, local_rep) {
 
     m_exchange_q_is.push_back(m_temp_i);
     initialize_swap_file(params);
+    m_origami_system.precompute_energy_tables(params.m_temps);
 }
 
 STPTGCMCSimulation::STPTGCMCSimulation(
         OrigamiSystem& origami_system,
         SystemOrderParams& ops,
         SystemBiases& biases,
-        InputParameters& params):
-        OneDPTGCMCSimulation(origami_system, ops, biases, params) {
+        InputParameters& params,
+        ReplicaGroup* group,
+        int local_rep):
+        OneDPTGCMCSimulation(origami_system, ops, biases, params, group, local_rep) {
 
     m_exchange_q_is.push_back(m_temp_i);
     m_exchange_q_is.push_back(m_stacking_mult_i);
     initialize_swap_file(params);
+    m_origami_system.precompute_energy_tables(
+            params.m_temps, params.m_stacking_mults);
 }
 
 UTPTGCMCSimulation::UTPTGCMCSimulation(
         OrigamiSystem& origami_system,
         SystemOrderParams& ops,
         SystemBiases& biases,
-        InputParameters& params):
-        OneDPTGCMCSimulation(origami_system, ops, biases, params) {
+        InputParameters& params,
+        ReplicaGroup* group,
+        int local_rep):
+        OneDPTGCMCSimulation(origami_system, ops, biases, params, group, local_rep) {
 
     m_exchange_q_is.push_back(m_temp_i);
     m_exchange_q_is.push_back(m_staple_u_mult_i);
     initialize_swap_file(params);
+    m_origami_system.precompute_energy_tables(params.m_temps);
 }
 
 HUTPTGCMCSimulation::HUTPTGCMCSimulation(
         OrigamiSystem& origami_system,
         SystemOrderParams& ops,
         SystemBiases& biases,
-        InputParameters& params):
-        OneDPTGCMCSimulation(origami_system, ops, biases, params) {
+        InputParameters& params,
+        ReplicaGroup* group,
+        int local_rep):
+        OneDPTGCMCSimulation(origami_system, ops, biases, params, group, local_rep) {
 
     m_exchange_q_is.push_back(m_temp_i);
     m_exchange_q_is.push_back(m_staple_u_mult_i);
     m_exchange_q_is.push_back(m_bias_mult_i);
     initialize_swap_file(params);
+    m_origami_system.precompute_energy_tables(params.m_temps);
 }
 
 void TPTGCMCSimulation::update_control_qs() {
@@ -667,4 +1420,60 @@ void STPTGCMCSimulation::update_control_qs() {
     double staple_u_mult {m_replica_control_qs[m_staple_u_mult_i]};
     m_origami_system.update_staple_us(temp, staple_u_mult);
 }
+void run_threaded_pt(InputParameters& params) {
+    int num_local_reps {params.m_replicas_per_rank};
+    ReplicaGroup group {num_local_reps};
+
+    // Replicas are set up in turn, so only calculations that were not
+    // already made by an earlier replica are made
+    vector<OrigamiSystem*> systems {};
+    vector<PTGCMCSimulation*> sims {};
+    for (int local_rep {0}; local_rep != num_local_reps; local_rep++) {
+        OrigamiSystem* origami {origami::setup_origami(params)};
+        SystemOrderParams& ops {origami->get_system_order_params()};
+        SystemBiases& biases {origami->get_system_biases()};
+        PTGCMCSimulation* sim;
+        if (params.m_simulation_type == "t_parallel_tempering") {
+            sim = new TPTGCMCSimulation {
+                    *origami, ops, biases, params, &group, local_rep};
+        }
+        else if (params.m_simulation_type == "ut_parallel_tempering") {
+            sim = new UTPTGCMCSimulation {
+                    *origami, ops, biases, params, &group, local_rep};
+        }
+        else if (params.m_simulation_type == "hut_parallel_tempering") {
+            sim = new HUTPTGCMCSimulation {
+                    *origami, ops, biases, params, &group, local_rep};
+        }
+        else if (params.m_simulation_type == "st_parallel_tempering") {
+            sim = new STPTGCMCSimulation {
+                    *origami, ops, biases, params, &group, local_rep};
+        }
+        else if (params.m_simulation_type == "2d_parallel_tempering") {
+            sim = new TwoDPTGCMCSimulation {
+                    *origami, ops, biases, params, &group, local_rep};
+        }
+        else {
+            cout << "Simulation type does not support threaded replicas\n";
+            throw utility::SimulationMisuse {};
+        }
+        systems.push_back(origami);
+        sims.push_back(sim);
+    }
+
+    vector<std::thread> threads {};
+    for (auto sim: sims) {
+        threads.emplace_back([sim] { sim->run(); });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    // The first replica's MPI environment must be the last one destroyed
+    for (int local_rep {num_local_reps - 1}; local_rep != -1; local_rep--) {
+        delete sims[local_rep];
+        delete systems[local_rep];
+    }
+}
+
 } // namespace ptmc
@@ -2,12 +2,60 @@
 
 #include <iostream>
 #include <random>
+#include <string>
+#include <vector>
 
 #include "random_gens.h"
+#include "utility.h"
 
 namespace randomGen {
 
 using std::cout;
+using std::string;
+using std::vector;
+
+using utility::OrigamiMisuse;
+
+namespace {
+
+uint64_t splitmix64(uint64_t& x) {
+    x += 0x9e3779b97f4a7c15ull;
+    uint64_t z {x};
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+void Xoshiro256pp::seed(uint64_t seed, uint64_t stream) {
+
+    // Mix the stream in first so that nearby seeds and streams give
+    // unrelated states
+    uint64_t x {seed};
+    x ^= splitmix64(stream);
+    for (auto& word: m_state) {
+        word = splitmix64(x);
+    }
+}
+
+ostream& operator<<(ostream& stream, const Xoshiro256pp& engine) {
+    stream << engine.m_state[0];
+    for (size_t i {1}; i != engine.m_state.size(); i++) {
+        stream << " " << engine.m_state[i];
+    }
+
+    return stream;
+}
+
+istream& operator>>(istream& stream, Xoshiro256pp& engine) {
+    for (auto& word: engine.m_state) {
+        stream >> word;
+    }
+
+    return stream;
+}
 
 RandomGens::RandomGens() {
 
@@ -15,36 +63,145 @@ RandomGens::RandomGens() {
     std::random_device true_random_engine {};
     auto seed {true_random_engine()};
     cout << "Truly random seed: " << seed << "\n";
+    m_seed = seed;
     m_random_engine.seed(seed);
 }
 
-RandomGens::~RandomGens() {
-    for (auto const key: m_uniform_int_dists) {
-        delete &m_uniform_int_dists.at(key.first);
+void RandomGens::set_engine(string engine) {
+    if (engine == "mt19937_64") {
+        m_engine = RandomEngine::mt19937_64;
+    }
+    else if (engine == "xoshiro256pp") {
+        m_engine = RandomEngine::xoshiro256pp;
+        m_xoshiro.seed(m_seed, 0);
+    }
+    else {
+        cout << "No such random engine " << engine << "\n";
+        throw OrigamiMisuse {};
     }
 }
 
-void RandomGens::set_seed(int seed) { m_random_engine.seed(seed); }
+void RandomGens::set_seed(int seed, int stream) {
+    m_seed = seed;
+    if (m_engine == RandomEngine::xoshiro256pp) {
+        m_xoshiro.seed(seed, stream);
+    }
+
+    // The first stream is seeded as before streams existed
+    else if (stream == 0) {
+        m_random_engine.seed(seed);
+    }
+    else {
+        std::seed_seq seeds {seed, stream};
+        m_random_engine.seed(seeds);
+    }
+}
 
 double RandomGens::uniform_real() {
+    if (m_engine == RandomEngine::xoshiro256pp) {
+
+        // Top 53 bits, as many as a double holds, scaled into [0, 1)
+        return (m_xoshiro() >> 11) * (1.0 / (1ull << 53));
+    }
+
     return m_uniform_real_dist(m_random_engine);
 }
 
 int RandomGens::uniform_int(int lower, int upper) {
+    uint64_t range {static_cast<uint64_t>(
+            static_cast<int64_t>(upper) - lower + 1)};
+    if (m_engine == RandomEngine::xoshiro256pp) {
+
+        // Lemire's multiply and shift, which only needs a division to
+        // reject the few variates that would bias the result
+        uint64_t m {(m_xoshiro() >> 32) * range};
+        uint64_t low {m & 0xffffffffull};
+        if (low < range) {
+            uint64_t threshold {(0x100000000ull - range) % range};
+            while (low < threshold) {
+                m = (m_xoshiro() >> 32) * range;
+                low = m & 0xffffffffull;
+            }
+        }
 
-    // Check if distribution used previously
-    pair<int, int> key {lower, upper};
-    if (m_uniform_int_dists.find(key) != m_uniform_int_dists.end()) {
-        auto dist {m_uniform_int_dists.at(key)};
-        return dist(m_random_engine);
+        return lower + static_cast<int>(m >> 32);
     }
 
-    // If not, make it and store it
+    // The distribution holds no state, so making one per call is free
+    std::uniform_int_distribution<int> dist {lower, upper};
+
+    return dist(m_random_engine);
+}
+
+void RandomGens::write_state(ostream& stream) const {
+    if (m_engine == RandomEngine::xoshiro256pp) {
+        stream << m_xoshiro;
+    }
+    else {
+        stream << m_random_engine;
+    }
+}
+
+void RandomGens::read_state(istream& stream) {
+    if (m_engine == RandomEngine::xoshiro256pp) {
+        stream >> m_xoshiro;
+    }
     else {
-        auto dist {new std::uniform_int_distribution<int> {lower, upper}};
-        int random_int {(*dist)(m_random_engine)};
-        m_uniform_int_dists.insert({key, *dist});
-        return random_int;
+        stream >> m_random_engine;
     }
 }
+
+AliasSampler::AliasSampler(const vector<double>& weights):
+        m_probs(weights.size(), 1),
+        m_aliases(weights.size()) {
+
+    double total {0};
+    for (auto weight: weights) {
+        total += weight;
+    }
+
+    // Scale so that the mean weight is one, then fill each column that is
+    // short of one with the excess of a column that is over
+    size_t n {weights.size()};
+    vector<double> scaled(n);
+    vector<size_t> small {};
+    vector<size_t> large {};
+    for (size_t i {0}; i != n; i++) {
+        scaled[i] = weights[i] * n / total;
+        m_aliases[i] = i;
+        if (scaled[i] < 1) {
+            small.push_back(i);
+        }
+        else {
+            large.push_back(i);
+        }
+    }
+    while (not small.empty() and not large.empty()) {
+        size_t i {small.back()};
+        small.pop_back();
+        size_t j {large.back()};
+        m_probs[i] = scaled[i];
+        m_aliases[i] = j;
+        scaled[j] -= 1 - scaled[i];
+        if (scaled[j] < 1) {
+            large.pop_back();
+            small.push_back(j);
+        }
+    }
+
+    // Whatever is left over is one up to rounding, so keeps its own outcome
+}
+
+size_t AliasSampler::sample(RandomGens& random_gens) const {
+    double u {random_gens.uniform_real() * m_probs.size()};
+    size_t i {static_cast<size_t>(u)};
+    if (i == m_probs.size()) {
+        i--;
+    }
+    if (u - i < m_probs[i]) {
+        return i;
+    }
+
+    return m_aliases[i];
+}
 } // namespace randomGen
@@ -11,6 +11,24 @@ using utility::all_pairs;
 using utility::Occupancy;
 using utility::pair_to_index;
 
+namespace {
+
+/** Index of the nth (from zero) config in the set */
+int nth_config(const configSetT& cis, int n) {
+    for (int i {0}; i != c_num_configs; i++) {
+        if (cis[i]) {
+            if (n == 0) {
+                return i;
+            }
+            n--;
+        }
+    }
+
+    return -1;
+}
+
+} // namespace
+
 CTRGRegrowthMCMovetype::CTRGRegrowthMCMovetype(
         OrigamiSystem& origami_system,
         RandomGens& random_gens,
@@ -57,11 +75,10 @@ CTRGRegrowthMCMovetype::CTRGRegrowthMCMovetype(
                 max_regrowth),
         m_all_configs {all_pairs<VectorThree>(utility::vectors)},
         m_config_to_i {pair_to_index<VectorThree>(m_all_configs)},
-        m_all_cis(m_all_configs.size()),
         m_max_recoils {max_recoils},
         m_max_c_attempts {max_c_attempts} {
 
-    std::iota(m_all_cis.begin(), m_all_cis.end(), 0);
+    m_all_cis.set();
 }
 
 void CTRGRegrowthMCMovetype::reset_internal() {
@@ -75,6 +92,7 @@ void CTRGRegrowthMCMovetype::reset_internal() {
     m_avail_cis_wq.clear();
     m_c_opens.clear();
     m_erased_endpoints_q.clear();
+    m_num_erased_endpoints_q.clear();
 
     m_delta_e = 0;
     m_weight = 1;
@@ -89,31 +107,28 @@ void CTRGRegrowthMCMovetype::add_external_bias() {
 double CTRGRegrowthMCMovetype::unassign_and_save_domains() {
     double delta_e {0};
     auto domain = m_regrow_ds[0];
-    pair<int, int> key {domain->m_c, domain->m_d};
-    m_prev_pos[key] = domain->m_pos;
-    m_prev_ore[key] = domain->m_ore;
+    m_prev_configs.save(*domain);
     for (size_t i {1}; i != m_regrow_ds.size(); i++) {
         domain = m_regrow_ds[i];
         pair<int, int> key {domain->m_c, domain->m_d};
-        m_prev_pos[key] = domain->m_pos;
-        m_prev_ore[key] = domain->m_ore;
+        m_prev_configs.save(*domain);
         m_modified_domains.push_back(key);
         delta_e += m_origami_system.unassign_domain(*domain);
     }
     m_erased_endpoints_q.clear();
+    m_num_erased_endpoints_q.clear();
     write_config();
 
     return delta_e;
 }
 
 double CTRGRegrowthMCMovetype::unassign_and_save_domains(
-        vector<Domain*> domains) {
+        const vector<Domain*>& domains) {
 
     double delta_e {0};
     for (auto domain: domains) {
         pair<int, int> key {domain->m_c, domain->m_d};
-        m_prev_pos[key] = domain->m_pos;
-        m_prev_ore[key] = domain->m_ore;
+        m_prev_configs.save(*domain);
         m_modified_domains.push_back(key);
         delta_e += m_origami_system.unassign_domain(*domain);
     }
@@ -129,6 +144,7 @@ void CTRGRegrowthMCMovetype::unassign_domains() {
     }
     write_config();
     m_erased_endpoints_q.clear();
+    m_num_erased_endpoints_q.clear();
 }
 
 void CTRGRegrowthMCMovetype::setup_constraints() {
@@ -147,8 +163,7 @@ void CTRGRegrowthMCMovetype::setup_constraints() {
 void CTRGRegrowthMCMovetype::setup_for_calc_new_weights() {
     m_c_attempts_wq = m_c_attempts_q;
     m_avail_cis_wq = m_avail_cis_q;
-    m_old_pos = m_prev_pos;
-    m_old_ore = m_prev_ore;
+    m_old_configs = m_prev_configs;
     m_modified_domains.clear();
 }
 
@@ -157,8 +172,7 @@ void CTRGRegrowthMCMovetype::setup_for_calc_old_weights() {
     m_weight = 1;
     m_c_attempts_wq = m_c_attempts_q;
     m_avail_cis_wq = m_avail_cis_q;
-    m_new_pos = m_prev_pos;
-    m_new_ore = m_prev_ore;
+    m_new_configs = m_prev_configs;
     m_modified_domains.clear();
 }
 
@@ -236,8 +250,7 @@ double CTRGRegrowthMCMovetype::set_config(Domain* d, configT c) {
     pair<int, int> key {d->m_c, d->m_d};
     m_assigned_domains.push_back(key);
     m_constraintpoints.update_endpoints(m_d);
-    auto erased_endpoints = m_constraintpoints.get_erased_endpoints();
-    m_erased_endpoints_q.push_back(erased_endpoints);
+    push_erased_endpoints();
     write_config();
 
     return delta_e;
@@ -251,7 +264,7 @@ void CTRGRegrowthMCMovetype::prepare_for_growth() {
     m_c_attempts = 0;
     if (m_stemd) {
         m_d_max_c_attempts = 1;
-        m_avail_cis = {};
+        m_avail_cis.reset();
         m_ref_d = m_constraintpoints.get_growthpoint(m_d);
     }
     else {
@@ -272,7 +285,7 @@ double CTRGRegrowthMCMovetype::prepare_for_regrowth() {
     if (m_stemd) {
         m_d_max_c_attempts = 1;
         m_c_attempts = 1;
-        m_avail_cis = {};
+        m_avail_cis.reset();
         m_ref_d = m_constraintpoints.get_growthpoint(m_d);
     }
     else {
@@ -285,49 +298,96 @@ double CTRGRegrowthMCMovetype::prepare_for_regrowth() {
     return delta_e;
 }
 
+void CTRGRegrowthMCMovetype::push_erased_endpoints() {
+    const vector<VectorThree>& erased_endpoints {
+            m_constraintpoints.get_erased_endpoints()};
+    m_erased_endpoints_q.insert(
+            m_erased_endpoints_q.end(),
+            erased_endpoints.begin(),
+            erased_endpoints.end());
+    m_num_erased_endpoints_q.push_back(erased_endpoints.size());
+}
+
 void CTRGRegrowthMCMovetype::restore_endpoints() {
     m_constraintpoints.remove_activated_endpoint(m_d);
-    auto erased_endpoints = m_erased_endpoints_q.back();
-    m_erased_endpoints_q.pop_back();
-    for (auto pos: erased_endpoints) {
-        m_constraintpoints.add_active_endpoint(m_d, pos);
+    size_t num_erased {m_num_erased_endpoints_q.back()};
+    m_num_erased_endpoints_q.pop_back();
+    size_t first {m_erased_endpoints_q.size() - num_erased};
+    for (size_t i {first}; i != m_erased_endpoints_q.size(); i++) {
+        m_constraintpoints.add_active_endpoint(m_d, m_erased_endpoints_q[i]);
     }
+    m_erased_endpoints_q.resize(first);
 }
 
 configT CTRGRegrowthMCMovetype::select_trial_config() {
     configT c;
     int ci;
     if (m_stemd) {
-        c = {m_ref_d->m_pos, -m_ref_d->m_ore};
+        c = {m_ref_d->pos(), -m_ref_d->ore()};
     }
     else {
-        ci = m_random_gens.uniform_int(0, m_avail_cis.size() - 1);
-        std::list<int>::iterator it {std::next(m_avail_cis.begin(), ci)};
-        int i {*it}; // TODO check this does what you think
-        m_avail_cis.erase(it);
+        ci = m_random_gens.uniform_int(0, m_avail_cis.count() - 1);
+        int i {nth_config(m_avail_cis, ci)};
+        m_avail_cis.reset(i);
         c = m_all_configs[i];
-        c.first = c.first + m_ref_d->m_pos;
+        c.first = c.first + m_ref_d->pos();
     }
 
     return c;
 }
 
+NeighbourTrial CTRGRegrowthMCMovetype::config_trial(configT c) {
+
+    // Stem domains are set on their growthpoint rather than next to it
+    if (not m_stemd) {
+        long long int version {m_origami_system.config_version()};
+        VectorThree growth_pos {m_ref_d->pos()};
+        if (m_trials_d != m_d or m_trials_version != version or
+            m_trials_pos != growth_pos) {
+            m_origami_system.evaluate_neighbour_trials(
+                    *m_d, growth_pos, m_trials);
+            m_trials_d = m_d;
+            m_trials_pos = growth_pos;
+            m_trials_version = version;
+        }
+        for (auto trial: m_trials) {
+            if (trial.pos != c.first) {
+                continue;
+            }
+
+            // Binding is only possible with the forced orientation
+            if (trial.occupancy == Occupancy::unbound and
+                c.second != trial.ore) {
+                trial.result.constraints_violated = true;
+            }
+            return trial;
+        }
+    }
+
+    NeighbourTrial trial {};
+    trial.pos = c.first;
+    trial.occupancy = m_origami_system.position_occupancy(c.first);
+    trial.unbound_domain = m_origami_system.unbound_domain_at(c.first);
+    trial.ore = c.second;
+    trial.result = m_origami_system.evaluate_trial(*m_d, c.first, c.second);
+
+    return trial;
+}
+
 double CTRGRegrowthMCMovetype::calc_p_config_open(configT c) {
-    double delta_e {
-            m_origami_system.check_domain_constraints(*m_d, c.first, c.second)};
-    if (m_origami_system.m_constraints_violated) {
-        m_origami_system.m_constraints_violated = false;
+    NeighbourTrial trial {config_trial(c)};
+    if (trial.result.constraints_violated) {
         return 0;
     }
+    double delta_e {trial.result.e};
     if (not m_constraintpoints.walks_remain(m_d, c.first)) {
         return 0;
     }
 
     // Consider putting this check into the constraintpoints class
     // It's repeated (except growthpoint check) in the CTCB code
-    Occupancy pos_occ {m_origami_system.position_occupancy(c.first)};
-    if (pos_occ == Occupancy::unbound) {
-        Domain* occ_domain {m_origami_system.unbound_domain_at(c.first)};
+    if (trial.occupancy == Occupancy::unbound) {
+        Domain* occ_domain {trial.unbound_domain};
         bool binding_same_chain {occ_domain->m_c == m_d->m_c};
         bool endpoint {m_constraintpoints.endpoint_reached(m_d, c.first)};
         bool excluded_staple {find(m_excluded_staples.begin(),
@@ -383,9 +443,7 @@ void CTRGRegrowthMCMovetype::calc_weights() {
                     m_origami_system.set_checked_domain_config(
                             *m_d, c.first, c.second);
                     m_constraintpoints.update_endpoints(m_d);
-                    auto erased_endpoints =
-                            m_constraintpoints.get_erased_endpoints();
-                    m_erased_endpoints_q.push_back(erased_endpoints);
+                    push_erased_endpoints();
                     write_config();
                     auto dir = m_dir;
                     auto ref_d = m_ref_d;
@@ -404,13 +462,11 @@ void CTRGRegrowthMCMovetype::calc_weights() {
         m_weight *= avail_cs / m_c_opens[m_di - 1];
 
         // Set to actual config
-        pair<int, int> key {m_d->m_c, m_d->m_d};
-        VectorThree p {m_prev_pos[key]};
-        VectorThree o {m_prev_ore[key]};
+        VectorThree p {m_prev_configs.pos(*m_d)};
+        VectorThree o {m_prev_configs.ore(*m_d)};
         m_origami_system.set_checked_domain_config(*m_d, p, o);
         m_constraintpoints.update_endpoints(m_d);
-        auto erased_endpoints = m_constraintpoints.get_erased_endpoints();
-        m_erased_endpoints_q.push_back(erased_endpoints);
+        push_erased_endpoints();
         write_config();
     }
     m_weight /= m_c_opens[m_di];
@@ -487,9 +543,8 @@ void CTRGRegrowthMCMovetype::calc_old_c_opens() {
         m_d = m_regrow_ds[m_di];
         m_c_attempts_q[m_di] = 1;
 
-        pair<int, int> key {m_d->m_c, m_d->m_d};
-        VectorThree p {m_old_pos[key]};
-        VectorThree o {m_old_ore[key]};
+        VectorThree p {m_old_configs.pos(*m_d)};
+        VectorThree o {m_old_configs.ore(*m_d)};
         configT c {p, o};
         m_stemd = m_constraintpoints.is_stemdomain(m_d);
         m_c_opens[m_di] = calc_p_config_open(c);
@@ -497,17 +552,16 @@ void CTRGRegrowthMCMovetype::calc_old_c_opens() {
 
         // Remove this config from available
         if (m_stemd) {
-            m_avail_cis_q[m_di] = {};
+            m_avail_cis_q[m_di].reset();
         }
         else {
             m_avail_cis_q[m_di] = m_all_cis;
             m_dir = m_constraintpoints.get_dir(m_d);
             m_ref_d = (*m_d + (-m_dir));
-            pair<int, int> refkey {m_ref_d->m_c, m_ref_d->m_d};
-            VectorThree pref {m_old_pos[refkey]};
+            VectorThree pref {m_old_configs.pos(*m_ref_d)};
             c.first = p - pref;
             int ci {m_config_to_i.at(c)};
-            m_avail_cis_q[m_di].remove(ci);
+            m_avail_cis_q[m_di].reset(ci);
         }
     }
 }
@@ -518,9 +572,8 @@ bool CTRGRegrowthMCMovetype::test_rg_acceptance() {
     // std::exp(-m_delta_e) << "\n";
     bool accepted {false};
     if (test_acceptance(ratio)) {
-        m_prev_pos = m_new_pos;
-        m_prev_ore = m_new_ore;
-        reset_origami();
+        m_prev_configs = m_new_configs;
+        replay_prev_configs();
         accepted = true;
     }
     else {
@@ -630,7 +683,7 @@ bool CTRGScaffoldRegrowthMCMovetype::internal_attempt_move() {
     bool accepted {false};
 
     // Select scaffold indices and excluded staples
-    m_sel_scaf_doms = select_indices(m_scaffold, 2);
+    select_indices(m_scaffold, m_sel_scaf_doms, 2);
     m_tracker.num_scaffold_domains = m_sel_scaf_doms.size();
     sel_excluded_staples();
 
@@ -792,18 +845,14 @@ bool CTRGJumpScaffoldRegrowthMCMovetype::internal_attempt_move() {
     bool accepted {false};
 
     // Select scaffold segments and excluded staples
-    vector<vector<Domain*>> segs {};
-    vector<vector<vector<Domain*>>> paired_segs {};
-    vector<Domain*> seg_stems {};
-    vector<int> dirs {};
-    select_noncontig_segs(m_scaffold, segs, paired_segs, seg_stems, dirs);
+    select_noncontig_segs(m_scaffold);
     m_tracker.num_scaffold_domains = 0;
     sel_excluded_staples();
     m_constraintpoints.calculate_constraintpoints(
-            segs, dirs, m_excluded_staples);
-    m_constraintpoints.remove_active_endpoint(segs[0][0]);
-    for (auto stem_d: seg_stems) {
-        Domain* growthpoint {stem_d->m_bound_domain};
+            m_segs, m_seg_dirs, m_excluded_staples);
+    m_constraintpoints.remove_active_endpoint(m_segs[0][0]);
+    for (auto stem_d: m_seg_stems) {
+        Domain* growthpoint {stem_d->bound_domain()};
         m_constraintpoints.add_growthpoint(growthpoint, stem_d);
     }
     m_regrow_ds = m_constraintpoints.domains_to_be_regrown();
@@ -830,18 +879,18 @@ bool CTRGJumpScaffoldRegrowthMCMovetype::internal_attempt_move() {
     setup_for_calc_new_weights();
     unassign_and_save_domains();
     m_constraintpoints.reset_active_endpoints();
-    m_constraintpoints.remove_active_endpoint(segs[0][0]);
+    m_constraintpoints.remove_active_endpoint(m_segs[0][0]);
     calc_weights();
 
     // Calculate old weights
     unassign_domains();
     m_constraintpoints.reset_active_endpoints();
-    m_constraintpoints.remove_active_endpoint(segs[0][0]);
+    m_constraintpoints.remove_active_endpoint(m_segs[0][0]);
     calc_old_c_opens();
     setup_for_calc_old_weights();
     unassign_and_save_domains();
     m_constraintpoints.reset_active_endpoints();
-    m_constraintpoints.remove_active_endpoint(segs[0][0]);
+    m_constraintpoints.remove_active_endpoint(m_segs[0][0]);
     calc_weights();
 
     // Test acceptance
@@ -152,6 +152,10 @@ vector<OrigamiOutputFile*> setup_output_files(
     return outs;
 }
 
+bool use_replica_streams(const InputParameters& params) {
+    return params.m_replica_streams or params.m_random_engine == "xoshiro256pp";
+}
+
 void setup_config_files(
         const string filebase,
         const int max_total_staples,
@@ -202,9 +206,12 @@ GCMCSimulation::GCMCSimulation(
     m_vmd_pipe_freq = params.m_vmd_pipe_freq;
     m_max_duration = params.m_max_duration;
 
-    // This only makes sense for serial debugging
+    m_random_gens.set_engine(m_params.m_random_engine);
+
+    // Umbrella sampling windows may have been given their own streams
     if (m_params.m_random_seed != -1) {
-        m_random_gens.set_seed(m_params.m_random_seed);
+        m_random_gens.set_seed(
+                m_params.m_random_seed, m_params.m_random_stream);
         cout << "Using specified seed: " << m_params.m_random_seed << "\n";
     }
     else if (not m_params.m_rand_engine_state_file.empty()) {
@@ -214,7 +221,7 @@ GCMCSimulation::GCMCSimulation(
         std::istringstream rand_engine_state {
                 rand_engine_state_file.read_state(m_params.m_restart_step)};
         rand_engine_state.setf(std::ios::dec);
-        rand_engine_state >> m_random_gens.m_random_engine;
+        m_random_gens.read_state(rand_engine_state);
     }
 
     if (m_vmd_pipe_freq != 0) {
@@ -235,18 +242,12 @@ GCMCSimulation::GCMCSimulation(
     // Constructor movetypes
     construct_movetypes(params);
 
-    // Create cumulative probability array
-    double cum_prob {0};
-    for (size_t i {0}; i != m_movetypes.size(); i++) {
-        cum_prob += m_movetype_freqs[i];
-        m_cumulative_probs.push_back(cum_prob);
-    }
+    // Movetypes are drawn from an alias table of their frequencies
+    m_movetype_sampler = AliasSampler {m_movetype_freqs};
 
     // Load precalculated ideal random walk count data
     if (params.m_num_walks_filename.size() != 0) {
-        std::ifstream num_walks_file {params.m_num_walks_filename};
-        boost::archive::binary_iarchive num_walks_arch {num_walks_file};
-        num_walks_arch >> m_ideal_random_walks;
+        m_ideal_random_walks.load_shared(params.m_num_walks_filename);
     }
 }
 
@@ -641,15 +642,7 @@ long long int GCMCSimulation::simulate(
 }
 
 MCMovetype& GCMCSimulation::select_movetype() {
-    double prob {m_random_gens.uniform_real()};
-    size_t i;
-    for (i = 0; i != m_cumulative_probs.size(); i++) {
-        if (prob < m_cumulative_probs[i]) {
-            break;
-        }
-    }
-
-    return *m_movetypes[i];
+    return *m_movetypes[m_movetype_sampler.sample(m_random_gens)];
 }
 
 void GCMCSimulation::write_log_entry(
@@ -675,8 +668,11 @@ void GCMCSimulation::write_log_entry(
     *m_logging_stream << "Stacked junction quadruplets: "
                       << m_origami_system.num_stacked_junct_quads() << "\n";
     *m_logging_stream << "Staple counts: ";
-    for (auto staple_count: m_origami_system.get_staple_counts()) {
-        *m_logging_stream << staple_count << " ";
+    for (size_t staple_ident {1};
+         staple_ident != m_origami_system.m_identities.size();
+         staple_ident++) {
+        *m_logging_stream << m_origami_system.staple_stats(staple_ident).copies
+                          << " ";
     }
     *m_logging_stream << "\n";
     *m_logging_stream << "System energy: " << m_origami_system.energy() << "\n";
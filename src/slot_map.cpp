@@ -0,0 +1,102 @@
+// slot_map.cpp
+
+#include <algorithm>
+#include <iostream>
+
+#include "slot_map.h"
+#include "utility.h"
+
+namespace slotMap {
+
+using std::cout;
+
+using utility::OrigamiMisuse;
+
+int SlotMap::insert() {
+    int handle;
+    if (m_free_handles.empty()) {
+        handle = m_handle_to_index.size();
+        m_handle_to_index.push_back(-1);
+    }
+    else {
+        handle = m_free_handles.back();
+        m_free_handles.pop_back();
+    }
+    m_handle_to_index[handle] = m_index_to_handle.size();
+    m_index_to_handle.push_back(handle);
+
+    return handle;
+}
+
+void SlotMap::insert(int handle) {
+    if (contains(handle) or handle < 0) {
+        cout << "Handle " << handle << " is not available\n";
+        throw OrigamiMisuse {};
+    }
+
+    // Handles skipped over become free; only setup claims specific handles,
+    // so the linear search of the free list is not on a hot path
+    int num_handles {static_cast<int>(m_handle_to_index.size())};
+    if (handle >= num_handles) {
+        m_handle_to_index.resize(handle + 1, -1);
+        for (int h {handle - 1}; h >= num_handles; h--) {
+            m_free_handles.push_back(h);
+        }
+    }
+    else {
+        m_free_handles.erase(std::find(
+                m_free_handles.begin(), m_free_handles.end(), handle));
+    }
+    m_handle_to_index[handle] = m_index_to_handle.size();
+    m_index_to_handle.push_back(handle);
+}
+
+int SlotMap::erase(int handle) {
+    if (not contains(handle)) {
+        cout << "Handle " << handle << " is not in use\n";
+        throw OrigamiMisuse {};
+    }
+    int index {m_handle_to_index[handle]};
+    int last_handle {m_index_to_handle.back()};
+    m_index_to_handle[index] = last_handle;
+    m_handle_to_index[last_handle] = index;
+    m_index_to_handle.pop_back();
+    m_handle_to_index[handle] = -1;
+    m_free_handles.push_back(handle);
+
+    return index;
+}
+
+bool SlotMap::contains(int handle) const {
+    return handle >= 0 and
+           handle < static_cast<int>(m_handle_to_index.size()) and
+           m_handle_to_index[handle] != -1;
+}
+
+int SlotMap::index(int handle) const {
+    if (not contains(handle)) {
+        throw utility::NoElement {};
+    }
+
+    return m_handle_to_index[handle];
+}
+
+int SlotMap::handle(int index) const { return m_index_to_handle[index]; }
+
+int SlotMap::size() const { return m_index_to_handle.size(); }
+
+const vector<int>& SlotMap::handles() const { return m_index_to_handle; }
+
+vector<int> SlotMap::ordered_handles() const {
+    vector<int> handles {};
+    handles.reserve(m_index_to_handle.size());
+    for (size_t handle {0}; handle != m_handle_to_index.size(); handle++) {
+        if (m_handle_to_index[handle] != -1) {
+            handles.push_back(handle);
+        }
+    }
+
+    return handles;
+}
+
+} // namespace slotMap
@@ -1,5 +1,6 @@
 // top_constraint_points.cpp
 
+#include <algorithm>
 #include <cmath>
 
 #include "top_constraint_points.h"
@@ -12,15 +13,15 @@ using std::find;
 using std::fmin;
 using std::set;
 
-bool domain_included(vector<Domain*> domains, Domain* d) {
+bool domain_included(const vector<Domain*>& domains, Domain* d) {
     return find(domains.begin(), domains.end(), d) != domains.end();
 }
 
-bool chain_included(vector<int> staples, int staple) {
+bool chain_included(const vector<int>& staples, int staple) {
     return find(staples.begin(), staples.end(), staple) != staples.end();
 }
 
-bool chain_included(set<int> staples, int staple) {
+bool chain_included(const set<int>& staples, int staple) {
     return staples.find(staple) != staples.end();
 }
 
@@ -30,7 +31,8 @@ void StapleNetwork::set_excluded_staples(vector<int> excluded_staples) {
     m_ex_staples = excluded_staples;
 }
 
-void StapleNetwork::set_scaffold_domains(vector<Domain*> scaffold_domains) {
+void StapleNetwork::set_scaffold_domains(
+        const vector<Domain*>& scaffold_domains) {
     m_scaffold_ds = scaffold_domains;
 }
 
@@ -38,31 +40,32 @@ void StapleNetwork::scan_network(Domain* d) {
     clear_network();
 
     // Adding the scaffold chain made checks easier
-    m_net_cs.insert(m_origami.c_scaffold);
+    m_net_cs.push_back(m_origami.c_scaffold);
 
     // Start recursive scan of network
     scan_staple_topology(d);
 }
 
-set<int> StapleNetwork::get_participating_chains() { return m_net_cs; }
+const vector<int>& StapleNetwork::get_participating_chains() const {
+    return m_net_cs;
+}
 
-vector<pair<Domain*, Domain*>> StapleNetwork::get_potential_growthpoints() {
+const vector<pair<Domain*, Domain*>>& StapleNetwork::
+        get_potential_growthpoints() const {
     return m_pot_gps;
 }
 
-vector<pair<Domain*, Domain*>> StapleNetwork::
-        get_potential_inactive_endpoints() {
+const vector<pair<Domain*, Domain*>>& StapleNetwork::
+        get_potential_inactive_endpoints() const {
     return m_pot_iaes;
 }
 
-vector<Domain*> StapleNetwork::get_potential_domain_stack() { return m_pot_ds; }
-
-unordered_map<Domain*, int> StapleNetwork::get_staple_to_segs_map() {
-    return m_segs;
+const vector<Domain*>& StapleNetwork::get_potential_domain_stack() const {
+    return m_pot_ds;
 }
 
-unordered_map<pair<int, int>, int> StapleNetwork::get_dirs() {
-    return m_domain_to_dir;
+const DomainMap<int>& StapleNetwork::get_staple_to_segs_map() const {
+    return m_segs;
 }
 
 bool StapleNetwork::externally_bound() { return m_external; }
@@ -79,12 +82,23 @@ void StapleNetwork::clear_network() {
 void StapleNetwork::scan_staple_topology(Domain* growth_d) {
 
     int ci {growth_d->m_c}; // Staple chain index
-    m_net_cs.insert(ci);
+    if (not chain_included(m_net_cs, ci)) {
+        m_net_cs.push_back(ci);
+    }
     m_pot_ds.push_back(growth_d);
-    auto ds {make_staple_stack(growth_d, ci)}; // Domains to check
-    for (auto d: ds) {
+
+    // Domains to check, in a stack for this level of the scan that keeps
+    // its storage between moves
+    size_t depth {m_scan_depth};
+    m_scan_depth++;
+    if (m_staple_stacks.size() == depth) {
+        m_staple_stacks.emplace_back();
+    }
+    make_staple_stack(growth_d, ci, m_staple_stacks[depth]);
+    for (size_t i {0}; i != m_staple_stacks[depth].size(); i++) {
+        Domain* d {m_staple_stacks[depth][i]};
         m_pot_ds.push_back(d);
-        Domain* bd {d->m_bound_domain}; // Domain bound to current
+        Domain* bd {d->bound_domain()}; // Domain bound to current
         bool domain_bound {bd != nullptr};
 
         // Skip if not bound or bound to self
@@ -131,17 +145,20 @@ void StapleNetwork::scan_staple_topology(Domain* growth_d) {
             scan_staple_topology(bd);
         }
     }
+    m_scan_depth--;
 }
 
-vector<Domain*> StapleNetwork::make_staple_stack(Domain* d, int ci) {
-    vector<Domain*> ds {};
-    vector<Domain*> staple {m_origami.get_chain(ci)};
+void StapleNetwork::make_staple_stack(
+        Domain* d,
+        int ci,
+        vector<Domain*>& ds) {
+
+    ds.clear();
+    const vector<Domain*>& staple {m_origami.get_chain(ci)};
 
     // Iterate through domains in three prime direction
     int seg {0};
     m_segs[d] = seg;
-    pair<int, int> key {ci, seg};
-    m_domain_to_dir[key] = 1;
     for (size_t di = d->m_d + 1; di != staple.size(); di++) {
         Domain* d_loop {staple[di]};
         ds.push_back(d_loop);
@@ -150,15 +167,11 @@ vector<Domain*> StapleNetwork::make_staple_stack(Domain* d, int ci) {
 
     // Add domains in five prime direction
     seg++;
-    key = {ci, seg};
-    m_domain_to_dir[key] = -1;
     for (int di {d->m_d - 1}; di != -1; di--) {
         Domain* d_loop {staple[di]};
         ds.push_back(d_loop);
         m_segs[d_loop] = seg;
     }
-
-    return ds;
 }
 
 void StapleNetwork::add_potential_inactive_endpoint(Domain* d, Domain* bd) {
@@ -179,13 +192,11 @@ Constraintpoints::Constraintpoints(
 
 int Constraintpoints::get_dir(Domain* d) {
     auto seg = m_segs[d];
-    pair<int, int> key {d->m_c, seg};
-    int dir {m_domain_to_dir[key]};
 
-    return dir;
+    return seg_dir(d->m_c, seg);
 }
 
-vector<VectorThree> Constraintpoints::get_erased_endpoints() {
+const vector<VectorThree>& Constraintpoints::get_erased_endpoints() const {
     return m_erased_endpoints;
 }
 
@@ -196,48 +207,54 @@ void Constraintpoints::reset_internal() {
     m_erased_endpoints.clear();
     m_d_stack.clear();
     m_segs.clear();
-    m_domain_to_dir.clear();
+    m_scaffold_dirs.clear();
     m_growthpoints.clear();
     m_stemdomains.clear();
-    m_active_endpoints.clear();
-    m_initial_active_endpoints.clear();
+    for (auto& endpoints: m_active_endpoints) {
+        endpoints.second.clear();
+    }
+    for (auto& endpoints: m_initial_active_endpoints) {
+        endpoints.second.clear();
+    }
     m_inactive_endpoints.clear();
     m_stemd_to_segs.clear();
 }
 
 void Constraintpoints::calculate_constraintpoints(
-        vector<Domain*> scaffold_domains,
+        const vector<Domain*>& scaffold_domains,
         int dir,
-        vector<int> excluded_staples) {
+        const vector<int>& excluded_staples) {
 
     m_scaffold_domains = scaffold_domains;
     m_staple_network.set_scaffold_domains(m_scaffold_domains);
     m_staple_network.set_excluded_staples(excluded_staples);
-    pair<int, int> key {scaffold_domains[0]->m_c, 0};
-    m_domain_to_dir[key] = dir;
+    m_scaffold_dirs.assign(1, dir);
     find_growthpoints_endpoints(scaffold_domains, excluded_staples, 0);
 
     // Save initial active endpoints and remaining steps for regrowing old
-    m_initial_active_endpoints = m_active_endpoints;
+    copy_endpoints(m_active_endpoints, m_initial_active_endpoints);
 }
 
 void Constraintpoints::calculate_constraintpoints(
-        vector<vector<Domain*>> scaffold_segments,
-        vector<int> dirs,
-        vector<int> excluded_staples) {
-
-    for (auto segment: scaffold_segments) {
+        const vector<vector<Domain*>>& scaffold_segments,
+        const vector<int>& dirs,
+        const vector<int>& excluded_staples) {
+
+    // Segments past the last direction are spare storage of the caller
+    size_t num_segs {dirs.size()};
+    for (size_t i {0}; i != num_segs; i++) {
+        const vector<Domain*>& segment {scaffold_segments[i]};
         m_scaffold_domains.insert(
                 m_scaffold_domains.end(), segment.begin(), segment.end());
     }
     m_staple_network.set_scaffold_domains(m_scaffold_domains);
     m_staple_network.set_excluded_staples(excluded_staples);
     int seg {0};
-    for (size_t i {0}; i != scaffold_segments.size(); i++) {
-        auto scaffold_domains = scaffold_segments[i];
+    for (size_t i {0}; i != num_segs; i++) {
+        const vector<Domain*>& scaffold_domains {scaffold_segments[i]};
         if (scaffold_domains.size() != 0) {
-            pair<int, int> key {scaffold_domains[0]->m_c, seg};
-            m_domain_to_dir[key] = dirs[i];
+            m_scaffold_dirs.resize(seg + 1, 0);
+            m_scaffold_dirs[seg] = dirs[i];
             find_growthpoints_endpoints(
                     scaffold_domains, excluded_staples, seg);
         }
@@ -245,14 +262,21 @@ void Constraintpoints::calculate_constraintpoints(
     }
 
     // Save initial active endpionts and remaining steps for regrowing old
-    m_initial_active_endpoints = m_active_endpoints;
+    copy_endpoints(m_active_endpoints, m_initial_active_endpoints);
 }
 
 set<int> Constraintpoints::staples_to_be_regrown() {
-    return m_regrowth_staples;
+    return {m_regrowth_staples.begin(), m_regrowth_staples.end()};
+}
+
+void Constraintpoints::staples_to_be_regrown(vector<int>& staples) const {
+    staples.assign(m_regrowth_staples.begin(), m_regrowth_staples.end());
+    std::sort(staples.begin(), staples.end());
 }
 
-vector<Domain*> Constraintpoints::domains_to_be_regrown() { return m_d_stack; }
+const vector<Domain*>& Constraintpoints::domains_to_be_regrown() const {
+    return m_d_stack;
+}
 
 bool Constraintpoints::is_growthpoint(Domain* domain) {
     return (m_growthpoints.count(domain) > 0);
@@ -288,13 +312,15 @@ void Constraintpoints::add_growthpoint(Domain* growthpoint, Domain* stemd) {
     m_stemdomains[stemd] = growthpoint;
 }
 
-void Constraintpoints::add_stem_seg_pair(Domain* stemd, vector<int> seg_pair) {
+void Constraintpoints::add_stem_seg_pair(
+        Domain* stemd,
+        pair<int, int> seg_pair) {
 
     m_stemd_to_segs[stemd] = seg_pair;
 }
 
 void Constraintpoints::reset_active_endpoints() {
-    m_active_endpoints = m_initial_active_endpoints;
+    copy_endpoints(m_initial_active_endpoints, m_active_endpoints);
 }
 
 void Constraintpoints::remove_active_endpoint(Domain* domain) {
@@ -304,20 +330,20 @@ void Constraintpoints::remove_active_endpoint(Domain* domain) {
     int c_i {domain->m_c};
     auto seg = m_segs.at(domain);
     pair<int, int> key {c_i, seg};
-    vector<int> endpoints_to_erase {};
-    for (size_t j {0}; j != m_active_endpoints[key].size(); j++) {
-        pair<int, VectorThree> endpoint {m_active_endpoints[key][j]};
+    vector<pair<int, VectorThree>>& endpoints {m_active_endpoints[key]};
+    for (auto endpoint: endpoints) {
         if (endpoint.first == domain->m_d) {
-            endpoints_to_erase.push_back(j);
             m_erased_endpoints.push_back(endpoint.second);
         }
     }
-
-    // Removing in reverse means the indices are not changing as I do it
-    std::reverse(endpoints_to_erase.begin(), endpoints_to_erase.end());
-    for (auto j: endpoints_to_erase) {
-        m_active_endpoints[key].erase(m_active_endpoints[key].begin() + j);
-    }
+    endpoints.erase(
+            std::remove_if(
+                    endpoints.begin(),
+                    endpoints.end(),
+                    [domain](const pair<int, VectorThree>& endpoint) {
+                        return endpoint.first == domain->m_d;
+                    }),
+            endpoints.end());
 }
 
 void Constraintpoints::remove_activated_endpoint(Domain* domain) {
@@ -345,7 +371,7 @@ void Constraintpoints::update_endpoints(Domain* domain) {
     bool endpoint_present {m_inactive_endpoints.count(domain) > 0};
     if (endpoint_present) {
         Domain* endpoint_domain {m_inactive_endpoints[domain]};
-        add_active_endpoint(endpoint_domain, domain->m_pos);
+        add_active_endpoint(endpoint_domain, domain->pos());
     }
 }
 
@@ -401,17 +427,20 @@ bool Constraintpoints::walks_remain(
         VectorThree pos,
         int offset) {
 
-    vector<int> segs {};
-    bool w_remain {true};
-    if (is_stemdomain(domain)) {
-        segs = m_stemd_to_segs[domain];
+    // Stem domains may start several segments
+    if (not is_stemdomain(domain)) {
+        pair<int, int> key {domain->m_c, m_segs.at(domain)};
+        int dir {seg_dir(key.first, key.second)};
+        return walks_remain(key, domain, pos, dir, offset);
     }
-    else {
-        segs = {m_segs.at(domain)};
+    bool w_remain {true};
+    if (not m_stemd_to_segs.contains(domain)) {
+        return w_remain;
     }
-    for (auto seg: segs) {
+    pair<int, int> seg_pair {m_stemd_to_segs.at(domain)};
+    for (auto seg: {seg_pair.first, seg_pair.second}) {
         pair<int, int> key {domain->m_c, seg};
-        int dir {m_domain_to_dir[key]};
+        int dir {seg_dir(key.first, key.second)};
         w_remain = walks_remain(key, domain, pos, dir, offset);
         if (not w_remain) {
             break;
@@ -454,8 +483,8 @@ Domain* Constraintpoints::get_inactive_endpoints(Domain* domain) {
 }
 
 void Constraintpoints::find_growthpoints_endpoints(
-        vector<Domain*> scaffold_domains,
-        vector<int> excluded_staples,
+        const vector<Domain*>& scaffold_domains,
+        const vector<int>& excluded_staples,
         int seg) {
 
     for (auto d: scaffold_domains) {
@@ -463,44 +492,48 @@ void Constraintpoints::find_growthpoints_endpoints(
         m_segs[d] = seg;
 
         // Skip if not bound, bound to self or already checked
-        bool bound {d->m_bound_domain != nullptr};
+        bool bound {d->bound_domain() != nullptr};
         if (not bound or bound_to_self(d) or
-            chain_included(m_checked_staples, d->m_bound_domain->m_c)) {
+            chain_included(m_checked_staples, d->bound_domain()->m_c)) {
             continue;
         }
 
-        Domain* bd {d->m_bound_domain};
+        Domain* bd {d->bound_domain()};
         m_staple_network.scan_network(bd);
-        auto net_cs = m_staple_network.get_participating_chains();
-        auto pot_gps = m_staple_network.get_potential_growthpoints();
-        pot_gps.push_back({d, bd});
-        auto pot_iaes = m_staple_network.get_potential_inactive_endpoints();
-        auto pot_ds = m_staple_network.get_potential_domain_stack();
-        auto s_seg_map = m_staple_network.get_staple_to_segs_map();
-        auto domain_to_dirs = m_staple_network.get_dirs();
+        const vector<int>& net_cs {
+                m_staple_network.get_participating_chains()};
+        m_pot_gps = m_staple_network.get_potential_growthpoints();
+        m_pot_gps.push_back({d, bd});
+        const vector<pair<Domain*, Domain*>>& pot_iaes {
+                m_staple_network.get_potential_inactive_endpoints()};
+        const vector<Domain*>& pot_ds {
+                m_staple_network.get_potential_domain_stack()};
+        const DomainMap<int>& s_seg_map {
+                m_staple_network.get_staple_to_segs_map()};
         if (m_staple_network.externally_bound()) {
-            add_active_endpoints_on_scaffold(pot_gps, pot_iaes, seg);
+            add_active_endpoints_on_scaffold(m_pot_gps, pot_iaes, seg);
         }
         else {
-            add_growthpoints(pot_gps);
+            add_growthpoints(m_pot_gps);
             add_inactive_endpoints(pot_iaes);
             add_regrowth_staples(net_cs, excluded_staples);
             add_domains_to_stack(pot_ds);
-            add_staple_to_segs_maps(s_seg_map);
-            add_dirs(domain_to_dirs);
+            add_staple_to_segs_maps(pot_ds, s_seg_map);
         }
         for (auto ci: net_cs) {
-            m_checked_staples.insert(ci);
+            if (not chain_included(m_checked_staples, ci)) {
+                m_checked_staples.push_back(ci);
+            }
         }
     }
 }
 
 bool Constraintpoints::bound_to_self(Domain* d) {
-    return d->m_bound_domain->m_c == d->m_c;
+    return d->bound_domain()->m_c == d->m_c;
 }
 
 void Constraintpoints::add_growthpoints(
-        vector<pair<Domain*, Domain*>> potential_growthpoints) {
+        const vector<pair<Domain*, Domain*>>& potential_growthpoints) {
 
     for (auto growthpoint: potential_growthpoints) {
         m_growthpoints[growthpoint.first] = growthpoint.second;
@@ -509,7 +542,7 @@ void Constraintpoints::add_growthpoints(
 }
 
 void Constraintpoints::add_inactive_endpoints(
-        vector<pair<Domain*, Domain*>> pot_iaes) {
+        const vector<pair<Domain*, Domain*>>& pot_iaes) {
 
     for (auto pot_iae: pot_iaes) {
         m_inactive_endpoints[pot_iae.first] = pot_iae.second;
@@ -517,21 +550,23 @@ void Constraintpoints::add_inactive_endpoints(
 }
 
 void Constraintpoints::add_regrowth_staples(
-        set<int> participating_chains,
-        vector<int> ex_staples) {
+        const vector<int>& participating_chains,
+        const vector<int>& ex_staples) {
 
     for (auto c_i: participating_chains) {
         if (c_i == 0) {
             continue;
         }
         bool staple_excluded {chain_included(ex_staples, c_i)};
-        if (not staple_excluded) {
-            m_regrowth_staples.insert(c_i);
+        if (not staple_excluded and
+            not chain_included(m_regrowth_staples, c_i)) {
+            m_regrowth_staples.push_back(c_i);
         }
     }
 }
 
-void Constraintpoints::add_domains_to_stack(vector<Domain*> potential_d_stack) {
+void Constraintpoints::add_domains_to_stack(
+        const vector<Domain*>& potential_d_stack) {
 
     m_d_stack.insert(
             m_d_stack.end(),
@@ -540,34 +575,60 @@ void Constraintpoints::add_domains_to_stack(vector<Domain*> potential_d_stack) {
 }
 
 void Constraintpoints::add_active_endpoints_on_scaffold(
-        vector<pair<Domain*, Domain*>> pot_growthpoints,
-        vector<pair<Domain*, Domain*>> pot_inactive_endpoints,
+        const vector<pair<Domain*, Domain*>>& pot_growthpoints,
+        const vector<pair<Domain*, Domain*>>& pot_inactive_endpoints,
         int seg) {
 
     // Extract those from potential growthpoints
     for (auto growth_pair: pot_growthpoints) {
         Domain* growth_domain {growth_pair.first};
         if (growth_domain->m_c == 0) {
-            add_active_endpoint(growth_domain, growth_domain->m_pos, seg);
+            add_active_endpoint(growth_domain, growth_domain->pos(), seg);
         }
     }
 
     // Extract those from inactive endpoints
     for (auto pot_iae: pot_inactive_endpoints) {
         if (pot_iae.second->m_c == m_origami_system.c_scaffold) {
-            add_active_endpoint(pot_iae.first, pot_iae.second->m_pos, seg);
+            add_active_endpoint(pot_iae.first, pot_iae.second->pos(), seg);
         }
     }
 }
 
 void Constraintpoints::add_staple_to_segs_maps(
-        unordered_map<Domain*, int> s_seg_map) {
+        const vector<Domain*>& staple_domains,
+        const DomainMap<int>& s_seg_map) {
+
+    // Existing entries are kept
+    for (auto d: staple_domains) {
+        if (not m_segs.contains(d)) {
+            m_segs[d] = s_seg_map.at(d);
+        }
+    }
+}
+
+int Constraintpoints::seg_dir(int c_i, int seg) const {
+    if (c_i != m_origami_system.c_scaffold) {
+        return (seg == 0) ? 1 : -1;
+    }
+    if (static_cast<size_t>(seg) >= m_scaffold_dirs.size()) {
+        return 0;
+    }
 
-    m_segs.insert(s_seg_map.begin(), s_seg_map.end());
+    return m_scaffold_dirs[seg];
 }
 
-void Constraintpoints::add_dirs(unordered_map<pair<int, int>, int> dirs) {
-    m_domain_to_dir.insert(dirs.begin(), dirs.end());
+void Constraintpoints::copy_endpoints(
+        const unordered_map<pair<int, int>, vector<pair<int, VectorThree>>>&
+                from,
+        unordered_map<pair<int, int>, vector<pair<int, VectorThree>>>& to) {
+
+    for (auto& endpoints: to) {
+        endpoints.second.clear();
+    }
+    for (auto& endpoints: from) {
+        to[endpoints.first] = endpoints.second;
+    }
 }
 
 int Constraintpoints::calc_remaining_steps(
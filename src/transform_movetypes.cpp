@@ -170,7 +170,7 @@ set<int> LinkerRegrowthMCMovetype::select_and_setup_segments(
         central_segment.clear();
 
         // Select region to be transformed
-        central_segment = select_indices(m_scaffold, 1);
+        select_indices(m_scaffold, central_segment, 1);
 
         // Select linker regions
         size_t linker1_length {static_cast<size_t>(
@@ -220,7 +220,7 @@ set<int> LinkerRegrowthMCMovetype::setup_fixed_end_biases(
         m_linker_endpoints.push_back(linker_endpoint);
         if (linker_endpoint != nullptr) {
             m_constraintpoints.add_active_endpoint(
-                    linker_endpoint, linker_endpoint->m_pos, seg);
+                    linker_endpoint, linker_endpoint->pos(), seg);
         }
         seg++;
     }
@@ -240,8 +240,8 @@ bool LinkerRegrowthMCMovetype::domains_bound_externally(
 
     bool externally_bound {false};
     for (auto domain: domains) {
-        if (domain->m_state != Occupancy::unbound) {
-            Domain* bound_domain {domain->m_bound_domain};
+        if (domain->state() != Occupancy::unbound) {
+            Domain* bound_domain {domain->bound_domain()};
             if (bound_domain->m_c == m_origami_system.c_scaffold) {
                 continue;
             }
@@ -267,12 +267,12 @@ bool LinkerRegrowthMCMovetype::scan_for_external_scaffold_domain(
     bool externally_bound {false};
     int c_i {domain->m_c};
     participating_chains.insert(c_i);
-    vector<Domain*> staple {m_origami_system.get_chain(c_i)};
+    const vector<Domain*>& staple {m_origami_system.get_chain(c_i)};
     for (auto cur_domain: staple) {
         if (cur_domain == domain) {
             continue;
         }
-        Domain* bound_domain {cur_domain->m_bound_domain};
+        Domain* bound_domain {cur_domain->bound_domain()};
         if (bound_domain != nullptr) {
 
             // Skip if bound to self
@@ -332,9 +332,8 @@ double LinkerRegrowthMCMovetype::transform_segment(
         // Select rotation center (from central scaffold domain positions)
         int center_di {
                 m_random_gens.uniform_int(0, central_segment.size() - 1)};
-        pair<int, int> center_key {central_segment[center_di]->m_c,
-                                   central_segment[center_di]->m_d};
-        VectorThree center {m_prev_pos[center_key]};
+        VectorThree center {
+                m_prev_configs.pos(*central_segment[center_di])};
 
         // Select axis and number of turns
         int axis_i {m_random_gens.uniform_int(0, 2)};
@@ -409,8 +408,8 @@ double LinkerRegrowthMCMovetype::apply_transformation(
     for (size_t di {0}; di != central_domains.size(); di++) {
         Domain* domain {central_domains[di]};
         pair<int, int> key {domain->m_c, domain->m_d};
-        VectorThree pos {m_prev_pos[key]};
-        VectorThree ore {m_prev_ore[key]};
+        VectorThree pos {m_prev_configs.pos(*domain)};
+        VectorThree ore {m_prev_configs.ore(*domain)};
 
         // Rotation
         pos = pos.rotate(center, axis, turns);
@@ -476,9 +475,8 @@ double LinkerRegrowthMCMovetype::revert_transformation(
         // Select rotation center (from central scaffold domain positions)
         int center_di {
                 m_random_gens.uniform_int(0, central_segment.size() - 1)};
-        pair<int, int> center_key {central_domains[center_di]->m_c,
-                                   central_segment[center_di]->m_d};
-        VectorThree center {m_prev_pos[center_key]};
+        VectorThree center {
+                m_prev_configs.pos(*central_segment[center_di])};
 
         // Select axis and number of turns
         int axis_i {m_random_gens.uniform_int(0, 2)};
@@ -507,8 +505,8 @@ double LinkerRegrowthMCMovetype::revert_transformation(
     // Revert to old configuration and save energy change
     for (auto domain: central_domains) {
         pair<int, int> key {domain->m_c, domain->m_d};
-        VectorThree pos {m_old_pos[key]};
-        VectorThree ore {m_old_ore[key]};
+        VectorThree pos {m_old_configs.pos(*domain)};
+        VectorThree ore {m_old_configs.ore(*domain)};
         double delta_e {
                 m_origami_system.set_checked_domain_config(*domain, pos, ore)};
         bias += exp(-delta_e);
@@ -527,12 +525,12 @@ bool LinkerRegrowthMCMovetype::steps_less_than_distance(
     Domain* linker1_endpoint {m_linker_endpoints[0]};
     int dist1 {0};
     if (linker1_endpoint != nullptr) {
-        dist1 = (linker1[0]->m_pos - linker1_endpoint->m_pos).abssum();
+        dist1 = (linker1[0]->pos() - linker1_endpoint->pos()).abssum();
     }
     Domain* linker2_endpoint {m_linker_endpoints[1]};
     int dist2 {0};
     if (linker2_endpoint != nullptr) {
-        dist2 = (linker2[0]->m_pos - linker2_endpoint->m_pos).abssum();
+        dist2 = (linker2[0]->pos() - linker2_endpoint->pos()).abssum();
     }
     if (dist1 <= static_cast<int>(linker1.size()) and
         dist2 <= static_cast<int>(linker2.size())) {
@@ -637,7 +635,7 @@ set<int> ClusteredLinkerRegrowthMCMovetype::select_and_setup_segments(
     Domain* p_domain {*central_segment[0] + -1};
     if (p_domain != central_segment.back() and
         p_domain != (*central_segment.back() + 1)) {
-        while (p_domain != nullptr and p_domain->m_state != Occupancy::bound and
+        while (p_domain != nullptr and p_domain->state() != Occupancy::bound and
                linker1.size() != m_max_linker_length and
                p_domain != (*central_segment.back() + 2)) {
 
@@ -653,7 +651,7 @@ set<int> ClusteredLinkerRegrowthMCMovetype::select_and_setup_segments(
     linker2.push_back(central_segment.back());
     Domain* n_domain {*central_segment.back() + 1};
     if (n_domain != linker1.back()) {
-        while (n_domain != nullptr and n_domain->m_state != Occupancy::bound and
+        while (n_domain != nullptr and n_domain->state() != Occupancy::bound and
                linker2.size() != m_max_linker_length and
                n_domain != (*linker1.back() + -1)) {
 
@@ -675,11 +673,11 @@ vector<Domain*> ClusteredLinkerRegrowthMCMovetype::
     int kernel {m_random_gens.uniform_int(1, m_scaffold.size() - 2)};
     bool segment_started {false};
     Domain* kernel_domain {m_scaffold[kernel]};
-    if (kernel_domain->m_state == Occupancy::bound) {
+    if (kernel_domain->state() == Occupancy::bound) {
         segment_started = true;
         central_segment.push_back(kernel_domain);
         Domain* p_domain {*kernel_domain + -1};
-        while (p_domain != nullptr and p_domain->m_state == Occupancy::bound and
+        while (p_domain != nullptr and p_domain->state() == Occupancy::bound and
                central_segment.size() != m_scaffold.size() - 1) {
             central_segment.push_back(p_domain);
             p_domain = *p_domain + -1;
@@ -692,14 +690,14 @@ vector<Domain*> ClusteredLinkerRegrowthMCMovetype::
     Domain* n_domain {*kernel_domain + 1};
     bool segment_ended {false};
     while (not segment_ended and n_domain != nullptr) {
-        if (n_domain->m_state == Occupancy::bound and not segment_started) {
+        if (n_domain->state() == Occupancy::bound and not segment_started) {
             segment_started = true;
             central_segment.push_back(n_domain);
         }
-        else if (n_domain->m_state == Occupancy::bound and segment_started) {
+        else if (n_domain->state() == Occupancy::bound and segment_started) {
             central_segment.push_back(n_domain);
         }
-        else if (n_domain->m_state != Occupancy::bound and segment_started) {
+        else if (n_domain->state() != Occupancy::bound and segment_started) {
 
             segment_ended = true;
         }
@@ -708,16 +706,16 @@ vector<Domain*> ClusteredLinkerRegrowthMCMovetype::
     n_domain = *kernel_domain + -1;
     if (not segment_started) {
         while (not segment_ended and n_domain != nullptr) {
-            if (n_domain->m_state == Occupancy::bound and not segment_started) {
+            if (n_domain->state() == Occupancy::bound and not segment_started) {
                 segment_started = true;
                 central_segment.push_back(n_domain);
             }
             else if (
-                    n_domain->m_state == Occupancy::bound and segment_started) {
+                    n_domain->state() == Occupancy::bound and segment_started) {
                 central_segment.push_back(n_domain);
             }
             else if (
-                    n_domain->m_state != Occupancy::bound and segment_started) {
+                    n_domain->state() != Occupancy::bound and segment_started) {
 
                 segment_ended = true;
             }
@@ -739,11 +737,11 @@ vector<Domain*> ClusteredLinkerRegrowthMCMovetype::
     int kernel {m_random_gens.uniform_int(1, m_scaffold.size() - 2)};
     bool segment_started {false};
     Domain* kernel_domain {m_scaffold[kernel]};
-    if (kernel_domain->m_state == Occupancy::bound) {
+    if (kernel_domain->state() == Occupancy::bound) {
         segment_started = true;
         central_segment.push_back(kernel_domain);
         Domain* p_domain {*kernel_domain + -1};
-        while (p_domain->m_state == Occupancy::bound and
+        while (p_domain->state() == Occupancy::bound and
                central_segment.size() != m_scaffold.size() - 1) {
             central_segment.push_back(p_domain);
             p_domain = *p_domain + -1;
@@ -756,14 +754,14 @@ vector<Domain*> ClusteredLinkerRegrowthMCMovetype::
     Domain* n_domain {*kernel_domain + 1};
     bool segment_ended {false};
     while (not segment_ended and n_domain != kernel_domain) {
-        if (n_domain->m_state == Occupancy::bound and not segment_started) {
+        if (n_domain->state() == Occupancy::bound and not segment_started) {
             segment_started = true;
             central_segment.push_back(n_domain);
         }
-        else if (n_domain->m_state == Occupancy::bound) {
+        else if (n_domain->state() == Occupancy::bound) {
             central_segment.push_back(n_domain);
         }
-        else if (n_domain->m_state != Occupancy::bound and segment_started) {
+        else if (n_domain->state() != Occupancy::bound and segment_started) {
 
             segment_ended = true;
         }
@@ -869,7 +867,8 @@ bool CTCBLinkerRegrowthMCMovetype::internal_attempt_move() {
     set<int> central_staples {find_staples(central_segment)};
     vector<Domain*> central_domains {central_segment};
     for (auto staple: central_staples) {
-        vector<Domain*> staple_domains {m_origami_system.get_chain(staple)};
+        const vector<Domain*>& staple_domains {
+                m_origami_system.get_chain(staple)};
         for (auto domain: staple_domains) {
             central_domains.push_back(domain);
         }
@@ -1145,7 +1144,8 @@ bool CTRGLinkerRegrowthMCMovetype::internal_attempt_move() {
     set<int> central_staples {find_staples(central_segment)};
     vector<Domain*> central_domains {central_segment};
     for (auto staple: central_staples) {
-        vector<Domain*> staple_domains {m_origami_system.get_chain(staple)};
+        const vector<Domain*>& staple_domains {
+                m_origami_system.get_chain(staple)};
         for (auto domain: staple_domains) {
             central_domains.push_back(domain);
         }
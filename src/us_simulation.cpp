@@ -507,6 +507,11 @@ void MWUSGCMCSimulation::setup_window_sims(OrigamiSystem& origami) {
         m_params.m_restart_step = m_params.m_restart_steps[m_rank];
     }
 
+    // Windows draw from their own streams of the seed only when asked
+    if (use_replica_streams(m_params)) {
+        m_params.m_random_stream = m_rank;
+    }
+
     // Create simulation objects
     m_us_sim = new SimpleUSGCMCSimulation {origami, m_ops, m_biases, m_params};
     m_us_stream = new ofstream {output_filebase + ".out"};
@@ -6,6 +6,12 @@
 #include <sstream>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "utility.h"
 
 namespace utility {
@@ -265,6 +271,46 @@ vector<string> split(const string& s, char delim) {
     return elems;
 }
 
+std::shared_ptr<const char> map_file(const string& filename, size_t& file_size) {
+    file_size = 0;
+    int fd {open(filename.c_str(), O_RDONLY)};
+    if (fd == -1) {
+        return {};
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 or file_stat.st_size == 0) {
+        close(fd);
+        return {};
+    }
+    size_t size {static_cast<size_t>(file_stat.st_size)};
+    void* mapped {mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)};
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return {};
+    }
+    file_size = size;
+
+    return std::shared_ptr<const char> {
+            static_cast<const char*>(mapped), [size](const char* data) {
+                munmap(const_cast<char*>(data), size);
+            }};
+}
+
+FileLock::FileLock(const string& filename):
+        m_fd {open(filename.c_str(), O_RDWR | O_CREAT, 0644)} {
+
+    if (m_fd != -1) {
+        flock(m_fd, LOCK_EX);
+    }
+}
+
+FileLock::~FileLock() {
+    if (m_fd != -1) {
+        flock(m_fd, LOCK_UN);
+        close(m_fd);
+    }
+}
+
 Fraction::Fraction(string unparsed_fraction) {
     string delimiter {"/"};
     auto delim_pos {unparsed_fraction.find(delimiter)};
@@ -0,0 +1,47 @@
+// test_alias_sampler.cpp
+
+#include <catch.hpp>
+
+#include <vector>
+
+#include "random_gens.h"
+
+using std::vector;
+
+using namespace randomGen;
+
+SCENARIO("Alias sampler draws outcomes in proportion to their weights") {
+    double eps {0.01};
+    RandomGens random_gens {};
+
+    GIVEN("Unnormalized weights, one of them zero") {
+        vector<double> weights {2, 0, 1, 6, 1};
+        AliasSampler sampler {weights};
+
+        // Estimate distribution from sampler
+        vector<double> calc_dist(weights.size(), 0);
+        int num_iters {100000};
+        for (int i {0}; i != num_iters; i++) {
+            calc_dist[sampler.sample(random_gens)] += 1. / num_iters;
+        }
+
+        THEN("Distributions match (within 1%)") {
+            REQUIRE(calc_dist[1] == 0);
+            for (size_t i {0}; i != weights.size(); i++) {
+                double exp_p {weights[i] / 10};
+                REQUIRE(calc_dist[i] > exp_p - eps);
+                REQUIRE(calc_dist[i] < exp_p + eps);
+            }
+        }
+    }
+
+    GIVEN("A single outcome") {
+        AliasSampler sampler {vector<double> {3}};
+
+        THEN("It is always drawn") {
+            for (int i {0}; i != 100; i++) {
+                REQUIRE(sampler.sample(random_gens) == 0);
+            }
+        }
+    }
+}
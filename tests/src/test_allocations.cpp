@@ -0,0 +1,133 @@
+// test_allocations.cpp
+
+#include <catch.hpp>
+
+#define protected public
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "bias_functions.h"
+#include "constant_temp_simulation.h"
+#include "order_params.h"
+#include "origami_system.h"
+#include "parser.h"
+
+using std::cout;
+
+using namespace constantTemp;
+using namespace origami;
+using namespace parser;
+
+namespace {
+
+// Heap allocations made through operator new since the start of the run
+long int num_allocations {0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    num_allocations++;
+    void* ptr {std::malloc(size)};
+    if (ptr == nullptr) {
+        throw std::bad_alloc {};
+    }
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+// Attempt moves of one movetype as the simulation does, centering the
+// system at the same frequency
+void attempt_moves(
+        ConstantTGCMCSimulation& sim,
+        OrigamiSystem& origami,
+        movetypes::MCMovetype& movetype,
+        InputParameters& params,
+        long long int& step,
+        int attempts) {
+
+    for (int i {0}; i != attempts; i++) {
+        step++;
+        if (not movetype.attempt_move(step)) {
+            movetype.reset_origami();
+            sim.m_ops.update_move_params();
+            sim.m_biases.calc_move();
+        }
+        if (step % params.m_centering_freq == 0) {
+            origami.center(params.m_centering_domain);
+        }
+    }
+}
+
+} // namespace
+
+SCENARIO("MC steps do not allocate once warmed up") {
+    char arg_0[] {"test"};
+    char arg_1[] {"-i"};
+    char arg_2[] {"bench_steps.inp"};
+    char* argv[] {arg_0, arg_1, arg_2};
+    InputParameters params {3, argv};
+    OrigamiSystem* origami {setup_origami(params)};
+    ConstantTGCMCSimulation sim {
+            *origami,
+            origami->get_system_order_params(),
+            origami->get_system_biases(),
+            params};
+
+    // Let the staple count settle and the scratch storage grow first; the
+    // largest moves are rare, so this takes several times the counted steps
+    long long int equil_steps {5 * params.m_ct_steps};
+    long long int steps {params.m_ct_steps};
+    sim.simulate(equil_steps, 0, false);
+    long int start_allocations {num_allocations};
+    sim.simulate(steps, equil_steps, false);
+    long int allocations {num_allocations - start_allocations};
+    cout << "Heap allocations in " << steps << " steps: " << allocations
+         << "\n";
+    cout << "Staples: " << origami->num_staples() << "\n";
+
+    delete origami;
+    REQUIRE(allocations == 0);
+}
+
+SCENARIO("Move attempts do not allocate once warmed up") {
+    char arg_0[] {"test"};
+    char arg_1[] {"-i"};
+    char arg_2[] {"bench_steps.inp"};
+    char* argv[] {arg_0, arg_1, arg_2};
+    InputParameters params {3, argv};
+    OrigamiSystem* origami {setup_origami(params)};
+    ConstantTGCMCSimulation sim {
+            *origami,
+            origami->get_system_order_params(),
+            origami->get_system_biases(),
+            params};
+
+    // Let the staple count settle and the shared storage grow first
+    long long int step {5 * params.m_ct_steps};
+    sim.simulate(step, 0, false);
+
+    // Each movetype warms up its own scratch storage before it is counted
+    int warmup_attempts {5000};
+    int attempts {1000};
+    for (auto& movetype: sim.m_movetypes) {
+        attempt_moves(sim, *origami, *movetype, params, step, warmup_attempts);
+        long int start_allocations {num_allocations};
+        attempt_moves(sim, *origami, *movetype, params, step, attempts);
+        long int allocations {num_allocations - start_allocations};
+        cout << movetype->get_label() << ": " << allocations
+             << " heap allocations in " << attempts << " attempts\n";
+
+        INFO(movetype->get_label());
+        REQUIRE(allocations == 0);
+    }
+
+    delete origami;
+}
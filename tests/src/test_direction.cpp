@@ -0,0 +1,93 @@
+// test_direction.cpp
+
+#include <catch.hpp>
+
+#include <vector>
+
+#include "direction.h"
+#include "domain.h"
+#include "domain_pool.h"
+#include "utility.h"
+
+using std::vector;
+
+using namespace direction;
+using namespace domainContainer;
+using namespace utility;
+
+namespace {
+
+// Unit vectors plus vectors that must encode as none
+vector<VectorThree> test_vectors() {
+    vector<VectorThree> test_vs {vectors};
+    test_vs.push_back({0, 0, 0});
+    test_vs.push_back({1, 1, 0});
+    test_vs.push_back({0, -2, 0});
+
+    return test_vs;
+}
+
+} // namespace
+
+SCENARIO("Direction codes follow the vector algebra") {
+    GIVEN("Every pair of unit and non-unit vectors") {
+        THEN("Codes round trip and rotations match VectorThree") {
+            for (auto v: test_vectors()) {
+                Direction d {encode(v)};
+                if (v.abssum() != 1) {
+                    REQUIRE(d == none);
+                    continue;
+                }
+                REQUIRE(decode(d) == v);
+                REQUIRE(decode(negate(d)) == -v);
+                for (auto axis: test_vectors()) {
+                    Direction a {encode(axis)};
+                    REQUIRE(decode(rotate_half(d, a)) == v.rotate_half(axis));
+                    REQUIRE(decode(rotate_quarter(d, a)) ==
+                            v.rotate(axis, 1));
+                    REQUIRE(decode(rotate_quarter(d, negate(a))) ==
+                            v.rotate(axis, -1));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Domain constraint checks agree with vector comparisons") {
+    for (auto domain_type: {"HalfTurn", "ThreeQuarterTurn"}) {
+        DomainPool domain_pool {domain_type, {{1, 2}}};
+        vector<Domain*> chain {domain_pool.checkout_chain(0, 0)};
+        Domain& cd_1 {*chain[0]};
+        Domain& cd_2 {*chain[1]};
+        bool half_turn {string {domain_type} == "HalfTurn"};
+        for (auto ndr: vectors) {
+            for (auto ore_1: vectors) {
+                for (auto ore_2: vectors) {
+                    cd_1.ore() = ore_1;
+                    cd_2.ore() = ore_2;
+
+                    // Reference rules written on vectors
+                    VectorThree rotated {
+                            half_turn ? ore_1.rotate_half(ndr)
+                                      : ore_1.rotate(ndr, -1)};
+                    bool twist {rotated == ore_2};
+                    bool kink {true};
+                    if (ndr == -ore_1) {
+                        kink = false;
+                    }
+                    else if (ndr == ore_1) {
+                        kink = half_turn ? ore_2 != -ore_1
+                                         : ore_1 != ore_2 and ore_1 != -ore_2;
+                    }
+                    else if (ndr == ore_2 or ndr == -ore_2) {
+                        kink = false;
+                    }
+
+                    Direction code {encode(ndr)};
+                    REQUIRE(cd_1.check_twist_constraint(code, cd_2) == twist);
+                    REQUIRE(cd_1.check_kink_constraint(code, cd_2) == kink);
+                }
+            }
+        }
+    }
+}
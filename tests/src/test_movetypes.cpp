@@ -181,7 +181,7 @@ SCENARIO("Example moves work as expected") {
         // Grow staple 2 domain 1
         vector<pair<VectorThree, VectorThree>> configs {};
         vector<double> bfactors {};
-        VectorThree p_prev {staple2_d_2.m_pos};
+        VectorThree p_prev {staple2_d_2.pos()};
         movetype.calc_biases(staple2_d_1, p_prev, configs, bfactors);
         movetype.calc_bias(bfactors, &staple1_d_1, configs, p_prev, staple2);
         origami.set_domain_config(staple2_d_1, {1, 1, 0}, {0, -1, 0});
@@ -190,7 +190,7 @@ SCENARIO("Example moves work as expected") {
         // Grow staple 3
         configs = {};
         bfactors = {};
-        p_prev = scaffold_d_2.m_pos;
+        p_prev = scaffold_d_2.pos();
         movetype.calc_biases(scaffold_d_3, p_prev, configs, bfactors);
         movetype.calc_bias(bfactors, &scaffold_d_3, configs, p_prev, scaffold_domains);
         origami.set_domain_config(scaffold_d_3, {1, 1, 0}, {0, 1, 0});
@@ -199,7 +199,7 @@ SCENARIO("Example moves work as expected") {
         // Grow staple 4
         configs = {};
         bfactors = {};
-        p_prev = scaffold_d_3.m_pos;
+        p_prev = scaffold_d_3.pos();
         movetype.calc_biases(scaffold_d_4, p_prev, configs, bfactors);
         movetype.calc_bias(bfactors, &scaffold_d_4, configs, p_prev, scaffold_domains);
         origami.set_domain_config(scaffold_d_4, {0, 1, 0}, {0, -1, 0});
@@ -9,7 +9,7 @@
 
 using std::cout;
 
-using namespace NearestNeighbour;
+using namespace nearestNeighbour;
 
 SCENARIO("Longest contiguous complementary sequences are extracted") {
 
@@ -129,11 +129,12 @@ SCENARIO("Computed free energies are compared to hand calculated values") {
         double temp {300};
         double cation_M {0.5};
         string seq {"AT"};
-        /* (((0.2) + (-7.2) + (2 * 2.2)) - 300 * ((-0.0057) + (-0.0014) +
-            (-0.0204) + (2 * 0.0069) + 0.368 * 1 * math.log(0.5) / 1000)) *
+        /* The salt correction counts one phosphate per nucleotide
+            (((0.2) + (-7.2) + (2 * 2.2)) - 300 * ((-0.0057) + (-0.0014) +
+            (-0.0204) + (2 * 0.0069) + 0.368 * 2 * math.log(0.5) / 1000)) *
             4.184 * 1000 / 8.3144598 / 300
         */
-        double energy {2.6612328678696606};
+        double energy {2.7895932252887095};
         THEN("The associated energies match expected") {
             double hybrid_e {calc_unitless_hybridization_energy(seq, temp, cation_M)};
             REQUIRE(Approx(hybrid_e) == energy);
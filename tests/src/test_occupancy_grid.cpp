@@ -0,0 +1,170 @@
+// test_occupancy_grid.cpp
+
+#include <catch.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "domain.h"
+#include "domain_pool.h"
+#include "hash.h"
+#include "occupancy_grid.h"
+#include "utility.h"
+
+using std::cout;
+using std::unordered_map;
+using std::vector;
+using std::chrono::steady_clock;
+
+using namespace domainContainer;
+using namespace occupancyGrid;
+using namespace utility;
+
+namespace {
+
+// Sites visited by a lattice random walk, a compact cloud like an origami
+vector<VectorThree> random_walk_sites(int num_sites, int seed) {
+    std::mt19937_64 engine {static_cast<unsigned long>(seed)};
+    std::uniform_int_distribution<int> dir_dist {0, 5};
+    vector<VectorThree> sites {};
+    VectorThree pos {0, 0, 0};
+    for (int i {0}; i != num_sites; i++) {
+        sites.push_back(pos);
+        pos = pos + vectors[dir_dist(engine)];
+    }
+
+    return sites;
+}
+
+} // namespace
+
+SCENARIO("Occupancy grid tracks lattice site states") {
+    OccupancyGrid grid {};
+    DomainPool domain_pool {"HalfTurn", {{1}, {-1}}};
+    Domain* domain_1 {domain_pool.checkout_chain(0, 0)[0]};
+    Domain* domain_2 {domain_pool.checkout_chain(1, 1)[0]};
+
+    GIVEN("An empty grid") {
+        THEN("Every site is unassigned") {
+            REQUIRE(grid.occupancy({0, 0, 0}) == Occupancy::unassigned);
+            REQUIRE(grid.occupancy({-100, 3, 1000}) == Occupancy::unassigned);
+            REQUIRE(grid.unbound_domain({5, 5, 5}) == nullptr);
+        }
+    }
+
+    GIVEN("Unbound and bound sites on both sides of the origin") {
+        VectorThree pos_1 {-1, -8, 7};
+        VectorThree pos_2 {8, 0, -9};
+        VectorThree pos_3 {-33, 40, 2};
+        grid.set_unbound(pos_1, domain_1);
+        grid.set_bound(pos_2, Occupancy::bound);
+        grid.set_unbound(pos_3, domain_2);
+
+        THEN("States and domains are returned for each site") {
+            REQUIRE(grid.occupancy(pos_1) == Occupancy::unbound);
+            REQUIRE(grid.unbound_domain(pos_1) == domain_1);
+            REQUIRE(grid.occupancy(pos_2) == Occupancy::bound);
+            REQUIRE(grid.unbound_domain(pos_2) == nullptr);
+            REQUIRE(grid.occupancy(pos_3) == Occupancy::unbound);
+            REQUIRE(grid.unbound_domain(pos_3) == domain_2);
+            REQUIRE(grid.occupancy({0, -8, 7}) == Occupancy::unassigned);
+        }
+
+        THEN("A single read gives both the state and the domain") {
+            Occupancy occupancy;
+            Domain* unbound_domain;
+            grid.read_site(pos_1, occupancy, unbound_domain);
+            REQUIRE(occupancy == Occupancy::unbound);
+            REQUIRE(unbound_domain == domain_1);
+            grid.read_site(pos_2, occupancy, unbound_domain);
+            REQUIRE(occupancy == Occupancy::bound);
+            REQUIRE(unbound_domain == nullptr);
+            grid.read_site({500, 0, 0}, occupancy, unbound_domain);
+            REQUIRE(occupancy == Occupancy::unassigned);
+            REQUIRE(unbound_domain == nullptr);
+        }
+
+        WHEN("A site is unassigned") {
+            grid.unassign(pos_1);
+
+            THEN("Only that site is cleared") {
+                REQUIRE(grid.occupancy(pos_1) == Occupancy::unassigned);
+                REQUIRE(grid.unbound_domain(pos_1) == nullptr);
+                REQUIRE(grid.occupancy(pos_3) == Occupancy::unbound);
+            }
+        }
+
+        WHEN("The grid is translated") {
+            VectorThree disp {33, -40, -2};
+            grid.translate(disp);
+
+            THEN("Sites move with the displacement") {
+                REQUIRE(grid.occupancy(pos_3) == Occupancy::unassigned);
+                REQUIRE(grid.occupancy(pos_1 + disp) == Occupancy::unbound);
+                REQUIRE(grid.unbound_domain(pos_1 + disp) == domain_1);
+                REQUIRE(grid.occupancy(pos_2 + disp) == Occupancy::bound);
+                REQUIRE(grid.unbound_domain({0, 0, 0}) == domain_2);
+            }
+        }
+    }
+}
+
+SCENARIO("Occupancy grid site lookup throughput", "[!hide][benchmark]") {
+    vector<VectorThree> sites {random_walk_sites(2000, 0)};
+    DomainPool domain_pool {"HalfTurn", {{1}}};
+    Domain* domain {domain_pool.checkout_chain(0, 0)[0]};
+
+    OccupancyGrid grid {};
+    unordered_map<VectorThree, Occupancy> position_occupancies {};
+    unordered_map<VectorThree, Domain*> pos_to_unbound_d {};
+    for (auto site: sites) {
+        grid.set_unbound(site, domain);
+        position_occupancies[site] = Occupancy::unbound;
+        pos_to_unbound_d[site] = domain;
+    }
+
+    // Query all neighbours of every site, as the CB movetypes do
+    int num_passes {200};
+    long int grid_hits {0};
+    auto start = steady_clock::now();
+    for (int pass {0}; pass != num_passes; pass++) {
+        for (auto site: sites) {
+            for (auto& vec: vectors) {
+                VectorThree pos {site + vec};
+                if (grid.occupancy(pos) == Occupancy::unbound) {
+                    grid_hits += (grid.unbound_domain(pos) != nullptr);
+                }
+            }
+        }
+    }
+    std::chrono::duration<double> grid_dt {steady_clock::now() - start};
+
+    long int map_hits {0};
+    start = steady_clock::now();
+    for (int pass {0}; pass != num_passes; pass++) {
+        for (auto site: sites) {
+            for (auto& vec: vectors) {
+                VectorThree pos {site + vec};
+                Occupancy occ {Occupancy::unassigned};
+                if (position_occupancies.count(pos) != 0) {
+                    occ = position_occupancies.at(pos);
+                }
+                if (occ == Occupancy::unbound) {
+                    map_hits += (pos_to_unbound_d.at(pos) != nullptr);
+                }
+            }
+        }
+    }
+    std::chrono::duration<double> map_dt {steady_clock::now() - start};
+
+    double lookups {static_cast<double>(num_passes * sites.size() * 6)};
+    cout << "Occupancy grid: " << lookups / grid_dt.count() / 1e6
+         << " M lookups/s\n";
+    cout << "Hash maps: " << lookups / map_dt.count() / 1e6
+         << " M lookups/s\n";
+
+    REQUIRE(grid_hits == map_hits);
+}
@@ -0,0 +1,190 @@
+// test_origami_potential.cpp
+
+#include <catch.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "constant_temp_simulation.h"
+#include "domain.h"
+#include "files.h"
+#include "origami_potential.h"
+#include "origami_system.h"
+#include "parser.h"
+#include "utility.h"
+
+using std::cout;
+using std::pair;
+using std::string;
+using std::vector;
+using std::chrono::steady_clock;
+
+using namespace constantTemp;
+using namespace domainContainer;
+using namespace files;
+using namespace origami;
+using namespace parser;
+using namespace potential;
+using namespace utility;
+
+SCENARIO("Temperature updates switch between consistent energy tables") {
+    char arg_0[] {"test"};
+    char arg_1[] {"-i"};
+    char arg_2[] {"bench_steps.inp"};
+    char* argv[] {arg_0, arg_1, arg_2};
+    InputParameters params {3, argv};
+    OrigamiSystem* origami {setup_origami(params)};
+    vector<Domain*> domains {};
+    for (auto& chain: origami->get_chains()) {
+        domains.insert(domains.end(), chain.begin(), chain.end());
+    }
+
+    OrigamiInputFile origami_input {params.m_origami_input_filename};
+    OrigamiPotential tables_pot {
+            origami_input.get_identities(),
+            origami_input.get_sequences(),
+            origami_input.get_enthalpies(),
+            origami_input.get_entropies(),
+            params};
+    params.m_analytic_energies = true;
+    OrigamiPotential analytic_pot {
+            origami_input.get_identities(),
+            origami_input.get_sequences(),
+            origami_input.get_enthalpies(),
+            origami_input.get_entropies(),
+            params};
+    tables_pot.precompute_energy_tables({330, 350}, {1, 0.5});
+
+    // Visit a ladder point, an unlisted temperature, and return to the start
+    double first_init_energy {tables_pot.init_energy()};
+    vector<pair<double, double>> points {{350, 0.5}, {300, 1}, {330, 1}};
+    for (auto point: points) {
+        tables_pot.update_temp(point.first, point.second);
+        analytic_pot.update_temp(point.first, point.second);
+        REQUIRE(analytic_pot.init_energy() == Approx(tables_pot.init_energy()));
+        for (auto cd_i: domains) {
+            for (auto cd_j: domains) {
+                PairEnergies tabled {tables_pot.pair_energies(*cd_i, *cd_j)};
+                PairEnergies analytic {
+                        analytic_pot.pair_energies(*cd_i, *cd_j)};
+                REQUIRE(analytic.hyb_energy == Approx(tabled.hyb_energy));
+                REQUIRE(analytic.stacking_energy ==
+                        Approx(tabled.stacking_energy));
+            }
+        }
+    }
+    REQUIRE(tables_pot.init_energy() == first_init_energy);
+
+    delete origami;
+}
+
+SCENARIO("Trial bindings are evaluated without changing the domains") {
+    char arg_0[] {"test"};
+    char arg_1[] {"-i"};
+    char arg_2[] {"bench_steps.inp"};
+    char* argv[] {arg_0, arg_1, arg_2};
+    InputParameters params {3, argv};
+    params.m_domain_type = "ThreeQuarterTurn";
+    OrigamiSystem* origami {setup_origami(params)};
+    ConstantTGCMCSimulation sim {
+            *origami,
+            origami->get_system_order_params(),
+            origami->get_system_biases(),
+            params};
+    sim.simulate(2000, 0, false);
+
+    OrigamiInputFile origami_input {params.m_origami_input_filename};
+    OrigamiPotential pot {
+            origami_input.get_identities(),
+            origami_input.get_sequences(),
+            origami_input.get_enthalpies(),
+            origami_input.get_entropies(),
+            params};
+    for (auto& chain: origami->get_chains()) {
+        for (auto cd_i: chain) {
+            if (cd_i->state() != Occupancy::bound) {
+                continue;
+            }
+
+            // The current configuration as a trial matches binding in place
+            Domain* cd_j {cd_i->bound_domain()};
+            DeltaConfig bound {pot.bind_domain(*cd_i)};
+            bool violated {true};
+            DeltaConfig trial {pot.evaluate_binding(
+                    *cd_i, cd_i->pos(), cd_i->ore(), *cd_j, violated)};
+            REQUIRE(violated == pot.m_constraints_violated);
+            REQUIRE(trial.e == bound.e);
+            REQUIRE(trial.stacked_pairs == bound.stacked_pairs);
+
+            // Other trial orientations leave both domains as they are
+            VectorThree ore {cd_i->ore()};
+            for (auto& trial_ore: vectors) {
+                pot.evaluate_binding(
+                        *cd_i, cd_i->pos(), trial_ore, *cd_j, violated);
+            }
+            REQUIRE(cd_i->ore() == ore);
+            REQUIRE(cd_i->state() == Occupancy::bound);
+            REQUIRE(cd_i->bound_domain() == cd_j);
+            REQUIRE(cd_j->bound_domain() == cd_i);
+        }
+    }
+
+    delete origami;
+}
+
+SCENARIO("Binding potential throughput", "[!hide][benchmark]") {
+    for (string domain_type: {"HalfTurn", "ThreeQuarterTurn"}) {
+        char arg_0[] {"test"};
+        char arg_1[] {"-i"};
+        char arg_2[] {"bench_steps.inp"};
+        char* argv[] {arg_0, arg_1, arg_2};
+        InputParameters params {3, argv};
+        params.m_domain_type = domain_type;
+
+        // Grow a configuration with bound staples to evaluate
+        OrigamiSystem* origami {setup_origami(params)};
+        ConstantTGCMCSimulation sim {
+                *origami,
+                origami->get_system_order_params(),
+                origami->get_system_biases(),
+                params};
+        sim.simulate(params.m_ct_steps, 0, false);
+        vector<Domain*> bound_domains {};
+        for (auto& chain: origami->get_chains()) {
+            for (auto domain: chain) {
+                if (domain->state() == Occupancy::bound) {
+                    bound_domains.push_back(domain);
+                }
+            }
+        }
+
+        OrigamiInputFile origami_input {params.m_origami_input_filename};
+        OrigamiPotential pot {
+                origami_input.get_identities(),
+                origami_input.get_sequences(),
+                origami_input.get_enthalpies(),
+                origami_input.get_entropies(),
+                params};
+
+        int num_passes {20000};
+        int violations {0};
+        double energy {0};
+        auto start = steady_clock::now();
+        for (int pass {0}; pass != num_passes; pass++) {
+            for (auto domain: bound_domains) {
+                energy += pot.bind_domain(*domain).e;
+                violations += pot.m_constraints_violated;
+            }
+        }
+        std::chrono::duration<double> dt {steady_clock::now() - start};
+        double calls {static_cast<double>(num_passes) * bound_domains.size()};
+        cout << domain_type << ": " << bound_domains.size()
+             << " bound domains, " << dt.count() / calls * 1e9
+             << " ns per bind_domain (energy sum " << energy << ")\n";
+
+        delete origami;
+        REQUIRE(violations == 0);
+    }
+}
@@ -132,7 +132,7 @@ SCENARIO("Distributions are calculated for methods with random variables") {
             }
             else {
                 origami.centre();
-                VectorThree pos {origami.get_domain(1, 1)->m_pos};
+                VectorThree pos {origami.get_domain(1, 1)->pos()};
                 calc_dist[pos]++;
                 accepted_moves++;
             }
@@ -0,0 +1,79 @@
+// test_slot_map.cpp
+
+#include <catch.hpp>
+
+#include <vector>
+
+#include "slot_map.h"
+#include "utility.h"
+
+using std::vector;
+
+using namespace slotMap;
+
+SCENARIO("Slot map keeps handles stable and indices dense") {
+    SlotMap slots {};
+    vector<int> values {};
+    for (int i {0}; i != 4; i++) {
+        int handle {slots.insert()};
+        values.push_back(10 * handle);
+    }
+
+    GIVEN("Four inserted elements") {
+        THEN("Handles are assigned in order") {
+            REQUIRE(slots.size() == 4);
+            REQUIRE(slots.handles() == vector<int>({0, 1, 2, 3}));
+            REQUIRE(slots.index(2) == 2);
+        }
+
+        WHEN("A middle element is erased and mirrored in the values") {
+            int index {slots.erase(1)};
+            values[index] = values.back();
+            values.pop_back();
+
+            THEN("The last element takes its index") {
+                REQUIRE(index == 1);
+                REQUIRE(slots.size() == 3);
+                REQUIRE_FALSE(slots.contains(1));
+                REQUIRE(slots.index(3) == 1);
+                for (auto handle: slots.handles()) {
+                    REQUIRE(values[slots.index(handle)] == 10 * handle);
+                }
+                REQUIRE(slots.ordered_handles() == vector<int>({0, 2, 3}));
+            }
+
+            THEN("The freed handle is reused") {
+                REQUIRE(slots.insert() == 1);
+                REQUIRE(slots.index(1) == 3);
+            }
+        }
+
+        WHEN("The last element is erased") {
+            int index {slots.erase(3)};
+
+            THEN("No other element moves") {
+                REQUIRE(index == 3);
+                REQUIRE(slots.handles() == vector<int>({0, 1, 2}));
+            }
+        }
+
+        THEN("Erasing or looking up a missing handle throws") {
+            REQUIRE_THROWS_AS(slots.erase(7), utility::OrigamiMisuse);
+            REQUIRE_THROWS_AS(slots.index(7), utility::NoElement);
+        }
+    }
+
+    GIVEN("Specific handles claimed past the end") {
+        slots.insert(7);
+
+        THEN("The skipped handles are free and can be claimed") {
+            REQUIRE(slots.index(7) == 4);
+            REQUIRE_FALSE(slots.contains(5));
+            slots.insert(5);
+            REQUIRE(slots.index(5) == 5);
+            REQUIRE(slots.insert() == 4);
+            REQUIRE(slots.insert() == 6);
+            REQUIRE_THROWS_AS(slots.insert(7), utility::OrigamiMisuse);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+// test_xoshiro.cpp
+
+#include <catch.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "parser.h"
+#include "random_gens.h"
+#include "simulation.h"
+
+using std::string;
+using std::vector;
+
+using namespace parser;
+using namespace randomGen;
+using namespace simulation;
+
+namespace {
+
+vector<int> draw_ints(RandomGens& random_gens, int num_draws) {
+    vector<int> draws {};
+    for (int i {0}; i != num_draws; i++) {
+        draws.push_back(random_gens.uniform_int(0, 1000000));
+    }
+
+    return draws;
+}
+
+} // namespace
+
+SCENARIO("Bounded integers from the xoshiro engine are uniform") {
+    double eps {0.01};
+    RandomGens random_gens {};
+    random_gens.set_engine("xoshiro256pp");
+    random_gens.set_seed(7, 3);
+
+    GIVEN("A range that does not divide the engine's range") {
+        int lower {-2};
+        int upper {4};
+        vector<double> calc_dist(upper - lower + 1, 0);
+        int num_iters {100000};
+        for (int i {0}; i != num_iters; i++) {
+            int x {random_gens.uniform_int(lower, upper)};
+            REQUIRE(x >= lower);
+            REQUIRE(x <= upper);
+            calc_dist[x - lower] += 1. / num_iters;
+        }
+
+        THEN("Distributions match (within 1%)") {
+            for (auto calc_p: calc_dist) {
+                REQUIRE(calc_p > 1. / 7 - eps);
+                REQUIRE(calc_p < 1. / 7 + eps);
+            }
+        }
+    }
+
+    GIVEN("A range of one value") {
+        THEN("It is always drawn") {
+            for (int i {0}; i != 100; i++) {
+                REQUIRE(random_gens.uniform_int(5, 5) == 5);
+            }
+        }
+    }
+}
+
+SCENARIO("Streams of a seed are reproducible and distinct") {
+    for (auto engine: {"mt19937_64", "xoshiro256pp"}) {
+        RandomGens random_gens {};
+        random_gens.set_engine(engine);
+
+        GIVEN(string {"The "} + engine + " engine") {
+            random_gens.set_seed(7, 1);
+            vector<int> first_draws {draw_ints(random_gens, 20)};
+
+            THEN("Reseeding the same stream repeats its draws") {
+                random_gens.set_seed(7, 1);
+                REQUIRE(draw_ints(random_gens, 20) == first_draws);
+            }
+
+            THEN("Other streams and seeds give other draws") {
+                random_gens.set_seed(7, 2);
+                REQUIRE(draw_ints(random_gens, 20) != first_draws);
+                random_gens.set_seed(8, 1);
+                REQUIRE(draw_ints(random_gens, 20) != first_draws);
+            }
+        }
+    }
+
+    GIVEN("The first stream of the Mersenne twister") {
+        RandomGens random_gens {};
+        random_gens.set_seed(7);
+
+        THEN("It is seeded as before streams existed") {
+            std::mt19937_64 engine {7};
+            for (int i {0}; i != 20; i++) {
+                std::uniform_int_distribution<int> dist {0, 1000000};
+                REQUIRE(random_gens.uniform_int(0, 1000000) == dist(engine));
+            }
+        }
+    }
+}
+
+SCENARIO("Replicas only take their own streams when asked or with xoshiro") {
+    InputParameters params {};
+    params.m_random_engine = "mt19937_64";
+    params.m_replica_streams = false;
+    REQUIRE_FALSE(use_replica_streams(params));
+    params.m_replica_streams = true;
+    REQUIRE(use_replica_streams(params));
+    params.m_random_engine = "xoshiro256pp";
+    params.m_replica_streams = false;
+    REQUIRE(use_replica_streams(params));
+}